@@ -38,6 +38,7 @@ namespace ewn
 
 			virtual void HandlePeerConnection(bool outgoing, std::size_t peerId, Nz::UInt32 data) = 0;
 			virtual void HandlePeerDisconnection(std::size_t peerId, Nz::UInt32 data) = 0;
+			virtual void HandlePeerMessage(std::size_t peerId, Packets::AnyPacket&& message);
 			virtual void HandlePeerPacket(std::size_t peerId, Nz::NetPacket&& packet) = 0;
 			virtual void OnConfigLoaded(const ConfigFile& config);
 
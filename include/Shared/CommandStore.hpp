@@ -7,10 +7,12 @@
 #ifndef EREWHON_SHARED_COMMANDSTORE_HPP
 #define EREWHON_SHARED_COMMANDSTORE_HPP
 
+#include <Nazara/Core/ByteArray.hpp>
 #include <Nazara/Network/ENetPacket.hpp>
 #include <Nazara/Network/NetPacket.hpp>
 #include <Shared/Protocol/Packets.hpp>
 #include <functional>
+#include <limits>
 #include <vector>
 
 namespace ewn
@@ -22,24 +24,32 @@ namespace ewn
 		public:
 			struct IncomingCommand;
 			struct OutgoingCommand;
+			struct SerializedPacket;
 
 			CommandStore() = default;
 			~CommandStore();
 
+			bool DecodePacket(std::size_t peerId, Nz::NetPacket&& packet, Packets::AnyPacket& decoded) const;
+			void DispatchPacket(std::size_t peerId, const Packets::AnyPacket& packet) const;
+
 			template<typename T> const IncomingCommand& GetIncomingCommand() const;
 			template<typename T> const OutgoingCommand& GetOutgoingCommand() const;
 
 			template<typename T>
 			void SerializePacket(Nz::NetPacket& packet, const T& data) const;
+			template<typename T>
+			SerializedPacket SerializePacket(const T& data) const;
 
 			bool UnserializePacket(std::size_t peerId, Nz::NetPacket&& packet) const;
 
-			using UnserializeFunction = std::function<void(std::size_t peerId, Nz::NetPacket&& packet)>;
+			using DecodeFunction = bool(*)(Nz::NetPacket& packet, Packets::AnyPacket& decoded);
+			using DispatchFunction = std::function<void(std::size_t peerId, const Packets::AnyPacket& packet)>;
 
 			struct IncomingCommand
 			{
 				bool enabled = false;
-				UnserializeFunction unserialize;
+				DecodeFunction decode;
+				DispatchFunction dispatch;
 				const char* name;
 			};
 
@@ -51,13 +61,21 @@ namespace ewn
 				Nz::UInt8 channelId;
 			};
 
+			struct SerializedPacket
+			{
+				Nz::ByteArray data;
+				Nz::ENetPacketFlags flags;
+				Nz::UInt8 channelId;
+			};
+
 		protected:
 			template<typename T, typename CB> void RegisterIncomingCommand(const char* name, CB&& callback);
 			template<typename T> void RegisterOutgoingCommand(const char* name, Nz::ENetPacketFlags flags, Nz::UInt8 channelId);
 
-		private:
-			using HandleFunction = std::function<void(Nz::NetPacket& packet)>;
+			inline void SetMaxIncomingPacketSize(std::size_t maxSize);
 
+		private:
+			std::size_t m_maxIncomingPacketSize = std::numeric_limits<std::size_t>::max();
 			std::vector<IncomingCommand> m_incomingCommands;
 			std::vector<OutgoingCommand> m_outgoingCommands;
 	};
@@ -35,13 +35,15 @@ namespace ewn
 	template<typename T, typename CB>
 	void CommandStore::RegisterIncomingCommand(const char* name, CB&& callback)
 	{
+		static_assert(std::is_same_v<std::variant_alternative_t<static_cast<std::size_t>(T::Type), Packets::AnyPacket>, T>, "AnyPacket alternatives must follow PacketType order");
+
 		std::size_t packetId = static_cast<std::size_t>(T::Type);
 
 		IncomingCommand newCommand;
 		newCommand.enabled = true;
-		newCommand.unserialize = [cb = std::forward<CB>(callback)](std::size_t peerId, Nz::NetPacket&& packet)
+		newCommand.decode = [](Nz::NetPacket& packet, Packets::AnyPacket& decoded) -> bool
 		{
-			T data;
+			T& data = decoded.emplace<T>();
 			try
 			{
 				PacketSerializer serializer(packet, false);
@@ -54,8 +56,11 @@ namespace ewn
 				return false;
 			}
 
-			cb(peerId, data);
-			return true;
+			return Packets::Validate(data);
+		};
+		newCommand.dispatch = [cb = std::forward<CB>(callback)](std::size_t peerId, const Packets::AnyPacket& packet)
+		{
+			cb(peerId, std::get<T>(packet));
 		};
 		newCommand.name = name;
 
@@ -82,6 +87,11 @@ namespace ewn
 		m_outgoingCommands[packetId] = std::move(newCommand);
 	}
 
+	inline void CommandStore::SetMaxIncomingPacketSize(std::size_t maxSize)
+	{
+		m_maxIncomingPacketSize = maxSize;
+	}
+
 	template<typename T>
 	void CommandStore::SerializePacket(Nz::NetPacket& packet, const T& data) const
 	{
@@ -94,4 +104,21 @@ namespace ewn
 		PacketSerializer serializer(packet, true);
 		Packets::Serialize(serializer, dataRef);
 	}
+
+	template<typename T>
+	CommandStore::SerializedPacket CommandStore::SerializePacket(const T& data) const
+	{
+		// Serialize once, the result can then be sent to any number of peers without being serialized again
+		const OutgoingCommand& command = GetOutgoingCommand<T>();
+
+		Nz::NetPacket packet;
+		SerializePacket(packet, data);
+
+		SerializedPacket serializedPacket;
+		serializedPacket.channelId = command.channelId;
+		serializedPacket.data = Nz::ByteArray(packet.GetConstData() + Nz::NetPacket::HeaderSize, packet.GetDataSize());
+		serializedPacket.flags = command.flags;
+
+		return serializedPacket;
+	}
 }
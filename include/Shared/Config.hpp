@@ -11,7 +11,12 @@
 
 namespace ewn
 {
+	constexpr std::size_t ClientPacketMaxSize = 128 * 1024; //< Spaceship scripts are sent by clients
 	constexpr std::size_t NetworkChannelCount = 1;
+	constexpr std::size_t NetworkEventBatchSize = 256; //< Max events moved at once between a network reactor and the application
+	constexpr std::size_t PlayerInputBatchMaxSize = 16;
+	constexpr Nz::UInt32 PlayerInputMaxTimeDelta = 1000; //< Max time between two inputs of a batch (ms), larger gaps are clamped
+	constexpr Nz::UInt32 ServerTickRate = 60; //< Arena simulation ticks per second
 }
 
 #endif // EREWHON_SHARED_CONFIG_HPP
@@ -11,6 +11,14 @@
 
 namespace ewn
 {
+	enum class AdmissionStage : Nz::UInt8
+	{
+		Connecting,
+		Authenticating,
+		Loading,
+		InArena
+	};
+
 	enum class BotMessageType : Nz::UInt8
 	{
 		Error,
@@ -9,9 +9,13 @@
 
 #include <Nazara/Core/Thread.hpp>
 #include <Nazara/Network/ENetHost.hpp>
+#include <Shared/Protocol/Packets.hpp>
 #include <concurrentqueue/concurrentqueue.h>
+#include <array>
 #include <atomic>
 #include <functional>
+#include <optional>
+#include <random>
 #include <variant>
 #include <vector>
 
@@ -27,7 +31,22 @@ namespace ewn
 	class NetworkReactor
 	{
 		public:
-			NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient);
+			using FastPathHandler = std::function<void(NetworkReactor& reactor, std::size_t peerId, const Packets::AnyPacket& packet)>;
+			using PacketDecoder = std::function<bool(std::size_t peerId, Nz::NetPacket&& packet, Packets::AnyPacket& decoded)>;
+
+			// Simulated network conditions, applied by the reactor to both incoming and outgoing packets (for testing purpose)
+			struct Impairment
+			{
+				Nz::UInt32 latency = 0;        //< One-way delay in milliseconds
+				Nz::UInt32 jitter = 0;         //< Max random delay added to latency, in milliseconds
+				float duplicationChance = 0.f; //< Unreliable packets only
+				float lossChance = 0.f;        //< Lost reliable packets are delayed by a round-trip, as if they were resent
+				float reorderChance = 0.f;     //< Chance for an unreliable packet to not wait for the previous ones
+
+				inline bool IsEnabled() const;
+			};
+
+			NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient, PacketDecoder decoder = nullptr);
 			NetworkReactor(const NetworkReactor&) = delete;
 			NetworkReactor(NetworkReactor&&) = delete;
 			~NetworkReactor();
@@ -35,24 +54,53 @@ namespace ewn
 			std::size_t ConnectTo(Nz::IpAddress address, Nz::UInt32 data = 0);
 			void DisconnectPeer(std::size_t peerId, Nz::UInt32 data = 0, DisconnectionType type = DisconnectionType::Normal);
 
-			template<typename ConnectCB, typename DisconnectCB, typename DataCB>
-			void Poll(ConnectCB&& onConnection, DisconnectCB&& onDisconnection, DataCB&& onData);
+			template<typename ConnectCB, typename DisconnectCB, typename DataCB, typename DecodedDataCB>
+			void Poll(ConnectCB&& onConnection, DisconnectCB&& onDisconnection, DataCB&& onData, DecodedDataCB&& onDecodedData);
 
 			inline Nz::NetProtocol GetProtocol() const;
 
+			void RegisterFastPathHandler(PacketType packetType, FastPathHandler handler);
+
 			void SendData(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet);
 
+			void SetImpairment(const Impairment& impairment);
+			void SetPeerImpairment(std::size_t peerId, std::optional<Impairment> impairment);
+
 			NetworkReactor& operator=(const NetworkReactor&) = delete;
 			NetworkReactor& operator=(NetworkReactor&&) = delete;
 
 			static constexpr std::size_t InvalidPeerId = std::numeric_limits<std::size_t>::max();
 	
 		private:
+			enum class ImpairedEventType
+			{
+				Connection, //< Stays ordered after everything previously scheduled for the peer
+				Reliable,
+				Unreliable
+			};
+
+			struct DelayState;
+			struct IncomingEvent;
+			struct OutgoingEvent;
+
 			void HandleConnectionRequests(const moodycamel::ConsumerToken& token);
+			void HandleFastPathRegistrations();
+			void HandleImpairmentUpdates();
+			std::size_t ImpairEvent(const Impairment& impairment, DelayState& state, ImpairedEventType type, Nz::UInt64 now, std::array<Nz::UInt64, 2>& releaseTimes);
+			void ProcessOutgoingEvent(OutgoingEvent& outEvent);
+			void PublishIncomingEvents(const moodycamel::ProducerToken& producterToken);
+			void PurgeDelayedOutgoingEvents(std::size_t peerIndex);
+			void PushIncomingEvent(IncomingEvent&& event);
+			void QueueIncomingEvent(std::size_t peerIndex, ImpairedEventType type, IncomingEvent&& event, Nz::UInt64 now);
+			void QueueOutgoingEvent(OutgoingEvent&& event, Nz::UInt64 now);
 			void ReceivePackets(const moodycamel::ProducerToken& producterToken);
+			void ReleaseDelayedEvents(const moodycamel::ProducerToken& producterToken);
 			void SendPackets(const moodycamel::ProducerToken& producterToken, const moodycamel::ConsumerToken& token);
 			void WorkerThread();
 
+			template<typename T, typename E> void ScheduleEvent(std::vector<T>& queue, Nz::UInt64 releaseTime, E&& event);
+			template<typename T> static bool IsReleasedAfter(const T& lhs, const T& rhs);
+
 			struct ConnectionRequest
 			{
 				using Callback = std::function<void(std::size_t clientId)>;
@@ -62,6 +110,32 @@ namespace ewn
 				Nz::UInt32 data;
 			};
 
+			struct DelayState
+			{
+				Nz::UInt64 lastRelease = 0;
+				Nz::UInt64 lastReliableRelease = 0;
+				Nz::UInt64 lastUnreliableRelease = 0;
+			};
+
+			struct FastPathRegistration
+			{
+				FastPathHandler handler;
+				PacketType packetType;
+			};
+
+			struct ImpairmentUpdate
+			{
+				std::optional<Impairment> impairment;
+				std::size_t peerIndex; //< InvalidPeerId for the global impairment
+			};
+
+			struct PeerImpairment
+			{
+				std::optional<Impairment> impairment; //< Overrides global impairment
+				DelayState incoming;
+				DelayState outgoing;
+			};
+
 			struct IncomingEvent
 			{
 				struct ConnectEvent
@@ -80,8 +154,13 @@ namespace ewn
 					Nz::NetPacket packet;
 				};
 
+				struct DecodedPacketEvent
+				{
+					Packets::AnyPacket packet;
+				};
+
 				std::size_t peerId;
-				std::variant<ConnectEvent, DisconnectEvent, PacketEvent> data;
+				std::variant<ConnectEvent, DisconnectEvent, PacketEvent, DecodedPacketEvent> data;
 			};
 
 			struct OutgoingEvent
@@ -103,13 +182,40 @@ namespace ewn
 				std::variant<DisconnectEvent, PacketEvent> data;
 			};
 
+			struct DelayedIncomingEvent
+			{
+				Nz::UInt64 releaseTime;
+				Nz::UInt64 sequence;
+				IncomingEvent event;
+			};
+
+			struct DelayedOutgoingEvent
+			{
+				Nz::UInt64 releaseTime;
+				Nz::UInt64 sequence;
+				OutgoingEvent event;
+			};
+
 			std::atomic_bool m_running;
 			std::size_t m_firstId;
 			std::vector<Nz::ENetPeer*> m_clients;
+			std::vector<FastPathHandler> m_fastPathHandlers; //< Only accessed by the reactor thread
+			std::vector<IncomingEvent> m_incomingBatch; //< Only accessed by the reactor thread
+			std::vector<IncomingEvent> m_polledEvents; //< Only accessed by the polling thread
+			std::vector<OutgoingEvent> m_outgoingBatch; //< Only accessed by the reactor thread
+			std::vector<DelayedIncomingEvent> m_delayedIncomingEvents; //< Heap, only accessed by the reactor thread
+			std::vector<DelayedOutgoingEvent> m_delayedOutgoingEvents; //< Heap, only accessed by the reactor thread
+			std::vector<PeerImpairment> m_peerImpairments; //< Only accessed by the reactor thread
+			std::mt19937 m_randomGenerator;
+			Impairment m_impairment; //< Only accessed by the reactor thread
+			Nz::UInt64 m_delayedEventSequence;
 			moodycamel::ConcurrentQueue<ConnectionRequest> m_connectionRequests;
+			moodycamel::ConcurrentQueue<FastPathRegistration> m_fastPathRegistrations;
+			moodycamel::ConcurrentQueue<ImpairmentUpdate> m_impairmentUpdates;
 			moodycamel::ConcurrentQueue<IncomingEvent> m_incomingQueue;
 			moodycamel::ConcurrentQueue<OutgoingEvent> m_outgoingQueue;
-			Nz::ENetHost m_host;
+			Nz::ENetHost m_host; //< Owns the UDP socket (one send/receive call per datagram), only our queues are batched
+			PacketDecoder m_decoder;
 			Nz::NetProtocol m_protocol;
 			Nz::Thread m_thread;
 	};
@@ -4,33 +4,42 @@
 
 #include <Shared/NetworkReactor.hpp>
 #include <Shared/Utils.hpp>
+#include <algorithm>
 
 namespace ewn
 {
-	template<typename ConnectCB, typename DisconnectCB, typename DataCB>
-	void NetworkReactor::Poll(ConnectCB&& onConnection, DisconnectCB&& onDisconnection, DataCB&& onData)
+	template<typename ConnectCB, typename DisconnectCB, typename DataCB, typename DecodedDataCB>
+	void NetworkReactor::Poll(ConnectCB&& onConnection, DisconnectCB&& onDisconnection, DataCB&& onData, DecodedDataCB&& onDecodedData)
 	{
-		IncomingEvent inEvent;
-		while (m_incomingQueue.try_dequeue(inEvent))
+		std::size_t eventCount;
+		while ((eventCount = m_incomingQueue.try_dequeue_bulk(m_polledEvents.begin(), m_polledEvents.size())) > 0)
 		{
-			std::visit([&](auto&& arg) {
-				using T = std::decay_t<decltype(arg)>;
-				if constexpr (std::is_same_v<T, IncomingEvent::ConnectEvent>)
-				{
-					onConnection(arg.outgoingConnection, inEvent.peerId, arg.data);
-				}
-				else if constexpr (std::is_same_v<T, IncomingEvent::DisconnectEvent>)
-				{
-					onDisconnection(inEvent.peerId, arg.data);
-				}
-				else if constexpr (std::is_same_v<T, IncomingEvent::PacketEvent>)
-				{
-					onData(inEvent.peerId, std::move(arg.packet));
-				}
-				else
-					static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
-
-			}, inEvent.data);
+			for (std::size_t i = 0; i < eventCount; ++i)
+			{
+				IncomingEvent& inEvent = m_polledEvents[i];
+				std::visit([&](auto&& arg) {
+					using T = std::decay_t<decltype(arg)>;
+					if constexpr (std::is_same_v<T, IncomingEvent::ConnectEvent>)
+					{
+						onConnection(arg.outgoingConnection, inEvent.peerId, arg.data);
+					}
+					else if constexpr (std::is_same_v<T, IncomingEvent::DisconnectEvent>)
+					{
+						onDisconnection(inEvent.peerId, arg.data);
+					}
+					else if constexpr (std::is_same_v<T, IncomingEvent::PacketEvent>)
+					{
+						onData(inEvent.peerId, std::move(arg.packet));
+					}
+					else if constexpr (std::is_same_v<T, IncomingEvent::DecodedPacketEvent>)
+					{
+						onDecodedData(inEvent.peerId, std::move(arg.packet));
+					}
+					else
+						static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+
+				}, inEvent.data);
+			}
 		}
 	}
 
@@ -38,4 +47,29 @@ namespace ewn
 	{
 		return m_protocol;
 	}
+
+	template<typename T, typename E>
+	void NetworkReactor::ScheduleEvent(std::vector<T>& queue, Nz::UInt64 releaseTime, E&& event)
+	{
+		T& delayedEvent = queue.emplace_back();
+		delayedEvent.event = std::forward<E>(event);
+		delayedEvent.releaseTime = releaseTime;
+		delayedEvent.sequence = m_delayedEventSequence++; //< Keeps events with the same release time in order
+
+		std::push_heap(queue.begin(), queue.end(), &IsReleasedAfter<T>);
+	}
+
+	template<typename T>
+	bool NetworkReactor::IsReleasedAfter(const T& lhs, const T& rhs)
+	{
+		if (lhs.releaseTime != rhs.releaseTime)
+			return lhs.releaseTime > rhs.releaseTime;
+
+		return lhs.sequence > rhs.sequence;
+	}
+
+	inline bool NetworkReactor::Impairment::IsEnabled() const
+	{
+		return latency > 0 || jitter > 0 || duplicationChance > 0.f || lossChance > 0.f || reorderChance > 0.f;
+	}
 }
@@ -26,14 +26,23 @@ namespace ewn
 
 			void FillStore(std::size_t firstId, std::vector<std::string> strings);
 
+			inline Nz::UInt64 GetHash() const;
+			inline Nz::UInt64 GetHash(std::size_t stringCount) const;
 			inline const std::string& GetString(std::size_t id) const;
+			inline std::size_t GetStringCount() const;
 			inline std::size_t GetStringIndex(const std::string& string) const;
+			inline const std::vector<std::string>& GetStrings() const;
 
 			inline std::size_t RegisterString(std::string string);
 
 		private:
+			static Nz::UInt64 HashString(Nz::UInt64 hash, const std::string& string);
+
+			static constexpr Nz::UInt64 InitialHash = 14695981039346656037ULL;
+
 			tsl::hopscotch_map<std::string, std::size_t> m_stringMap;
 			std::vector<std::string> m_strings;
+			std::vector<Nz::UInt64> m_hashes; //< m_hashes[i] is the hash of the first i + 1 strings
 	};
 }
 
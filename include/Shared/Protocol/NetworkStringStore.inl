@@ -14,16 +14,33 @@ namespace ewn
 
 	inline void NetworkStringStore::Clear()
 	{
+		m_hashes.clear();
 		m_stringMap.clear();
 		m_strings.clear();
 	}
 
+	inline Nz::UInt64 NetworkStringStore::GetHash() const
+	{
+		return GetHash(m_strings.size());
+	}
+
+	inline Nz::UInt64 NetworkStringStore::GetHash(std::size_t stringCount) const
+	{
+		assert(stringCount <= m_hashes.size());
+		return (stringCount > 0) ? m_hashes[stringCount - 1] : InitialHash;
+	}
+
 	inline const std::string& NetworkStringStore::GetString(std::size_t id) const
 	{
 		assert(id < m_strings.size());
 		return m_strings[id];
 	}
 
+	inline std::size_t NetworkStringStore::GetStringCount() const
+	{
+		return m_strings.size();
+	}
+
 	inline std::size_t NetworkStringStore::GetStringIndex(const std::string& string) const
 	{
 		auto it = m_stringMap.find(string);
@@ -32,6 +49,11 @@ namespace ewn
 		return it->second;
 	}
 
+	inline const std::vector<std::string>& NetworkStringStore::GetStrings() const
+	{
+		return m_strings;
+	}
+
 	inline std::size_t NetworkStringStore::RegisterString(std::string string)
 	{
 		// Try to find string first, it may have been registered already
@@ -41,6 +63,7 @@ namespace ewn
 
 		// String does not exist; insert it
 		std::size_t stringId = m_strings.size();
+		m_hashes.push_back(HashString(GetHash(), string));
 		m_stringMap.emplace(string, stringId);
 		m_strings.emplace_back(std::move(string));
 
@@ -23,6 +23,7 @@ namespace ewn
 {
 	enum class PacketType
 	{
+		AdmissionQueuePosition,
 		ArenaPrefabs,
 		ArenaSounds,
 		ArenaState,
@@ -31,7 +32,9 @@ namespace ewn
 		CreateSpaceship,
 		ControlEntity,
 		CreateEntity,
+		CreateProjectile,
 		DeleteEntity,
+		DeleteProjectile,
 		DeleteSpaceship,
 		IntegrityUpdate,
 		JoinArena,
@@ -39,10 +42,12 @@ namespace ewn
 		LoginFailure,
 		LoginSuccess,
 		NetworkStrings,
+		NetworkStringsHash,
 		PlayerChat,
 		PlayerMovement,
 		PlayerShoot,
 		PlaySound,
+		QueryNetworkStrings,
 		QuerySpaceshipInfo,
 		QuerySpaceshipList,
 		Register,
@@ -67,6 +72,12 @@ namespace ewn
 	{
 #define DeclarePacket(Type) struct Type : PacketTag<PacketType:: Type >
 
+		DeclarePacket(AdmissionQueuePosition)
+		{
+			AdmissionStage stage;
+			CompressedUnsigned<Nz::UInt32> position; //< Starts at 1
+		};
+
 		DeclarePacket(ArenaPrefabs)
 		{
 			CompressedUnsigned<Nz::UInt32> startId;
@@ -128,6 +139,7 @@ namespace ewn
 
 			Nz::UInt16 stateId;
 			CompressedUnsigned<Nz::UInt64> serverTime;
+			CompressedUnsigned<Nz::UInt64> serverTick;
 			CompressedUnsigned<Nz::UInt64> lastProcessedInputTime;
 			std::vector<Entity> entities;
 		};
@@ -159,6 +171,16 @@ namespace ewn
 			Nz::String visualName;
 		};
 
+		DeclarePacket(CreateProjectile)
+		{
+			CompressedUnsigned<Nz::UInt32> prefabId;
+			CompressedUnsigned<Nz::UInt32> projectileId;
+			CompressedUnsigned<Nz::UInt64> spawnTime; //< Server time at which the projectile was at position
+			Nz::Quaternionf rotation;
+			Nz::Vector3f linearVelocity;
+			Nz::Vector3f position;
+		};
+
 		DeclarePacket(CreateSpaceship)
 		{
 			std::string spaceshipName;
@@ -170,6 +192,11 @@ namespace ewn
 			CompressedUnsigned<Nz::UInt32> id;
 		};
 
+		DeclarePacket(DeleteProjectile)
+		{
+			CompressedUnsigned<Nz::UInt32> projectileId;
+		};
+
 		DeclarePacket(DeleteSpaceship)
 		{
 			std::string spaceshipName;
@@ -206,6 +233,12 @@ namespace ewn
 			std::vector<std::string> strings;
 		};
 
+		DeclarePacket(NetworkStringsHash)
+		{
+			Nz::UInt64 hash;
+			CompressedUnsigned<Nz::UInt32> stringCount;
+		};
+
 		DeclarePacket(PlayerChat)
 		{
 			std::string text;
@@ -213,13 +246,20 @@ namespace ewn
 
 		DeclarePacket(PlayerMovement)
 		{
+			struct Input
+			{
+				CompressedUnsigned<Nz::UInt32> timeDelta; //< Time elapsed since previous input (or since inputTime for the first one)
+				Nz::Vector3f direction;
+				Nz::Vector3f rotation;
+			};
+
 			CompressedUnsigned<Nz::UInt64> inputTime; //< Server time
-			Nz::Vector3f direction;
-			Nz::Vector3f rotation;
+			std::vector<Input> inputs; //< Last inputs, from oldest to newest (older ones are sent again to survive packet loss)
 		};
 
 		DeclarePacket(PlayerShoot)
 		{
+			CompressedUnsigned<Nz::UInt32> renderDelay; //< Interpolation delay of the entities the client was seeing (in milliseconds)
 		};
 
 		DeclarePacket(PlaySound)
@@ -228,6 +268,12 @@ namespace ewn
 			Nz::Vector3f position;
 		};
 
+		DeclarePacket(QueryNetworkStrings)
+		{
+			Nz::UInt64 knownHash; //< Hash of the strings the client already has (first knownCount strings)
+			CompressedUnsigned<Nz::UInt32> knownCount;
+		};
+
 		DeclarePacket(QuerySpaceshipInfo)
 		{
 			std::string spaceshipName;
@@ -301,6 +347,49 @@ namespace ewn
 
 #undef DeclarePacket
 
+		// Holds any packet, alternatives follow PacketType order so that index() is the packet type
+		using AnyPacket = std::variant<
+			AdmissionQueuePosition,
+			ArenaPrefabs,
+			ArenaSounds,
+			ArenaState,
+			BotMessage,
+			ChatMessage,
+			CreateSpaceship,
+			ControlEntity,
+			CreateEntity,
+			CreateProjectile,
+			DeleteEntity,
+			DeleteProjectile,
+			DeleteSpaceship,
+			IntegrityUpdate,
+			JoinArena,
+			Login,
+			LoginFailure,
+			LoginSuccess,
+			NetworkStrings,
+			NetworkStringsHash,
+			PlayerChat,
+			PlayerMovement,
+			PlayerShoot,
+			PlaySound,
+			QueryNetworkStrings,
+			QuerySpaceshipInfo,
+			QuerySpaceshipList,
+			Register,
+			RegisterFailure,
+			RegisterSuccess,
+			SpaceshipInfo,
+			SpaceshipList,
+			SpawnSpaceship,
+			TimeSyncRequest,
+			TimeSyncResponse,
+			UpdateSpaceship,
+			UpdateSpaceshipFailure,
+			UpdateSpaceshipSuccess
+		>;
+
+		void Serialize(PacketSerializer& serializer, AdmissionQueuePosition& data);
 		void Serialize(PacketSerializer& serializer, ArenaPrefabs& data);
 		void Serialize(PacketSerializer& serializer, ArenaSounds& data);
 		void Serialize(PacketSerializer& serializer, ArenaState& data);
@@ -308,8 +397,10 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, ChatMessage& data);
 		void Serialize(PacketSerializer& serializer, ControlEntity& data);
 		void Serialize(PacketSerializer& serializer, CreateEntity& data);
+		void Serialize(PacketSerializer& serializer, CreateProjectile& data);
 		void Serialize(PacketSerializer& serializer, CreateSpaceship& data);
 		void Serialize(PacketSerializer& serializer, DeleteEntity& data);
+		void Serialize(PacketSerializer& serializer, DeleteProjectile& data);
 		void Serialize(PacketSerializer& serializer, DeleteSpaceship& data);
 		void Serialize(PacketSerializer& serializer, IntegrityUpdate& data);
 		void Serialize(PacketSerializer& serializer, JoinArena& data);
@@ -317,10 +408,12 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, LoginFailure& data);
 		void Serialize(PacketSerializer& serializer, LoginSuccess& data);
 		void Serialize(PacketSerializer& serializer, NetworkStrings& data);
+		void Serialize(PacketSerializer& serializer, NetworkStringsHash& data);
 		void Serialize(PacketSerializer& serializer, PlayerChat& data);
 		void Serialize(PacketSerializer& serializer, PlayerMovement& data);
 		void Serialize(PacketSerializer& serializer, PlayerShoot& data);
 		void Serialize(PacketSerializer& serializer, PlaySound& data);
+		void Serialize(PacketSerializer& serializer, QueryNetworkStrings& data);
 		void Serialize(PacketSerializer& serializer, QuerySpaceshipInfo& data);
 		void Serialize(PacketSerializer& serializer, QuerySpaceshipList& data);
 		void Serialize(PacketSerializer& serializer, Register& data);
@@ -334,6 +427,10 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, UpdateSpaceship& data);
 		void Serialize(PacketSerializer& serializer, UpdateSpaceshipFailure& data);
 		void Serialize(PacketSerializer& serializer, UpdateSpaceshipSuccess& data);
+
+		// Checks (and possibly clamps) decoded packet content, packets failing validation are treated as malformed
+		template<typename T> bool Validate(T& data);
+		bool Validate(PlayerMovement& data);
 	}
 }
 
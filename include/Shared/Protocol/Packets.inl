@@ -6,4 +6,12 @@
 
 namespace ewn
 {
+	namespace Packets
+	{
+		template<typename T>
+		bool Validate(T& /*data*/)
+		{
+			return true;
+		}
+	}
 }
@@ -1,3 +1,21 @@
+-- Connection admission limits, players over these are queued (0 means no limit)
+Admission = {
+	MaxAuthenticating      = 16,
+	MaxConnectingPerUpdate = 32,
+	MaxInArena             = 100,
+	MaxLoadingPerUpdate    = 4
+}
+
+-- Arena instancing, new arenas are created when every arena reaches one of these limits (0 means no limit)
+Arena = {
+	MaxEntities  = 2000,
+	MaxInstances = 8,
+	MaxPlayers   = 32,
+
+	-- Threads shared by every arena to run independent systems in parallel (0 means each arena only uses its own thread)
+	SimulationWorkerCount = 2
+}
+
 AssetsFolder = "Assets/"
 
 Database = {
@@ -15,6 +33,15 @@ Game = {
 	WorkerCount = 2
 }
 
+-- Simulated network conditions for netcode testing (chances are between 0 and 1), keep disabled in production
+NetworkImpairment = {
+	Latency           = 0, -- ms
+	Jitter            = 0, -- ms
+	LossChance        = 0.0,
+	DuplicationChance = 0.0,
+	ReorderChance     = 0.0
+}
+
 -- Warning: changing these parameters will break login to already registered accounts
 Security = {
 	Argon2 = {
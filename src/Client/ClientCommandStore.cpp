@@ -18,6 +18,7 @@ namespace ewn
 #define OutgoingCommand(Type, Flags, Channel) RegisterOutgoingCommand<Packets::Type>(#Type, Flags, Channel)
 
 		// Incoming commands
+		IncomingCommand(AdmissionQueuePosition);
 		IncomingCommand(ArenaPrefabs);
 		IncomingCommand(ArenaSounds);
 		IncomingCommand(ArenaState);
@@ -25,11 +26,14 @@ namespace ewn
 		IncomingCommand(ChatMessage);
 		IncomingCommand(ControlEntity);
 		IncomingCommand(CreateEntity);
+		IncomingCommand(CreateProjectile);
 		IncomingCommand(DeleteEntity);
+		IncomingCommand(DeleteProjectile);
 		IncomingCommand(IntegrityUpdate);
 		IncomingCommand(LoginFailure);
 		IncomingCommand(LoginSuccess);
 		IncomingCommand(NetworkStrings);
+		IncomingCommand(NetworkStringsHash);
 		IncomingCommand(PlaySound);
 		IncomingCommand(RegisterFailure);
 		IncomingCommand(RegisterSuccess);
@@ -40,19 +44,20 @@ namespace ewn
 		IncomingCommand(UpdateSpaceshipSuccess);
 
 		// Outgoing commands
-		OutgoingCommand(CreateSpaceship,    Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(DeleteSpaceship,    Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(JoinArena,          Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(Login,              Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(PlayerChat,         Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(PlayerMovement,     0,                           0);
-		OutgoingCommand(PlayerShoot,        Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(QuerySpaceshipInfo, Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(QuerySpaceshipList, Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(Register,           Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(SpawnSpaceship,     Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(TimeSyncRequest,    0,                           0);
-		OutgoingCommand(UpdateSpaceship,    Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(CreateSpaceship,     Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(DeleteSpaceship,     Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(JoinArena,           Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(Login,               Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(PlayerChat,          Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(PlayerMovement,      0,                           0);
+		OutgoingCommand(PlayerShoot,         Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(QueryNetworkStrings, Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(QuerySpaceshipInfo,  Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(QuerySpaceshipList,  Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(Register,            Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(SpawnSpaceship,      Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(TimeSyncRequest,     0,                           0);
+		OutgoingCommand(UpdateSpaceship,     Nz::ENetPacketFlag_Reliable, 0);
 
 #undef IncomingCommand
 #undef OutgoingCommand
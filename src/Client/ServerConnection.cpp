@@ -3,10 +3,72 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Client/ServerConnection.hpp>
+#include <Nazara/Core/Directory.hpp>
+#include <Nazara/Core/File.hpp>
 #include <Client/ClientApplication.hpp>
+#include <iostream>
 
 namespace ewn
 {
+	namespace
+	{
+		const char* s_networkStringsCacheFolder = "cache";
+		const char* s_lastNetworkStringsCachePath = "cache/networkstrings_last.cache";
+
+		// Strings are stored one per line, line breaks (and backslashes) are escaped
+		std::string EscapeCacheString(const std::string& str)
+		{
+			std::string escaped;
+			escaped.reserve(str.size());
+
+			for (char c : str)
+			{
+				switch (c)
+				{
+					case '\\': escaped += "\\\\"; break;
+					case '\n': escaped += "\\n"; break;
+					case '\r': escaped += "\\r"; break;
+					default:   escaped += c; break;
+				}
+			}
+
+			return escaped;
+		}
+
+		Nz::String GetNetworkStringsCachePath(Nz::UInt64 hash)
+		{
+			return Nz::String(s_networkStringsCacheFolder) + "/networkstrings_" + Nz::String::Number(hash, 16) + ".cache";
+		}
+
+		bool UnescapeCacheString(const std::string& escaped, std::string* str)
+		{
+			str->clear();
+			str->reserve(escaped.size());
+
+			for (std::size_t i = 0; i < escaped.size(); ++i)
+			{
+				if (escaped[i] != '\\')
+				{
+					*str += escaped[i];
+					continue;
+				}
+
+				if (++i >= escaped.size())
+					return false;
+
+				switch (escaped[i])
+				{
+					case '\\': *str += '\\'; break;
+					case 'n':  *str += '\n'; break;
+					case 'r':  *str += '\r'; break;
+					default:   return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
 	bool ServerConnection::Connect(const Nz::String& serverHostname, Nz::UInt32 data)
 	{
 		if (IsConnected())
@@ -21,10 +83,102 @@ namespace ewn
 		return ClientApplication::GetAppTime() + m_deltaTime;
 	}
 
+	void ServerConnection::HandleNetworkStringsHash(ServerConnection* server, const Packets::NetworkStringsHash& data)
+	{
+		assert(server == this);
+
+		m_expectedStringsHash = data.hash;
+
+		// We may already have this exact table from a previous connection
+		if (LoadNetworkStringsCache(GetNetworkStringsCachePath(data.hash)) && m_stringStore.GetHash() == data.hash)
+			return;
+
+		// If not, server tables only grow so the last one we received may still be a valid prefix of it
+		Packets::QueryNetworkStrings query;
+		if (LoadNetworkStringsCache(s_lastNetworkStringsCachePath))
+		{
+			query.knownCount = Nz::UInt32(m_stringStore.GetStringCount());
+			query.knownHash = m_stringStore.GetHash();
+		}
+		else
+		{
+			query.knownCount = 0;
+			query.knownHash = 0;
+		}
+
+		SendPacket(query);
+	}
+
+	bool ServerConnection::LoadNetworkStringsCache(const Nz::String& filePath)
+	{
+		m_stringStore.Clear();
+
+		// Cache format: hash, string count and then one (escaped) string per line
+		Nz::File cacheFile(filePath);
+		if (!cacheFile.Open(Nz::OpenMode_ReadOnly | Nz::OpenMode_Text))
+			return false;
+
+		Nz::String hash = cacheFile.ReadLine();
+
+		long long stringCount;
+		if (!cacheFile.ReadLine().ToInteger(&stringCount) || stringCount < 0)
+			return false;
+
+		std::vector<std::string> strings(static_cast<std::size_t>(stringCount));
+		for (std::string& str : strings)
+		{
+			if (cacheFile.EndOfFile())
+				return false;
+
+			if (!UnescapeCacheString(cacheFile.ReadLine().ToStdString(), &str))
+				return false;
+		}
+
+		m_stringStore.FillStore(0, std::move(strings));
+
+		// Check cache integrity
+		if (Nz::String::Number(m_stringStore.GetHash(), 16) != hash)
+		{
+			std::cerr << "Networked strings cache " << filePath << " is corrupted" << std::endl;
+			m_stringStore.Clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	void ServerConnection::SaveNetworkStringsCache() const
+	{
+		Nz::UInt64 hash = m_stringStore.GetHash();
+
+		std::string content = Nz::String::Number(hash, 16).ToStdString() + '\n' + std::to_string(m_stringStore.GetStringCount()) + '\n';
+		for (const std::string& str : m_stringStore.GetStrings())
+		{
+			content += EscapeCacheString(str);
+			content += '\n';
+		}
+
+		Nz::Directory::Create(s_networkStringsCacheFolder);
+
+		for (const Nz::String& filePath : { GetNetworkStringsCachePath(hash), Nz::String(s_lastNetworkStringsCachePath) })
+		{
+			Nz::File cacheFile(filePath);
+			if (cacheFile.Open(Nz::OpenMode_Truncate | Nz::OpenMode_WriteOnly))
+				cacheFile.Write(content.data(), content.size());
+			else
+				std::cerr << "Failed to open " << filePath << std::endl;
+		}
+	}
+
 	void ServerConnection::UpdateNetworkStrings(ServerConnection* server, const Packets::NetworkStrings& data)
 	{
 		assert(server == this);
 
 		m_stringStore.FillStore(data.startId, std::move(data.strings));
+
+		if (m_stringStore.GetHash() == m_expectedStringsHash)
+			SaveNetworkStringsCache();
+		else
+			std::cerr << "Networked strings hash mismatch, strings won't be cached" << std::endl;
 	}
 }
@@ -51,6 +51,7 @@ namespace ewn
 			NazaraSignal(OnDisconnected, ServerConnection* /*server*/, Nz::UInt32 /*data*/);
 
 			// Packet reception signals
+			NazaraSignal(OnAdmissionQueuePosition, ServerConnection* /*server*/, const Packets::AdmissionQueuePosition& /*data*/);
 			NazaraSignal(OnArenaPrefabs,           ServerConnection* /*server*/, const Packets::ArenaPrefabs&     /*data*/);
 			NazaraSignal(OnArenaSounds,            ServerConnection* /*server*/, const Packets::ArenaSounds&      /*data*/);
 			NazaraSignal(OnArenaState,             ServerConnection* /*server*/, const Packets::ArenaState&       /*data*/);
@@ -58,11 +59,14 @@ namespace ewn
 			NazaraSignal(OnChatMessage,            ServerConnection* /*server*/, const Packets::ChatMessage&      /*data*/);
 			NazaraSignal(OnControlEntity,          ServerConnection* /*server*/, const Packets::ControlEntity&    /*data*/);
 			NazaraSignal(OnCreateEntity,           ServerConnection* /*server*/, const Packets::CreateEntity&     /*data*/);
+			NazaraSignal(OnCreateProjectile,       ServerConnection* /*server*/, const Packets::CreateProjectile& /*data*/);
 			NazaraSignal(OnDeleteEntity,           ServerConnection* /*server*/, const Packets::DeleteEntity&     /*data*/);
+			NazaraSignal(OnDeleteProjectile,       ServerConnection* /*server*/, const Packets::DeleteProjectile& /*data*/);
 			NazaraSignal(OnIntegrityUpdate,        ServerConnection* /*server*/, const Packets::IntegrityUpdate&  /*data*/);
 			NazaraSignal(OnLoginFailure,           ServerConnection* /*server*/, const Packets::LoginFailure&     /*data*/);
 			NazaraSignal(OnLoginSuccess,           ServerConnection* /*server*/, const Packets::LoginSuccess&     /*data*/);
 			NazaraSignal(OnNetworkStrings,         ServerConnection* /*server*/, const Packets::NetworkStrings&   /*data*/);
+			NazaraSignal(OnNetworkStringsHash,     ServerConnection* /*server*/, const Packets::NetworkStringsHash& /*data*/);
 			NazaraSignal(OnPlaySound,              ServerConnection* /*server*/, const Packets::PlaySound&        /*data*/);
 			NazaraSignal(OnRegisterFailure,        ServerConnection* /*server*/, const Packets::RegisterFailure&  /*data*/);
 			NazaraSignal(OnRegisterSuccess,        ServerConnection* /*server*/, const Packets::RegisterSuccess&  /*data*/);
@@ -77,6 +81,9 @@ namespace ewn
 			inline void NotifyConnected(Nz::UInt32 data);
 			inline void NotifyDisconnected(Nz::UInt32 data);
 
+			void HandleNetworkStringsHash(ServerConnection* server, const Packets::NetworkStringsHash& data);
+			bool LoadNetworkStringsCache(const Nz::String& filePath);
+			void SaveNetworkStringsCache() const;
 			void UpdateNetworkStrings(ServerConnection* server, const Packets::NetworkStrings& data);
 
 			ClientApplication& m_application;
@@ -84,6 +91,7 @@ namespace ewn
 			NetworkStringStore m_stringStore;
 			NetworkReactor* m_networkReactor;
 			Nz::UInt64 m_deltaTime;
+			Nz::UInt64 m_expectedStringsHash;
 			std::size_t m_peerId;
 			bool m_connected;
 	};
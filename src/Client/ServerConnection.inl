@@ -13,10 +13,12 @@ namespace ewn
 	m_application(application),
 	m_commandStore(this),
 	m_networkReactor(nullptr),
+	m_expectedStringsHash(0),
 	m_peerId(NetworkReactor::InvalidPeerId),
 	m_connected(false)
 	{
 		OnNetworkStrings.Connect([this](ServerConnection* server, const Packets::NetworkStrings& data) { UpdateNetworkStrings(server, data); });
+		OnNetworkStringsHash.Connect([this](ServerConnection* server, const Packets::NetworkStringsHash& data) { HandleNetworkStringsHash(server, data); });
 	}
 
 	inline void ServerConnection::Disconnect(Nz::UInt32 data)
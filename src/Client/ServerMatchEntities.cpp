@@ -16,6 +16,7 @@
 #include <NDK/Components.hpp>
 #include <Client/ClientApplication.hpp>
 #include <Client/Components/SoundEmitterComponent.hpp>
+#include <algorithm>
 #include <iostream>
 
 namespace ewn
@@ -33,12 +34,14 @@ namespace ewn
 	{
 		m_snapshotDelay = m_jitterBuffer.size() * 1000 / 30 /* + ping? */;
 
-		m_onArenaPrefabsSlot.Connect(server->OnArenaPrefabs, this, &ServerMatchEntities::OnArenaPrefabs);
-		m_onArenaSoundsSlot.Connect(server->OnArenaSounds, this,   &ServerMatchEntities::OnArenaSounds);
-		m_onArenaStateSlot.Connect(server->OnArenaState, this,     &ServerMatchEntities::OnArenaState);
-		m_onCreateEntitySlot.Connect(server->OnCreateEntity, this, &ServerMatchEntities::OnCreateEntity);
-		m_onDeleteEntitySlot.Connect(server->OnDeleteEntity, this, &ServerMatchEntities::OnDeleteEntity);
-		m_onPlaySoundSlot.Connect(server->OnPlaySound, this,       &ServerMatchEntities::OnPlaySound);
+		m_onArenaPrefabsSlot.Connect(server->OnArenaPrefabs, this,         &ServerMatchEntities::OnArenaPrefabs);
+		m_onArenaSoundsSlot.Connect(server->OnArenaSounds, this,           &ServerMatchEntities::OnArenaSounds);
+		m_onArenaStateSlot.Connect(server->OnArenaState, this,             &ServerMatchEntities::OnArenaState);
+		m_onCreateEntitySlot.Connect(server->OnCreateEntity, this,         &ServerMatchEntities::OnCreateEntity);
+		m_onCreateProjectileSlot.Connect(server->OnCreateProjectile, this, &ServerMatchEntities::OnCreateProjectile);
+		m_onDeleteEntitySlot.Connect(server->OnDeleteEntity, this,         &ServerMatchEntities::OnDeleteEntity);
+		m_onDeleteProjectileSlot.Connect(server->OnDeleteProjectile, this, &ServerMatchEntities::OnDeleteProjectile);
+		m_onPlaySoundSlot.Connect(server->OnPlaySound, this,               &ServerMatchEntities::OnPlaySound);
 
 		FillVisualEffectFactory();
 
@@ -70,6 +73,7 @@ namespace ewn
 	void ServerMatchEntities::Update(float elapsedTime)
 	{
 		HandlePlayingSounds();
+		UpdateProjectiles();
 
 		if (m_stateHandlingEnabled)
 		{
@@ -244,6 +248,21 @@ namespace ewn
 		}
 	}
 
+	void ServerMatchEntities::UpdateProjectiles()
+	{
+		// Projectiles are shown at the same (interpolated) time as the entities they may hit
+		Nz::Int64 viewTime = static_cast<Nz::Int64>(m_server->EstimateServerTime()) - static_cast<Nz::Int64>(m_snapshotDelay);
+
+		for (auto& pair : m_projectiles)
+		{
+			Projectile& projectile = pair.second;
+
+			// Projectiles are received before the view time reaches their spawn, keep them at their spawn point until then
+			float elapsedTime = std::max(viewTime - static_cast<Nz::Int64>(projectile.spawnTime), Nz::Int64(0)) / 1000.f;
+			projectile.entity->GetComponent<Ndk::NodeComponent>().SetPosition(projectile.position + projectile.linearVelocity * elapsedTime);
+		}
+	}
+
 	void ServerMatchEntities::OnArenaPrefabs(ServerConnection* server, const Packets::ArenaPrefabs& arenaPrefabs)
 	{
 		Nz::ModelParameters params;
@@ -398,6 +417,27 @@ namespace ewn
 		OnEntityCreated(this, data);
 	}
 
+	void ServerMatchEntities::OnCreateProjectile(ServerConnection*, const Packets::CreateProjectile& createPacket)
+	{
+		Projectile& projectile = m_projectiles[createPacket.projectileId];
+		projectile.linearVelocity = createPacket.linearVelocity;
+		projectile.position = createPacket.position;
+		projectile.spawnTime = createPacket.spawnTime;
+
+		projectile.entity = m_prefabs[createPacket.prefabId]->Clone();
+		projectile.entity->RemoveComponent<Ndk::PhysicsComponent3D>(); //< Projectiles don't interact with client physics
+
+		auto& entityNode = projectile.entity->GetComponent<Ndk::NodeComponent>();
+		entityNode.SetPosition(createPacket.position);
+		entityNode.SetRotation(createPacket.rotation);
+
+		if (projectile.entity->HasComponent<SoundEmitterComponent>())
+		{
+			auto& soundEmitter = projectile.entity->GetComponent<SoundEmitterComponent>();
+			soundEmitter.Play();
+		}
+	}
+
 	void ServerMatchEntities::OnDeleteEntity(ServerConnection*, const Packets::DeleteEntity& deletePacket)
 	{
 		ServerEntity& data = GetServerEntity(deletePacket.id);
@@ -414,6 +454,11 @@ namespace ewn
 		OnEntityDelete(this, data);
 	}
 
+	void ServerMatchEntities::OnDeleteProjectile(ServerConnection*, const Packets::DeleteProjectile& deletePacket)
+	{
+		m_projectiles.erase(deletePacket.projectileId); //< Entity owner kills the entity
+	}
+
 	void ServerMatchEntities::OnPlaySound(ServerConnection* server, const Packets::PlaySound& playSound)
 	{
 		Nz::Sound& sound = m_playingSounds.emplace_back();
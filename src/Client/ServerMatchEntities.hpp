@@ -18,6 +18,7 @@
 #include <Client/ServerConnection.hpp>
 #include <nonstd/ring_span.hpp>
 #include <array>
+#include <unordered_map>
 #include <vector>
 
 namespace ewn
@@ -38,6 +39,7 @@ namespace ewn
 
 			inline ServerEntity& GetServerEntity(std::size_t id);
 			inline std::size_t GetServerEntityCount() const;
+			inline Nz::UInt64 GetSnapshotDelay() const;
 			inline bool IsSnapshotHandlingEnabled() const;
 			inline bool IsServerEntityValid(std::size_t id) const;
 
@@ -67,16 +69,28 @@ namespace ewn
 			inline ServerEntity& CreateServerEntity(Nz::UInt32 id);
 			void FillVisualEffectFactory();
 			void HandlePlayingSounds();
+			void UpdateProjectiles();
 
 			void OnArenaPrefabs(ServerConnection* server, const Packets::ArenaPrefabs& arenaPrefabs);
 			void OnArenaSounds(ServerConnection* server, const Packets::ArenaSounds& arenaSounds);
 			void OnArenaState(ServerConnection* server, const Packets::ArenaState& arenaState);
 			void OnCreateEntity(ServerConnection* server, const Packets::CreateEntity& createPacket);
+			void OnCreateProjectile(ServerConnection* server, const Packets::CreateProjectile& createPacket);
 			void OnDeleteEntity(ServerConnection* server, const Packets::DeleteEntity& deletePacket);
+			void OnDeleteProjectile(ServerConnection* server, const Packets::DeleteProjectile& deletePacket);
 			void OnPlaySound(ServerConnection* server, const Packets::PlaySound& playSound);
 
 			void ApplySnapshot(const Snapshot& snapshot);
 
+			// Projectiles move in a straight line, they are simulated from their spawn event instead of snapshots
+			struct Projectile
+			{
+				Ndk::EntityOwner entity;
+				Nz::UInt64 spawnTime;
+				Nz::Vector3f linearVelocity;
+				Nz::Vector3f position;
+			};
+
 			struct Snapshot
 			{
 				struct Entity
@@ -93,18 +107,21 @@ namespace ewn
 				std::vector<Entity> entities;
 			};
 
-			NazaraSlot(ServerConnection, OnArenaPrefabs, m_onArenaPrefabsSlot);
-			NazaraSlot(ServerConnection, OnArenaSounds,  m_onArenaSoundsSlot);
-			NazaraSlot(ServerConnection, OnArenaState,   m_onArenaStateSlot);
-			NazaraSlot(ServerConnection, OnCreateEntity, m_onCreateEntitySlot);
-			NazaraSlot(ServerConnection, OnDeleteEntity, m_onDeleteEntitySlot);
-			NazaraSlot(ServerConnection, OnPlaySound,    m_onPlaySoundSlot);
+			NazaraSlot(ServerConnection, OnArenaPrefabs,     m_onArenaPrefabsSlot);
+			NazaraSlot(ServerConnection, OnArenaSounds,      m_onArenaSoundsSlot);
+			NazaraSlot(ServerConnection, OnArenaState,       m_onArenaStateSlot);
+			NazaraSlot(ServerConnection, OnCreateEntity,     m_onCreateEntitySlot);
+			NazaraSlot(ServerConnection, OnCreateProjectile, m_onCreateProjectileSlot);
+			NazaraSlot(ServerConnection, OnDeleteEntity,     m_onDeleteEntitySlot);
+			NazaraSlot(ServerConnection, OnDeleteProjectile, m_onDeleteProjectileSlot);
+			NazaraSlot(ServerConnection, OnPlaySound,        m_onPlaySoundSlot);
 
 			using PrefabFactoryFunction = std::function<void(ClientApplication* app, const Ndk::EntityHandle& entity)>;
 
 			std::array<Snapshot, 5> m_jitterBufferData;
 			nonstd::ring_span<Snapshot> m_jitterBuffer;
 			std::unordered_map<std::string, PrefabFactoryFunction> m_visualEffectFactory;
+			std::unordered_map<Nz::UInt32, Projectile> m_projectiles;
 			std::vector<Ndk::EntityOwner> m_prefabs;
 			std::vector<Nz::Sound> m_playingSounds;
 			std::vector<Nz::SoundBufferRef> m_soundLibrary;
@@ -36,6 +36,11 @@ namespace ewn
 		return m_serverEntities.size();
 	}
 
+	inline Nz::UInt64 ServerMatchEntities::GetSnapshotDelay() const
+	{
+		return m_snapshotDelay;
+	}
+
 	inline bool ServerMatchEntities::IsSnapshotHandlingEnabled() const
 	{
 		return m_stateHandlingEnabled;
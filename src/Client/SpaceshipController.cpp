@@ -12,11 +12,13 @@
 #include <Client/ClientApplication.hpp>
 #include <Client/MatchChatbox.hpp>
 #include <Client/ServerMatchEntities.hpp>
+#include <algorithm>
 #include <string>
 
 namespace ewn
 {
 	SpaceshipController::SpaceshipController(ClientApplication* app, ServerConnection* server, Nz::RenderWindow& window, Ndk::World& world2D, MatchChatbox& chatbox, ServerMatchEntities& entities, const Ndk::EntityHandle& camera, const Ndk::EntityHandle& spaceship) :
+	m_pendingInputCount(0),
 	m_app(app),
 	m_chatbox(chatbox),
 	m_entities(entities),
@@ -25,6 +27,8 @@ namespace ewn
 	m_window(window),
 	m_camera(camera),
 	m_spaceship(spaceship),
+	m_inputHistory(m_inputHistoryData.begin(), m_inputHistoryData.end()),
+	m_lastInputTime(0),
 	m_lastShootTime(0),
 	m_executeScript(false),
 	m_inputAccumulator(0.f)
@@ -64,11 +68,11 @@ namespace ewn
 		// Update and send input
 		m_inputAccumulator += elapsedTime;
 
-		constexpr float inputSendInterval = 1.f / 60.f;
-		if (m_inputAccumulator > inputSendInterval)
+		constexpr float inputSampleInterval = 1.f / 60.f;
+		if (m_inputAccumulator > inputSampleInterval)
 		{
-			m_inputAccumulator -= inputSendInterval;
-			UpdateInput(inputSendInterval);
+			m_inputAccumulator -= inputSampleInterval;
+			UpdateInput(inputSampleInterval);
 		}
 
 		if (m_executeScript)
@@ -732,6 +736,32 @@ namespace ewn
 		}
 	}
 
+	void SpaceshipController::SendInputs()
+	{
+		if (m_inputHistory.empty())
+			return;
+
+		// Send every input we have in history, as movement packets are unreliable the server will discard already received inputs
+		Packets::PlayerMovement movementPacket;
+		movementPacket.inputTime = m_inputHistory.front().inputTime;
+		movementPacket.inputs.reserve(m_inputHistory.size());
+
+		Nz::UInt64 previousTime = movementPacket.inputTime;
+		for (const InputData& inputData : m_inputHistory)
+		{
+			auto& input = movementPacket.inputs.emplace_back();
+			input.timeDelta = static_cast<Nz::UInt32>(inputData.inputTime - previousTime);
+			input.direction = inputData.movement;
+			input.rotation = inputData.rotation;
+
+			previousTime = inputData.inputTime;
+		}
+
+		m_server->SendPacket(movementPacket);
+
+		m_pendingInputCount = 0;
+	}
+
 	void SpaceshipController::Shoot()
 	{
 		Nz::UInt64 currentTime = ClientApplication::GetAppTime();
@@ -741,7 +771,11 @@ namespace ewn
 		m_lastShootTime = currentTime;
 		m_shootSound.Play();
 
-		m_server->SendPacket(Packets::PlayerShoot());
+		// Other entities are displayed with a delay, the server needs it to rewind them to what we were seeing
+		Packets::PlayerShoot shootPacket;
+		shootPacket.renderDelay = static_cast<Nz::UInt32>(m_entities.GetSnapshotDelay());
+
+		m_server->SendPacket(shootPacket);
 	}
 
 	void SpaceshipController::UpdateInput(float elapsedTime)
@@ -774,13 +808,20 @@ namespace ewn
 					return;
 				}
 
-				// Send input to server
-				Packets::PlayerMovement movementPacket;
-				movementPacket.inputTime = m_server->EstimateServerTime();
-				movementPacket.direction = movement;
-				movementPacket.rotation = rotation;
+				// Time sync corrections may move the server time estimation backwards, inputs times have to keep increasing (the server ignores older inputs)
+				m_lastInputTime = std::max(m_lastInputTime + 1, m_server->EstimateServerTime());
+
+				InputData inputData;
+				inputData.inputTime = m_lastInputTime;
+				inputData.movement = movement;
+				inputData.rotation = rotation;
+
+				m_inputHistory.push_back(std::move(inputData));
 
-				m_server->SendPacket(movementPacket);
+				// Batch inputs to lower packet rate
+				constexpr std::size_t inputBatchSize = 2;
+				if (++m_pendingInputCount >= inputBatchSize)
+					SendInputs();
 			}
 			else
 				std::cerr << "UpdateInput failed: " << m_controlScript.GetLastError() << std::endl;
@@ -15,6 +15,8 @@
 #include <NDK/EntityOwner.hpp>
 #include <Shared/Protocol/Packets.hpp>
 #include <Client/ServerConnection.hpp>
+#include <nonstd/ring_span.hpp>
+#include <array>
 
 namespace ewn
 {
@@ -36,6 +38,13 @@ namespace ewn
 			SpaceshipController& operator=(SpaceshipController&&) = delete;
 
 		private:
+			struct InputData
+			{
+				Nz::UInt64 inputTime;
+				Nz::Vector3f movement;
+				Nz::Vector3f rotation;
+			};
+
 			struct Sprite
 			{
 				Ndk::EntityOwner entity;
@@ -60,6 +69,7 @@ namespace ewn
 
 			void LoadScript();
 			void LoadSprites(Ndk::World& world2D);
+			void SendInputs();
 			void Shoot();
 			void UpdateInput(float elapsedTime);
 
@@ -73,6 +83,8 @@ namespace ewn
 			NazaraSlot(Nz::EventHandler, OnMouseMoved, m_onMouseMovedSlot);
 			NazaraSlot(Nz::RenderTarget, OnRenderTargetSizeChange, m_onTargetChangeSizeSlot);
 
+			std::array<InputData, 6> m_inputHistoryData;
+			std::size_t m_pendingInputCount;
 			std::vector<Sprite> m_sprites;
 			ClientApplication* m_app;
 			MatchChatbox& m_chatbox;
@@ -84,10 +96,12 @@ namespace ewn
 			Ndk::EntityOwner m_cursorEntity;
 			Ndk::EntityOwner m_healthBarEntity;
 			Ndk::EntityHandle m_spaceship;
+			nonstd::ring_span<InputData> m_inputHistory;
 			Nz::LuaInstance m_controlScript;
 			Nz::SpriteRef m_cursorOrientationSprite;
 			Nz::SpriteRef m_healthBarSprite;
 			Nz::Sound m_shootSound;
+			Nz::UInt64 m_lastInputTime;
 			Nz::UInt64 m_lastShootTime;
 			Nz::Vector3f m_cameraRotation;
 			bool m_executeScript;
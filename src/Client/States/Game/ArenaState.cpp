@@ -50,6 +50,10 @@ namespace ewn
 		m_controlledEntity = std::numeric_limits<decltype(m_controlledEntity)>::max();
 		m_isDisconnected = !stateData.server->IsConnected();
 
+		m_onAdmissionQueuePositionSlot.Connect(stateData.server->OnAdmissionQueuePosition, [this](ServerConnection*, const Packets::AdmissionQueuePosition& queuePosition)
+		{
+			m_chatbox->PrintMessage("Arena is busy, position in queue: " + std::to_string(static_cast<Nz::UInt32>(queuePosition.position)));
+		});
 		m_onControlEntitySlot.Connect(stateData.server->OnControlEntity, this, &ArenaState::OnControlEntity);
 		m_onKeyPressedSlot.Connect(stateData.window->GetEventHandler().OnKeyPressed, this, &ArenaState::OnKeyPressed);
 
@@ -68,6 +72,7 @@ namespace ewn
 	{
 		AbstractState::Leave(fsm);
 
+		m_onAdmissionQueuePositionSlot.Disconnect();
 		m_onControlEntitySlot.Disconnect();
 		m_onKeyPressedSlot.Disconnect();
 
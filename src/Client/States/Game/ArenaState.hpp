@@ -41,6 +41,7 @@ namespace ewn
 			void OnEntityDelete(ServerMatchEntities* entities, ServerMatchEntities::ServerEntity& entityData);
 			void OnKeyPressed(const Nz::EventHandler* eventHandler, const Nz::WindowEvent::KeyEvent& event);
 
+			NazaraSlot(ServerConnection,    OnAdmissionQueuePosition, m_onAdmissionQueuePositionSlot);
 			NazaraSlot(ServerConnection,    OnControlEntity, m_onControlEntitySlot);
 			NazaraSlot(ServerMatchEntities, OnEntityCreated, m_onEntityCreatedSlot);
 			NazaraSlot(ServerMatchEntities, OnEntityDelete, m_onEntityDeletionSlot);
@@ -102,6 +102,11 @@ namespace ewn
 		m_connectionButton->SetSize({ maxButtonWidth, m_connectionButton->GetSize().y });
 		m_registerButton->SetSize({ maxButtonWidth, m_registerButton->GetSize().y });
 
+		m_onAdmissionQueuePositionSlot.Connect(stateData.server->OnAdmissionQueuePosition, [this](ServerConnection* connection, const Packets::AdmissionQueuePosition& queuePosition)
+		{
+			UpdateStatus("Server is busy, position in queue: " + Nz::String::Number(static_cast<Nz::UInt32>(queuePosition.position)), Nz::Color::Yellow);
+		});
+
 		m_onLoginFailureSlot.Connect(stateData.server->OnLoginFailure, [this](ServerConnection* connection, const Packets::LoginFailure& loginFailure)
 		{
 			std::string reason;
@@ -156,6 +161,7 @@ namespace ewn
 	{
 		AbstractState::Leave(fsm);
 
+		m_onAdmissionQueuePositionSlot.Disconnect();
 		m_onConnectedSlot.Disconnect();
 		m_onDisconnectedSlot.Disconnect();
 		m_onLoginFailureSlot.Disconnect();
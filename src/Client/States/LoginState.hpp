@@ -39,6 +39,7 @@ namespace ewn
 
 			void UpdateStatus(const Nz::String& status, const Nz::Color& color = Nz::Color::White);
 
+			NazaraSlot(ServerConnection, OnAdmissionQueuePosition, m_onAdmissionQueuePositionSlot);
 			NazaraSlot(ServerConnection, OnConnected,    m_onConnectedSlot);
 			NazaraSlot(ServerConnection, OnDisconnected, m_onDisconnectedSlot);
 			NazaraSlot(ServerConnection, OnLoginFailure, m_onLoginFailureSlot);
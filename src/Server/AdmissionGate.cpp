@@ -0,0 +1,105 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/AdmissionGate.hpp>
+#include <Server/Player.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	void AdmissionGate::Enter(Player* player, Callback callback)
+	{
+		if (IsAdmitted(player))
+		{
+			callback();
+			return;
+		}
+
+		auto it = std::find_if(m_queue.begin(), m_queue.end(), [player](const PendingPlayer& pending) { return pending.player == player; });
+		if (it != m_queue.end())
+		{
+			it->callbacks.emplace_back(std::move(callback));
+			return;
+		}
+
+		if (m_queue.empty() && HasFreeSlot())
+		{
+			m_admittedPlayers.insert(player);
+			callback();
+			return;
+		}
+
+		PendingPlayer& pending = m_queue.emplace_back();
+		pending.player = player;
+		pending.callbacks.emplace_back(std::move(callback));
+
+		Packets::AdmissionQueuePosition queuePosition;
+		queuePosition.stage = m_stage;
+		queuePosition.position = Nz::UInt32(m_queue.size());
+
+		player->SendPacket(queuePosition);
+	}
+
+	bool AdmissionGate::IsQueued(Player* player) const
+	{
+		return std::find_if(m_queue.begin(), m_queue.end(), [player](const PendingPlayer& pending) { return pending.player == player; }) != m_queue.end();
+	}
+
+	void AdmissionGate::Leave(Player* player)
+	{
+		if (m_admittedPlayers.erase(player) > 0)
+			return;
+
+		auto it = std::find_if(m_queue.begin(), m_queue.end(), [player](const PendingPlayer& pending) { return pending.player == player; });
+		if (it != m_queue.end())
+		{
+			m_queue.erase(it);
+			m_queueChanged = true;
+		}
+	}
+
+	void AdmissionGate::RunWhenAdmitted(Player* player, Callback callback)
+	{
+		// Keep player actions ordered: if the player is waiting in this stage, run the callback once it gets admitted
+		auto it = std::find_if(m_queue.begin(), m_queue.end(), [player](const PendingPlayer& pending) { return pending.player == player; });
+		if (it != m_queue.end())
+			it->callbacks.emplace_back(std::move(callback));
+		else
+			callback();
+	}
+
+	void AdmissionGate::Update()
+	{
+		while (!m_queue.empty() && HasFreeSlot())
+		{
+			PendingPlayer pending = std::move(m_queue.front());
+			m_queue.pop_front();
+
+			m_admittedPlayers.insert(pending.player);
+			m_queueChanged = true;
+
+			for (const Callback& callback : pending.callbacks)
+				callback();
+		}
+
+		if (m_queueChanged)
+		{
+			SendQueuePositions();
+			m_queueChanged = false;
+		}
+	}
+
+	void AdmissionGate::SendQueuePositions()
+	{
+		Packets::AdmissionQueuePosition queuePosition;
+		queuePosition.stage = m_stage;
+
+		Nz::UInt32 position = 1;
+		for (const PendingPlayer& pending : m_queue)
+		{
+			queuePosition.position = position++;
+			pending.player->SendPacket(queuePosition);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_ADMISSIONGATE_HPP
+#define EREWHON_SERVER_ADMISSIONGATE_HPP
+
+#include <Shared/Enums.hpp>
+#include <deque>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+namespace ewn
+{
+	class Player;
+
+	// Limits how many players can be in a connection stage at once, the others wait in a FIFO queue
+	class AdmissionGate
+	{
+		public:
+			using Callback = std::function<void()>;
+
+			inline AdmissionGate(AdmissionStage stage);
+			AdmissionGate(const AdmissionGate&) = delete;
+			AdmissionGate(AdmissionGate&&) = delete;
+			~AdmissionGate() = default;
+
+			void Enter(Player* player, Callback callback);
+
+			inline std::size_t GetAdmittedCount() const;
+			inline std::size_t GetLimit() const;
+			inline std::size_t GetQueueSize() const;
+
+			inline bool IsAdmitted(Player* player) const;
+			bool IsQueued(Player* player) const;
+
+			void Leave(Player* player);
+
+			inline void ReleaseAll();
+
+			void RunWhenAdmitted(Player* player, Callback callback);
+
+			inline void SetLimit(std::size_t limit);
+
+			void Update();
+
+			AdmissionGate& operator=(const AdmissionGate&) = delete;
+			AdmissionGate& operator=(AdmissionGate&&) = delete;
+
+		private:
+			inline bool HasFreeSlot() const;
+			void SendQueuePositions();
+
+			struct PendingPlayer
+			{
+				Player* player;
+				std::vector<Callback> callbacks;
+			};
+
+			std::deque<PendingPlayer> m_queue;
+			std::size_t m_limit;
+			std::unordered_set<Player*> m_admittedPlayers;
+			AdmissionStage m_stage;
+			bool m_queueChanged;
+	};
+}
+
+#include <Server/AdmissionGate.inl>
+
+#endif // EREWHON_SERVER_ADMISSIONGATE_HPP
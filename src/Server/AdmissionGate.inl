@@ -0,0 +1,51 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/AdmissionGate.hpp>
+
+namespace ewn
+{
+	inline AdmissionGate::AdmissionGate(AdmissionStage stage) :
+	m_limit(0),
+	m_stage(stage),
+	m_queueChanged(false)
+	{
+	}
+
+	inline std::size_t AdmissionGate::GetAdmittedCount() const
+	{
+		return m_admittedPlayers.size();
+	}
+
+	inline std::size_t AdmissionGate::GetLimit() const
+	{
+		return m_limit;
+	}
+
+	inline std::size_t AdmissionGate::GetQueueSize() const
+	{
+		return m_queue.size();
+	}
+
+	inline bool AdmissionGate::IsAdmitted(Player* player) const
+	{
+		return m_admittedPlayers.find(player) != m_admittedPlayers.end();
+	}
+
+	inline void AdmissionGate::ReleaseAll()
+	{
+		// Used by stages limited per server update rather than by duration
+		m_admittedPlayers.clear();
+	}
+
+	inline void AdmissionGate::SetLimit(std::size_t limit)
+	{
+		m_limit = limit;
+	}
+
+	inline bool AdmissionGate::HasFreeSlot() const
+	{
+		return m_limit == 0 || m_admittedPlayers.size() < m_limit; //< 0 means no limit
+	}
+}
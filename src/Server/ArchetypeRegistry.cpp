@@ -0,0 +1,150 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ArchetypeRegistry.hpp>
+#include <Nazara/Math/EulerAngles.hpp>
+#include <Shared/Protocol/NetworkStringStore.hpp>
+#include <cassert>
+
+namespace ewn
+{
+	ArchetypeRegistry::ArchetypeRegistry()
+	{
+		// Earth
+		{
+			Archetype earth;
+			earth.collider = Nz::SphereCollider3D::New(50.f);
+			earth.type = "earth";
+			earth.visualEffects.emplace_back().effectName = "earth";
+
+			Register(std::move(earth));
+		}
+
+		// Light
+		{
+			Archetype light;
+			light.type = "light";
+			light.visualEffects.emplace_back().effectName = "light";
+
+			Register(std::move(light));
+		}
+
+		// Plasma beam (projectile engine only)
+		{
+			Archetype plasmaBeam;
+			plasmaBeam.isMovable = true;
+			plasmaBeam.type = "plasmabeam";
+			plasmaBeam.visualEffects.emplace_back().effectName = "plasmabeam";
+
+			Register(std::move(plasmaBeam));
+		}
+
+		// Torpedo (projectile engine only)
+		{
+			Archetype torpedo;
+			torpedo.isMovable = true;
+			torpedo.type = "torpedo";
+			torpedo.visualEffects.emplace_back().effectName = "torpedo";
+
+			Register(std::move(torpedo));
+		}
+
+		// Ball
+		{
+			constexpr float radius = 18.251904f / 2.f;
+
+			Archetype ball;
+			ball.collider = Nz::SphereCollider3D::New(radius);
+			ball.isMovable = true;
+			ball.models.emplace_back().filePath = "ball/ball.obj";
+			ball.networkPriority = 3;
+			ball.type = "ball";
+
+			auto& physics = ball.physics.emplace();
+			physics.linearDamping = 0.05f;
+			physics.mass = 100.f;
+
+			Register(std::move(ball));
+		}
+
+		// Spaceship (collider depends on the hull)
+		{
+			Archetype spaceship;
+			spaceship.isMovable = true;
+			spaceship.networkPriority = 5;
+			spaceship.type = "spaceship";
+
+			auto& model = spaceship.models.emplace_back();
+			model.filePath = "spaceship/spaceship.obj";
+			model.rotation = Nz::EulerAnglesf(0.f, 90.f, 0.f);
+			model.scale = Nz::Vector3f(0.01f);
+
+			auto& physics = spaceship.physics.emplace();
+			physics.angularDamping = Nz::Vector3f(0.4f);
+			physics.linearDamping = 0.25f;
+			physics.mass = 42.f;
+
+			Register(std::move(spaceship));
+		}
+	}
+
+	void ArchetypeRegistry::BuildPrefabsPacket(const NetworkStringStore& stringStore, Packets::ArenaPrefabs& prefabsPacket) const
+	{
+		prefabsPacket.startId = 0;
+		prefabsPacket.prefabs.clear();
+		prefabsPacket.prefabs.reserve(m_archetypes.size());
+
+		for (const Archetype& archetype : m_archetypes)
+		{
+			auto& prefab = prefabsPacket.prefabs.emplace_back();
+
+			for (const Archetype::Model& model : archetype.models)
+			{
+				auto& modelData = prefab.models.emplace_back();
+				modelData.modelId = stringStore.GetStringIndex(model.filePath);
+				modelData.position = model.position;
+				modelData.rotation = model.rotation;
+				modelData.scale = model.scale;
+			}
+
+			for (const Archetype::VisualEffect& visualEffect : archetype.visualEffects)
+			{
+				auto& visualEffectData = prefab.visualEffects.emplace_back();
+				visualEffectData.effectNameId = stringStore.GetStringIndex(visualEffect.effectName);
+				visualEffectData.position = visualEffect.position;
+				visualEffectData.rotation = visualEffect.rotation;
+				visualEffectData.scale = visualEffect.scale;
+			}
+		}
+	}
+
+	std::size_t ArchetypeRegistry::GetArchetypeId(const std::string& type) const
+	{
+		auto it = m_archetypeIds.find(type);
+		if (it == m_archetypeIds.end())
+			return InvalidArchetypeId;
+
+		return it->second;
+	}
+
+	void ArchetypeRegistry::RegisterNetworkStrings(NetworkStringStore& stringStore) const
+	{
+		for (const Archetype& archetype : m_archetypes)
+		{
+			for (const Archetype::Model& model : archetype.models)
+				stringStore.RegisterString(model.filePath);
+
+			for (const Archetype::VisualEffect& visualEffect : archetype.visualEffects)
+				stringStore.RegisterString(visualEffect.effectName);
+		}
+	}
+
+	void ArchetypeRegistry::Register(Archetype archetype)
+	{
+		assert(m_archetypeIds.find(archetype.type) == m_archetypeIds.end());
+		m_archetypeIds.emplace(archetype.type, m_archetypes.size());
+
+		m_archetypes.emplace_back(std::move(archetype));
+	}
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_ARCHETYPEREGISTRY_HPP
+#define EREWHON_SERVER_ARCHETYPEREGISTRY_HPP
+
+#include <Nazara/Math/Quaternion.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <Shared/Protocol/Packets.hpp>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ewn
+{
+	class NetworkStringStore;
+
+	// Every kind of entity (and projectile) arenas can spawn, built once and shared (read-only) by every arena
+	// Archetype ids are also the network prefab ids
+	class ArchetypeRegistry
+	{
+		public:
+			struct Archetype;
+
+			ArchetypeRegistry();
+			ArchetypeRegistry(const ArchetypeRegistry&) = delete;
+			ArchetypeRegistry(ArchetypeRegistry&&) = delete;
+			~ArchetypeRegistry() = default;
+
+			void BuildPrefabsPacket(const NetworkStringStore& stringStore, Packets::ArenaPrefabs& prefabsPacket) const;
+
+			inline const Archetype& GetArchetype(std::size_t archetypeId) const;
+			inline std::size_t GetArchetypeCount() const;
+			std::size_t GetArchetypeId(const std::string& type) const;
+
+			void RegisterNetworkStrings(NetworkStringStore& stringStore) const;
+
+			ArchetypeRegistry& operator=(const ArchetypeRegistry&) = delete;
+			ArchetypeRegistry& operator=(ArchetypeRegistry&&) = delete;
+
+			static constexpr std::size_t InvalidArchetypeId = std::numeric_limits<std::size_t>::max();
+
+			struct Archetype
+			{
+				struct Model
+				{
+					std::string filePath;
+					Nz::Quaternionf rotation = Nz::Quaternionf::Identity();
+					Nz::Vector3f position = Nz::Vector3f::Zero();
+					Nz::Vector3f scale = Nz::Vector3f::Unit();
+				};
+
+				struct Physics
+				{
+					std::optional<Nz::Vector3f> angularDamping;
+					float linearDamping;
+					float mass;
+				};
+
+				struct VisualEffect
+				{
+					std::string effectName;
+					Nz::Quaternionf rotation = Nz::Quaternionf::Identity();
+					Nz::Vector3f position = Nz::Vector3f::Zero();
+					Nz::Vector3f scale = Nz::Vector3f::Unit();
+				};
+
+				std::optional<Physics> physics; //< Rigid body parameters, no rigid body if empty
+				std::string type;
+				std::vector<Model> models;
+				std::vector<VisualEffect> visualEffects;
+				Nz::Collider3DRef collider; //< Shared by every instance, may be null
+				Nz::UInt16 networkPriority = 0;
+				bool isMovable = false;
+			};
+
+		private:
+			void Register(Archetype archetype);
+
+			std::unordered_map<std::string, std::size_t> m_archetypeIds;
+			std::vector<Archetype> m_archetypes;
+	};
+}
+
+#include <Server/ArchetypeRegistry.inl>
+
+#endif // EREWHON_SERVER_ARCHETYPEREGISTRY_HPP
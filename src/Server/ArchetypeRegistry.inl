@@ -0,0 +1,20 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ArchetypeRegistry.hpp>
+#include <cassert>
+
+namespace ewn
+{
+	inline const ArchetypeRegistry::Archetype& ArchetypeRegistry::GetArchetype(std::size_t archetypeId) const
+	{
+		assert(archetypeId < m_archetypes.size());
+		return m_archetypes[archetypeId];
+	}
+
+	inline std::size_t ArchetypeRegistry::GetArchetypeCount() const
+	{
+		return m_archetypes.size();
+	}
+}
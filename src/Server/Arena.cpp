@@ -3,7 +3,6 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Arena.hpp>
-#include <Nazara/Physics3D/PhysWorld3D.hpp>
 #include <NDK/Components/CollisionComponent3D.hpp>
 #include <NDK/Components/NodeComponent.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
@@ -13,57 +12,89 @@
 #include <Server/Components/ArenaComponent.hpp>
 #include <Server/Components/HealthComponent.hpp>
 #include <Server/Components/InputComponent.hpp>
-#include <Server/Components/LifeTimeComponent.hpp>
 #include <Server/Components/NavigationComponent.hpp>
 #include <Server/Components/OwnerComponent.hpp>
 #include <Server/Components/PlayerControlledComponent.hpp>
-#include <Server/Components/ProjectileComponent.hpp>
 #include <Server/Components/RadarComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
 #include <Server/Systems/BroadcastSystem.hpp>
 #include <Server/Systems/LifeTimeSystem.hpp>
 #include <Server/Systems/NavigationSystem.hpp>
+#include <Server/Systems/PhysicsActivitySystem.hpp>
+#include <Server/Systems/RadarSystem.hpp>
 #include <Server/Systems/ScriptSystem.hpp>
+#include <Server/Systems/SpatialIndexSystem.hpp>
 #include <Server/Systems/SpaceshipSystem.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <algorithm>
 #include <cassert>
+#include <iostream>
 
 namespace ewn
 {
 	static constexpr bool sendServerGhosts = false;
 
 	Arena::Arena(ServerApplication* app) :
+	m_systemScheduler(*this, m_world, app->GetTaskPool()),
+	m_projectileEngine(this),
+	m_running(true),
+	m_entityCount(0),
+	m_assignedPlayerCount(0),
+	m_leavingPlayerCount(0),
 	m_app(app),
-	m_stateBroadcastAccumulator(0.f)
+	m_taskPool(app->GetTaskPool()),
+	m_lastSkippedTicksReport(0),
+	m_skippedTicks(0),
+	m_tick(0),
+	m_tickTimeOrigin(ServerApplication::GetAppTime()),
+	m_tickAccumulator(0.f)
 	{
-		auto& broadcastSystem = m_world.AddSystem<BroadcastSystem>();
+		auto& broadcastSystem = m_world.AddSystem<BroadcastSystem>(this);
 		broadcastSystem.BroadcastEntityCreation.Connect(this,    &Arena::OnBroadcastEntityCreation);
 		broadcastSystem.BroadcastEntityDestruction.Connect(this, &Arena::OnBroadcastEntityDestruction);
 		broadcastSystem.BroadcastStateUpdate.Connect(this,       &Arena::OnBroadcastStateUpdate);
 
 		if (sendServerGhosts)
-			broadcastSystem.SetMaximumUpdateRate(60.f);
+			broadcastSystem.SetTickInterval(1);
 
-		m_world.AddSystem<LifeTimeSystem>();
-		m_world.AddSystem<NavigationSystem>();
+		m_world.AddSystem<LifeTimeSystem>(this);
+		m_world.AddSystem<NavigationSystem>(this);
+		m_world.AddSystem<PhysicsActivitySystem>(this);
+		m_world.AddSystem<RadarSystem>(this);
 		m_world.AddSystem<ScriptSystem>(m_app, this);
-		m_world.AddSystem<SpaceshipSystem>();
-
-		Nz::PhysWorld3D& world = m_world.GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
-		int defaultMaterial = world.GetMaterial("default");
-		m_plasmaMaterial = world.CreateMaterial("plasma");
-		m_torpedoMaterial = world.CreateMaterial("torpedo");
-
-		world.SetMaterialCollisionCallback(defaultMaterial, m_plasmaMaterial, nullptr, [this](const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody)
-		{
-			return HandlePlasmaProjectileCollision(firstBody, secondBody);
-		});
-
-		world.SetMaterialCollisionCallback(defaultMaterial, m_torpedoMaterial, nullptr, [this](const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody)
-		{
-			return HandleTorpedoProjectileCollision(firstBody, secondBody);
-		});
-
+		m_world.AddSystem<SpaceshipSystem>(this);
+		m_world.AddSystem<SpatialIndexSystem>(this);
+		m_world.AddSystem<TransformSnapshotSystem>();
+
+		// Systems are updated by the scheduler instead of the world, independent systems are run in parallel
+		// Spaceship is registered before Script (which runs alone) so it can share its stage with Navigation
+		m_systemScheduler.AddSystem<BroadcastSystem>();
+		m_systemScheduler.AddSystem<LifeTimeSystem>();
+		m_systemScheduler.AddSystem<NavigationSystem>();
+		m_systemScheduler.AddSystem<PhysicsActivitySystem>();
+		m_systemScheduler.AddSystem<RadarSystem>();
+		m_systemScheduler.AddSystem<SpaceshipSystem>();
+		m_systemScheduler.AddSystem<ScriptSystem>();
+		m_systemScheduler.AddSystem<SpatialIndexSystem>();
+		m_systemScheduler.AddSystem<TransformSnapshotSystem>();
+
+		// Registered last so it steps bodies after every force of the tick was applied (other default NDK systems are unused by the server)
+		// The Newton step itself stays serial: PhysWorld3D doesn't expose Newton's thread count, and the step is a fraction of the tick once sleeping bodies are skipped
+		SystemAccess physicsAccess;
+		physicsAccess.Read<Ndk::CollisionComponent3D>();
+		physicsAccess.Write<Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
+
+		m_systemScheduler.AddSystem<Ndk::PhysicsSystem3D>(physicsAccess);
+
+		m_projectileEngine.OnProjectileCreated.Connect(this,   &Arena::OnProjectileCreated);
+		m_projectileEngine.OnProjectileDestroyed.Connect(this, &Arena::OnProjectileDestroyed);
+
+		// Archetypes spawned often are looked up once
+		const ArchetypeRegistry& archetypes = m_app->GetArchetypeRegistry();
+		m_plasmaBeamArchetype = archetypes.GetArchetypeId("plasmabeam");
+		m_spaceshipArchetype = archetypes.GetArchetypeId("spaceship");
+		m_torpedoArchetype = archetypes.GetArchetypeId("torpedo");
 
 		Reset();
 
@@ -72,10 +103,17 @@ namespace ewn
 			m_debugSocket.Create(Nz::NetProtocol_IPv4);
 			m_debugSocket.EnableBroadcasting(true);
 		}
+
+		m_thread = Nz::Thread(&Arena::WorkerThread, this);
+		m_thread.SetName("Arena");
 	}
 
 	Arena::~Arena()
 	{
+		m_running.store(false, std::memory_order_release);
+		RegisterCallback([]() {}); //< Wake up the arena thread if it's hibernating
+		m_thread.Join();
+
 		m_world.Clear();
 	}
 
@@ -89,26 +127,36 @@ namespace ewn
 		return spaceship;
 	}
 
-	const Ndk::EntityHandle& Arena::CreatePlasmaProjectile(Player* owner, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
+	// shooterViewTime is the server time the shooter was seeing when firing, hits are then checked against past positions (zero disables lag compensation)
+	void Arena::CreatePlasmaProjectile(const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, Nz::UInt64 shooterViewTime)
 	{
-		const Ndk::EntityHandle& projectile = CreateEntity("plasmabeam", {}, owner, position, rotation);
-		projectile->GetComponent<ProjectileComponent>().MarkAsHit(emitter);
-
-		auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
-		projectilePhys.SetLinearVelocity(emitter->GetComponent<Ndk::NodeComponent>().GetForward() * 250.f);
+		ProjectileEngine::ProjectileInfo plasmaInfo;
+		plasmaInfo.damage = Nz::UInt16(50 + ((GetCurrentTime() % 21) - 10)); //< Aléatoire du pauvre
+		plasmaInfo.lifeTime = 10.f;
+		plasmaInfo.prefabId = static_cast<Nz::UInt32>(m_plasmaBeamArchetype);
+		plasmaInfo.radius = 0.5f;
+
+		Nz::UInt32 rewindTicks = 0;
+		if (shooterViewTime != 0)
+		{
+			Nz::UInt64 viewTick = GetTickAt(shooterViewTime);
+			if (viewTick < m_tick)
+				rewindTicks = static_cast<Nz::UInt32>(std::min<Nz::UInt64>(m_tick - viewTick, SpatialIndexSystem::HistoryTickCount - 1));
+		}
 
-		return projectile;
+		m_projectileEngine.Spawn(plasmaInfo, emitter, position, rotation, emitter->GetComponent<Ndk::NodeComponent>().GetForward() * 250.f, rewindTicks);
 	}
 
-	const Ndk::EntityHandle& Arena::CreateTorpedo(Player * owner, const Ndk::EntityHandle & emitter, const Nz::Vector3f & position, const Nz::Quaternionf & rotation)
+	void Arena::CreateTorpedo(const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
 	{
-		const Ndk::EntityHandle& projectile = CreateEntity("torpedo", {}, owner, position, rotation);
-		projectile->GetComponent<ProjectileComponent>().MarkAsHit(emitter);
-
-		auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
-		projectilePhys.SetLinearVelocity(emitter->GetComponent<Ndk::NodeComponent>().GetForward() * 50.f);
-
-		return projectile;
+		ProjectileEngine::ProjectileInfo torpedoInfo;
+		torpedoInfo.damage = 200;
+		torpedoInfo.explosionRadius = 50.f;
+		torpedoInfo.lifeTime = 30.f;
+		torpedoInfo.prefabId = static_cast<Nz::UInt32>(m_torpedoArchetype);
+		torpedoInfo.radius = 3.f;
+
+		m_projectileEngine.Spawn(torpedoInfo, emitter, position, rotation, emitter->GetComponent<Ndk::NodeComponent>().GetForward() * 50.f);
 	}
 
 	void Arena::DispatchChatMessage(const Nz::String& message)
@@ -120,144 +168,131 @@ namespace ewn
 			pair.first->SendPacket(chatPacket);
 	}
 
-	Player* Arena::FindPlayerByName(const std::string& name) const
+	void Arena::InvalidateArenaData()
 	{
-		for (auto&& [player, data] : m_players)
-		{
-			NazaraUnused(data);
-
-			if (player->GetName() == name)
-				return player;
-		}
-
-		return nullptr;
+		m_arenaPrefabsPacket.reset();
+		m_arenaSoundsPacket.reset();
 	}
 
 	void Arena::Reset()
 	{
+		const ArchetypeRegistry& archetypes = m_app->GetArchetypeRegistry();
+
 		// Earth entity
-		m_attractionPoint = CreateEntity("earth", "The (small) Earth", nullptr, Nz::Vector3f::Forward() * 60.f, Nz::Quaternionf::Identity());
+		m_attractionPoint = CreateEntity(archetypes.GetArchetypeId("earth"), "The (small) Earth", nullptr, Nz::Vector3f::Forward() * 60.f, Nz::Quaternionf::Identity());
+
+		// It has no physics body (so it's not in the spatial grid), projectiles still have to stop on it
+		Nz::Boxf earthAABB = m_attractionPoint->GetComponent<Ndk::CollisionComponent3D>().GetGeom()->ComputeAABB();
+
+		m_projectileEngine.ClearStaticObstacles();
+		m_projectileEngine.AddStaticObstacle(m_attractionPoint->GetId(), m_attractionPoint->GetComponent<Ndk::NodeComponent>().GetPosition(), std::max({ earthAABB.width, earthAABB.height, earthAABB.depth }) / 2.f);
 
 		// Light entity
-		m_light = CreateEntity("light", "", nullptr, Nz::Vector3f::Zero(), Nz::Quaternionf::Identity());
+		m_light = CreateEntity(archetypes.GetArchetypeId("light"), "", nullptr, Nz::Vector3f::Zero(), Nz::Quaternionf::Identity());
 
 		// Space ball entity
-		m_spaceball = CreateEntity("ball", "The (big) ball", nullptr, Nz::Vector3f::Up() * 50.f, Nz::Quaternionf::Identity());
+		m_spaceball = CreateEntity(archetypes.GetArchetypeId("ball"), "The (big) ball", nullptr, Nz::Vector3f::Up() * 50.f, Nz::Quaternionf::Identity());
 	}
 
-	void Arena::Update(float elapsedTime)
+	void Arena::ApplyProjectileHits()
 	{
-		m_world.Update(elapsedTime);
+		// Hits are recorded once every projectile moved and applied in hit order by the next playback, parked (dead) ships ignore later hits
+		EntityCommandBuffer& commandBuffer = GetCommandBuffer();
+		const SpatialGrid& spatialGrid = m_world.GetSystem<SpatialIndexSystem>().GetGrid();
+		const TransformSnapshotSystem& transforms = m_world.GetSystem<TransformSnapshotSystem>();
 
-		// Attraction
-		/*if (m_attractionPoint)
+		for (const ProjectileEngine::Hit& hit : m_projectileHits)
 		{
-			constexpr float G = 6.6740831f / 10'000.f;
-
-			Nz::Vector3f attractorPos = m_attractionPoint->GetComponent<Ndk::NodeComponent>().GetPosition();
-			float attractorMass = 5'000.f;
-
-			for (const Ndk::EntityHandle& entity : m_world.GetEntities())
+			if (hit.explosionRadius > 0.f)
 			{
-				if (entity->HasComponent<Ndk::PhysicsComponent3D>())
+				spatialGrid.ForEachInSphere(hit.position, hit.explosionRadius, [&](const SpatialGrid::Entry& entry)
 				{
-					Nz::Vector3f entityPos = entity->GetComponent<Ndk::NodeComponent>().GetPosition();
-					auto& phys = entity->GetComponent<Ndk::PhysicsComponent3D>();
+					const Ndk::EntityHandle& bodyEntity = m_world.GetEntity(entry.entityId);
+					if (!bodyEntity->IsEnabled())
+						return;
 
-					Nz::Vector3f dir = attractorPos - entityPos;
-					float d2 = attractorPos.SquaredDistance(entityPos);
+					const Nz::Vector3f& bodyPosition = transforms.GetPosition(entry.entityId);
 
-					phys.AddForce(dir * G * attractorMass * phys.GetMass() / d2);
-				}
-			}
-		}*/
+					float fade = std::clamp(bodyPosition.Distance(hit.position) / hit.explosionRadius, 0.f, 1.f);
 
-		static Nz::UInt64 respawnTime = 5'000;
+					Nz::Vector3f force = bodyPosition - hit.position;
+					force.Normalize();
+					force *= 500'000.f / fade;
 
-		Nz::UInt64 now = ServerApplication::GetAppTime();
-		for (auto& [player, playerData] : m_players)
-		{
-			if (!player->GetControlledEntity() && now - playerData.deathTime > respawnTime)
-				player->UpdateControlledEntity(CreatePlayerSpaceship(player));
+					commandBuffer.Damage(bodyEntity, static_cast<Nz::UInt16>(hit.damage / fade), hit.emitter);
+					commandBuffer.AddForce(bodyEntity, force);
+				});
+			}
+			else
+			{
+				const Ndk::EntityHandle& hitEntity = m_world.GetEntity(hit.hitEntityId);
+				if (!hitEntity->IsEnabled())
+					continue;
+
+				// Static obstacles (such as the Earth) only stop projectiles
+				if (!hitEntity->HasComponent<Ndk::PhysicsComponent3D>())
+					continue;
+
+				// Apply physics force
+				Nz::Vector3f projectileForce = hit.velocity;
+				float projectileSpeed;
+				projectileForce.Normalize(&projectileSpeed);
+				projectileForce = projectileForce * (projectileSpeed * projectileSpeed) / 2.f;
+
+				commandBuffer.Damage(hitEntity, hit.damage, hit.emitter);
+				commandBuffer.AddForce(hitEntity, projectileForce);
+			}
 		}
-
-		m_stateBroadcastAccumulator += elapsedTime;
 	}
 
-	const Ndk::EntityHandle& Arena::CreateEntity(std::string type, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
+	void Arena::BuildArenaData()
 	{
-		const Ndk::EntityHandle& newEntity = m_world.CreateEntity();
+		Packets::ArenaSounds arenaSoundsPacket;
+		arenaSoundsPacket.startId = 0;
 
-		if (type == "earth")
-		{
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(Nz::SphereCollider3D::New(50.f));
-			newEntity->AddComponent<Ndk::NodeComponent>().SetPosition(position);
-			newEntity->AddComponent<SynchronizedComponent>(0, type, name, false, 0);
-		}
-		else if (type == "light")
-		{
-			newEntity->AddComponent<SynchronizedComponent>(1, type, name, false, 0);
+		arenaSoundsPacket.sounds.emplace_back();
+		arenaSoundsPacket.sounds.back().filePath = "sounds/laserTurretlow.ogg";
 
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
-		}
-		else if (type == "ball")
-		{
-			constexpr float radius = 18.251904f / 2.f;
+		arenaSoundsPacket.sounds.emplace_back();
+		arenaSoundsPacket.sounds.back().filePath = "sounds/106733__crunchynut__sci-fi-loop-2.wav";
 
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(Nz::SphereCollider3D::New(radius));
-			newEntity->AddComponent<SynchronizedComponent>(4, type, name, true, 3);
+		m_arenaSoundsPacket = m_app->GetCommandStore().SerializePacket(arenaSoundsPacket);
 
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
+		Packets::ArenaPrefabs arenaPrefabsPacket;
+		m_app->GetArchetypeRegistry().BuildPrefabsPacket(m_app->GetNetworkStringStore(), arenaPrefabsPacket);
 
-			auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-			physComponent.SetLinearDamping(0.05f);
-			physComponent.SetMass(100.f);
-			physComponent.SetPosition(position);
-			physComponent.SetRotation(rotation);
-		}
-		else if (type == "plasmabeam")
-		{
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(Nz::CapsuleCollider3D::New(4.f, 0.5f, Nz::Vector3f::Zero(), Nz::EulerAnglesf(0.f, 90.f, 0.f)));
-			newEntity->AddComponent<LifeTimeComponent>(10.f);
-			newEntity->AddComponent<ProjectileComponent>(Nz::UInt16(50 + ((ServerApplication::GetAppTime() % 21) - 10))); //< Aléatoire du pauvre
-			newEntity->AddComponent<SynchronizedComponent>(2, type, name, true, 0);
+		m_arenaPrefabsPacket = m_app->GetCommandStore().SerializePacket(arenaPrefabsPacket);
+	}
 
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
+	const Ndk::EntityHandle& Arena::CreateEntity(std::size_t archetypeId, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, Nz::Collider3DRef collider)
+	{
+		const ArchetypeRegistry::Archetype& archetype = m_app->GetArchetypeRegistry().GetArchetype(archetypeId);
 
-			auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-			physComponent.SetAngularDamping(Nz::Vector3f::Zero());
-			physComponent.SetLinearDamping(0.f);
-			physComponent.SetMass(1.f);
-			physComponent.SetMaterial("plasma");
-			physComponent.SetPosition(position);
-			physComponent.SetRotation(rotation);
-		}
-		else if (type == "torpedo")
-		{
-			newEntity->AddComponent<Ndk::CollisionComponent3D>(Nz::SphereCollider3D::New(3.f));
-			newEntity->AddComponent<LifeTimeComponent>(30.f);
-			newEntity->AddComponent<ProjectileComponent>(200);
-			newEntity->AddComponent<SynchronizedComponent>(3, type, name, true, 0);
+		const Ndk::EntityHandle& newEntity = m_world.CreateEntity();
 
-			auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-			node.SetPosition(position);
-			node.SetRotation(rotation);
+		if (!collider)
+			collider = archetype.collider;
+
+		if (collider)
+			newEntity->AddComponent<Ndk::CollisionComponent3D>(std::move(collider));
+
+		auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
+		node.SetPosition(position);
+		node.SetRotation(rotation);
 
+		if (archetype.physics)
+		{
 			auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-			physComponent.SetAngularDamping(Nz::Vector3f::Zero());
-			physComponent.SetLinearDamping(0.f);
-			physComponent.SetMass(1.f);
-			physComponent.SetMaterial("torpedo");
+			if (archetype.physics->angularDamping)
+				physComponent.SetAngularDamping(*archetype.physics->angularDamping);
+
+			physComponent.SetLinearDamping(archetype.physics->linearDamping);
+			physComponent.SetMass(archetype.physics->mass);
 			physComponent.SetPosition(position);
 			physComponent.SetRotation(rotation);
 		}
 
+		newEntity->AddComponent<SynchronizedComponent>(archetypeId, archetype.type, std::move(name), archetype.isMovable, archetype.networkPriority);
 		newEntity->AddComponent<ArenaComponent>(*this);
 
 		if (owner)
@@ -268,47 +303,72 @@ namespace ewn
 
 	const Ndk::EntityHandle& Arena::CreateSpaceship(std::string name, Player* owner, std::size_t spaceshipHullId, const Nz::Vector3f& position, const Nz::Quaternionf& rotation)
 	{
-		const Ndk::EntityHandle& newEntity = m_world.CreateEntity();
+		Nz::UInt64 spawnStartTime = Nz::GetElapsedMicroseconds();
 
 		std::size_t collisionMeshId = m_app->GetSpaceshipHullStore().GetEntryCollisionMeshId(spaceshipHullId);
 		Nz::Collider3DRef collider = m_app->GetCollisionMeshStore().GetEntryCollider(collisionMeshId);
 		assert(collider);
 
-		auto& collisionComponent = newEntity->AddComponent<Ndk::CollisionComponent3D>(collider);
+		// Reuse a parked spaceship sharing the same collider if any, only its state has to be reset
+		if (const Ndk::EntityHandle& parkedSpaceship = TakeParkedSpaceship(collider); parkedSpaceship)
+		{
+			auto& physComponent = parkedSpaceship->GetComponent<Ndk::PhysicsComponent3D>();
+			physComponent.SetAngularVelocity(Nz::Vector3f::Zero());
+			physComponent.SetLinearVelocity(Nz::Vector3f::Zero());
+			physComponent.SetPosition(position);
+			physComponent.SetRotation(rotation);
+
+			auto& healthComponent = parkedSpaceship->GetComponent<HealthComponent>();
+			healthComponent.Heal(healthComponent.GetMaxHealth());
+
+			parkedSpaceship->GetComponent<InputComponent>().Reset();
+			parkedSpaceship->GetComponent<SynchronizedComponent>().SetName(std::move(name));
+
+			auto& node = parkedSpaceship->GetComponent<Ndk::NodeComponent>();
+			node.SetPosition(position);
+			node.SetRotation(rotation);
 
-		auto& physComponent = newEntity->AddComponent<Ndk::PhysicsComponent3D>();
-		physComponent.SetMass(42.f);
-		physComponent.SetAngularDamping(Nz::Vector3f(0.4f));
-		physComponent.SetLinearDamping(0.25f);
-		physComponent.SetPosition(position);
-		physComponent.SetRotation(rotation);
+			if (owner)
+				parkedSpaceship->AddComponent<OwnerComponent>(owner);
+
+			parkedSpaceship->Enable();
+
+			SpawnStats& spawnStats = m_spawnStats[spaceshipHullId];
+			spawnStats.reusedCount++;
+			spawnStats.reusedTime += Nz::GetElapsedMicroseconds() - spawnStartTime;
+
+			return parkedSpaceship;
+		}
+
+		const Ndk::EntityHandle& newEntity = CreateEntity(m_spaceshipArchetype, std::move(name), owner, position, rotation, std::move(collider));
 
 		auto& healthComponent = newEntity->AddComponent<HealthComponent>(1000);
 		healthComponent.OnDeath.Connect([this](HealthComponent* health, const Ndk::EntityHandle& attacker)
 		{
 			const Ndk::EntityHandle& entity = health->GetEntity();
 
-			if (entity->HasComponent<PlayerControlledComponent>() && attacker->HasComponent<OwnerComponent>())
+			if (!entity->HasComponent<PlayerControlledComponent>())
 			{
-				auto& shipOwner = entity->GetComponent<PlayerControlledComponent>();
-				auto& attackerOwner = attacker->GetComponent<OwnerComponent>();
-
-				Player* shipOwnerPlayer = shipOwner.GetOwner();
-				if (!shipOwnerPlayer)
-					return;
-
-				auto it = m_players.find(shipOwnerPlayer);
-				assert(it != m_players.end());
+				entity->Kill();
+				return;
+			}
 
-				it->second.deathTime = ServerApplication::GetAppTime();
+			if (Player* shipOwnerPlayer = entity->GetComponent<PlayerControlledComponent>().GetOwner())
+			{
+				ScheduleRespawn(shipOwnerPlayer, m_tick + RespawnDelay);
 
-				Player* attackerPlayer = attackerOwner.GetOwner();
-				Nz::String attackerName = (attackerPlayer) ? attackerPlayer->GetName() : "<Disconnected>";
+				// Attacker is the entity which fired the projectile, it may have been destroyed since
+				if (attacker && attacker->HasComponent<OwnerComponent>())
+				{
+					Player* attackerPlayer = attacker->GetComponent<OwnerComponent>().GetOwner();
+					Nz::String attackerName = (attackerPlayer) ? attackerPlayer->GetName() : "<Disconnected>";
 
-				DispatchChatMessage(attackerName + " has destroyed " + shipOwnerPlayer->GetName());
+					DispatchChatMessage(attackerName + " has destroyed " + shipOwnerPlayer->GetName());
+				}
 			}
 
-			entity->Kill();
+			// Player spaceships are respawned all the time, keep them around instead of destroying them
+			ParkSpaceship(entity);
 		});
 
 		healthComponent.OnHealthChange.Connect([this](HealthComponent* health)
@@ -330,27 +390,44 @@ namespace ewn
 		});
 
 		newEntity->AddComponent<InputComponent>();
-		newEntity->AddComponent<SynchronizedComponent>(5, "spaceship", name, true, 5);
 
-		auto& node = newEntity->AddComponent<Ndk::NodeComponent>();
-		node.SetPosition(position);
-		node.SetRotation(rotation);
-
-		newEntity->AddComponent<ArenaComponent>(*this);
-
-		if (owner)
-			newEntity->AddComponent<OwnerComponent>(owner);
+		SpawnStats& spawnStats = m_spawnStats[spaceshipHullId];
+		spawnStats.createdCount++;
+		spawnStats.createdTime += Nz::GetElapsedMicroseconds() - spawnStartTime;
 
 		return newEntity;
 	}
 
 	void Arena::HandlePlayerLeave(Player* player)
 	{
-		assert(m_players.find(player) != m_players.end());
+		auto it = m_players.find(player);
+		assert(it != m_players.end());
 
 		DispatchChatMessage(player->GetName() + " has left");
 
-		m_players.erase(player);
+		m_timerWheel.Cancel(it->second.respawnTimer);
+		m_players.erase(it);
+
+		// Player will be destroyed by the main thread once it left, drop every reference we have to it
+		player->m_botEntity.Reset();
+		player->m_controlledEntity.Reset();
+
+		for (const Ndk::EntityHandle& entity : m_world.GetEntities())
+		{
+			if (entity->HasComponent<OwnerComponent>())
+			{
+				auto& ownerComponent = entity->GetComponent<OwnerComponent>();
+				if (ownerComponent.GetOwner() == player)
+					ownerComponent.ResetOwner();
+			}
+
+			if (entity->HasComponent<PlayerControlledComponent>())
+			{
+				auto& controlComponent = entity->GetComponent<PlayerControlledComponent>();
+				if (controlComponent.GetOwner() == player)
+					controlComponent.ResetOwner();
+			}
+		}
 	}
 
 	void Arena::HandlePlayerJoin(Player* player)
@@ -365,193 +442,232 @@ namespace ewn
 		for (const auto& packet : m_createEntityCache)
 			player->SendPacket(packet);
 
+		m_projectileEngine.CreateAllProjectiles(m_createProjectileCache);
+
+		for (const auto& packet : m_createProjectileCache)
+			player->SendPacket(packet);
+
 		DispatchChatMessage(player->GetName() + " has joined");
 
 		m_players.emplace(player, PlayerData{});
+
+		ScheduleRespawn(player, m_tick + 1);
 	}
 
-	void Arena::SendArenaData(Player* player)
+	bool Arena::IsIdle()
 	{
-		Packets::ArenaSounds arenaSoundsPacket;
-		arenaSoundsPacket.startId = 0;
+		// Nobody can observe an arena without players, unless bots scripts are still running in it
+		return m_players.empty() && m_world.GetSystem<ScriptSystem>().GetEntities().empty();
+	}
 
-		arenaSoundsPacket.sounds.emplace_back();
-		arenaSoundsPacket.sounds.back().filePath = "sounds/laserTurretlow.ogg";
+	void Arena::ParkSpaceship(const Ndk::EntityHandle& spaceship)
+	{
+		const Nz::Collider3D* collider = spaceship->GetComponent<Ndk::CollisionComponent3D>().GetGeom().Get();
 
-		arenaSoundsPacket.sounds.emplace_back();
-		arenaSoundsPacket.sounds.back().filePath = "sounds/106733__crunchynut__sci-fi-loop-2.wav";
+		std::vector<Ndk::EntityHandle>& parkedSpaceships = m_parkedSpaceships[collider];
+		if (parkedSpaceships.size() >= MaxParkedSpaceships)
+		{
+			spaceship->Kill();
+			return;
+		}
 
-		player->SendPacket(arenaSoundsPacket);
+		// Handles stay valid as the entity is not destroyed, drop every reference a live spaceship would have (without killing it)
+		if (Player* controller = spaceship->GetComponent<PlayerControlledComponent>().GetOwner())
+			controller->ReleaseControlledEntity();
 
-		Packets::ArenaPrefabs arenaPrefabsPacket;
-		arenaPrefabsPacket.startId = 0;
-
-		// Earth
-		arenaPrefabsPacket.prefabs.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().effectNameId = m_app->GetNetworkStringStore().GetStringIndex("earth");
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().position = Nz::Vector3f::Zero();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().rotation = Nz::Quaternionf::Identity();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().scale = Nz::Vector3f::Unit();
-
-		// Light
-		arenaPrefabsPacket.prefabs.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().effectNameId = m_app->GetNetworkStringStore().GetStringIndex("light");
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().position = Nz::Vector3f::Zero();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().rotation = Nz::Quaternionf::Identity();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().scale = Nz::Vector3f::Unit();
-
-		// Plasma beam
-		arenaPrefabsPacket.prefabs.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().effectNameId = m_app->GetNetworkStringStore().GetStringIndex("plasmabeam");
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().position = Nz::Vector3f::Zero();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().rotation = Nz::Quaternionf::Identity();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().scale = Nz::Vector3f::Unit();
-
-		// Torpedo
-		arenaPrefabsPacket.prefabs.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.emplace_back();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().effectNameId = m_app->GetNetworkStringStore().GetStringIndex("torpedo");
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().position = Nz::Vector3f::Zero();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().rotation = Nz::Quaternionf::Identity();
-		arenaPrefabsPacket.prefabs.back().visualEffects.back().scale = Nz::Vector3f::Unit();
-
-		/*arenaPrefabsPacket.prefabs.back().sounds.emplace_back();
-		arenaPrefabsPacket.prefabs.back().sounds.back().soundId = 1;
-		arenaPrefabsPacket.prefabs.back().sounds.back().position = Nz::Vector3f::Zero();*/
-
-		// Ball
-		arenaPrefabsPacket.prefabs.emplace_back();
-		arenaPrefabsPacket.prefabs.back().models.emplace_back();
-		arenaPrefabsPacket.prefabs.back().models.back().modelId = m_app->GetNetworkStringStore().GetStringIndex("ball/ball.obj");
-		arenaPrefabsPacket.prefabs.back().models.back().position = Nz::Vector3f::Zero();
-		arenaPrefabsPacket.prefabs.back().models.back().rotation = Nz::Quaternionf::Identity();
-		arenaPrefabsPacket.prefabs.back().models.back().scale = Nz::Vector3f::Unit();
-
-		// Spaceship
-		arenaPrefabsPacket.prefabs.emplace_back();
-		arenaPrefabsPacket.prefabs.back().models.emplace_back();
-		arenaPrefabsPacket.prefabs.back().models.back().modelId = m_app->GetNetworkStringStore().GetStringIndex("spaceship/spaceship.obj");
-		arenaPrefabsPacket.prefabs.back().models.back().position = Nz::Vector3f::Zero();
-		arenaPrefabsPacket.prefabs.back().models.back().rotation = Nz::EulerAnglesf(0.f, 90.f, 0.f);
-		arenaPrefabsPacket.prefabs.back().models.back().scale = Nz::Vector3f(0.01f);
-
-		player->SendPacket(arenaPrefabsPacket);
+		spaceship->RemoveComponent<PlayerControlledComponent>();
+		if (spaceship->HasComponent<OwnerComponent>())
+			spaceship->RemoveComponent<OwnerComponent>();
+
+		m_world.GetSystem<RadarSystem>().ForgetEntity(spaceship);
+
+		// Keep the physics body but move it out of the way, spread by entity id so parked bodies don't touch and fall asleep
+		constexpr float parkingSpacing = 100.f;
+		const Nz::Vector3f parkingOrigin = Nz::Vector3f::Down() * 100'000.f;
+
+		auto& physComponent = spaceship->GetComponent<Ndk::PhysicsComponent3D>();
+		physComponent.SetAngularVelocity(Nz::Vector3f::Zero());
+		physComponent.SetLinearVelocity(Nz::Vector3f::Zero());
+		physComponent.SetPosition(parkingOrigin + Nz::Vector3f::Right() * (parkingSpacing * spaceship->GetId()));
+
+		// Disabled entities are removed from every system (and deleted client-side by the broadcast system)
+		spaceship->Disable();
+
+		parkedSpaceships.push_back(spaceship);
 	}
 
-	bool Arena::HandlePlasmaProjectileCollision(const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody)
+	void Arena::ScheduleRespawn(Player* player, Nz::UInt64 tick)
 	{
-		Ndk::EntityId laserEntityId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(firstBody.GetUserdata()));
-		Ndk::EntityId hitEntityId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(secondBody.GetUserdata()));
+		auto it = m_players.find(player);
+		assert(it != m_players.end());
+
+		PlayerData& playerData = it->second;
+		m_timerWheel.Cancel(playerData.respawnTimer);
 
-		if (secondBody.GetMaterial() == m_plasmaMaterial)
+		// Timer is cancelled if the player leaves, the player is still there when it runs
+		playerData.respawnTimer = m_timerWheel.Schedule(tick, [this, player]()
 		{
-			assert(firstBody.GetMaterial() != m_plasmaMaterial);
-			std::swap(laserEntityId, hitEntityId);
-		}
+			auto playerIt = m_players.find(player);
+			assert(playerIt != m_players.end());
 
-		const Ndk::EntityHandle& projectile = m_world.GetEntity(laserEntityId);
-		const Ndk::EntityHandle& hitEntity = m_world.GetEntity(hitEntityId);
+			playerIt->second.respawnTimer = TimerWheel::InvalidTimerId;
 
-		assert(projectile->HasComponent<ProjectileComponent>());
+			if (!player->GetControlledEntity())
+				player->UpdateControlledEntity(CreatePlayerSpaceship(player));
+		});
+	}
 
-		ProjectileComponent& projectileComponent = projectile->GetComponent<ProjectileComponent>();
-		if (projectileComponent.HasBeenHit(hitEntity))
-			return false;
+	void Arena::SendArenaData(Player* player)
+	{
+		// Arena data is the same for every player, build it once and send the same serialized packets to everyone
+		if (!m_arenaPrefabsPacket || !m_arenaSoundsPacket)
+			BuildArenaData();
 
-		projectileComponent.MarkAsHit(hitEntity);
+		player->SendPacket(*m_arenaSoundsPacket);
+		player->SendPacket(*m_arenaPrefabsPacket);
+	}
 
-		// Deal damage if entity has a health value
-		if (hitEntity->HasComponent<HealthComponent>())
-		{
-			auto& health = hitEntity->GetComponent<HealthComponent>();
-			health.Damage(projectileComponent.GetDamageValue(), projectile);
-		}
+	const Ndk::EntityHandle& Arena::TakeParkedSpaceship(const Nz::Collider3D* collider)
+	{
+		auto it = m_parkedSpaceships.find(collider);
+		if (it == m_parkedSpaceships.end())
+			return Ndk::EntityHandle::InvalidHandle;
 
-		// Apply physics force
-		if (hitEntity->HasComponent<Ndk::PhysicsComponent3D>())
+		std::vector<Ndk::EntityHandle>& parkedSpaceships = it->second;
+		while (!parkedSpaceships.empty())
 		{
-			auto& hitEntityPhys = hitEntity->GetComponent<Ndk::PhysicsComponent3D>();
-			auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
+			Ndk::EntityHandle spaceship = std::move(parkedSpaceships.back());
+			parkedSpaceships.pop_back();
 
-			Nz::Vector3f projectileForce = projectilePhys.GetLinearVelocity();
-			float projectileSpeed;
-			projectileForce.Normalize(&projectileSpeed);
-			projectileForce = projectileForce * (projectileSpeed * projectileSpeed) / 2.f;
+			if (spaceship)
+				return m_world.GetEntity(spaceship->GetId());
 
-			hitEntityPhys.AddForce(projectileForce);
+			// Parked spaceships should only be destroyed with their arena, reuse silently stops working otherwise
+			std::cerr << "A parked spaceship was destroyed while parked" << std::endl;
 		}
 
-		projectile->Kill(); //< Remember entity destruction is not immediate, we can still use it safely
-
-		return false;
+		return Ndk::EntityHandle::InvalidHandle;
 	}
 
-	bool Arena::HandleTorpedoProjectileCollision(const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody)
+	void Arena::Tick()
 	{
-		Ndk::EntityId torpedoEntityId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(firstBody.GetUserdata()));
-		Ndk::EntityId hitEntityId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(secondBody.GetUserdata()));
+		m_tick++;
 
-		if (secondBody.GetMaterial() == m_torpedoMaterial)
-		{
-			assert(firstBody.GetMaterial() != m_plasmaMaterial);
-			std::swap(torpedoEntityId, hitEntityId);
-		}
+		// Only timers which are due this tick are touched (respawns, entity lifetimes, engine impulses, ...)
+		m_timerWheel.Advance(m_tick);
+		m_commandBuffer.Playback(*this);
+
+		m_systemScheduler.Update(TickDuration);
 
-		const Ndk::EntityHandle& projectile = m_world.GetEntity(torpedoEntityId);
-		const Ndk::EntityHandle& hitEntity = m_world.GetEntity(hitEntityId);
+		// Projectiles are swept against entity positions from the beginning of the tick (or earlier ones, for lag-compensated shots)
+		const SpatialIndexSystem& spatialIndex = m_world.GetSystem<SpatialIndexSystem>();
 
-		assert(projectile->HasComponent<ProjectileComponent>());
+		m_projectileHits.clear();
+		m_projectileEngine.Update(TickDuration, spatialIndex.GetGrid(), spatialIndex.GetHistory(), m_projectileHits);
 
-		ProjectileComponent& projectileComponent = projectile->GetComponent<ProjectileComponent>();
-		if (projectileComponent.HasBeenHit(hitEntity))
-			return false;
+		ApplyProjectileHits();
+		m_commandBuffer.Playback(*this);
 
-		projectileComponent.MarkAsHit(hitEntity);
+		// Published for arena placement (see ServerApplication::FindArenaForPlayer)
+		m_entityCount.store(m_world.GetEntities().size(), std::memory_order_relaxed);
 
-		// Deal damage if entity has a health value
+		// Attraction
+		/*if (m_attractionPoint)
+		{
+			constexpr float G = 6.6740831f / 10'000.f;
 
-		// Apply physics force
-		auto& projectilePhys = projectile->GetComponent<Ndk::PhysicsComponent3D>();
+			Nz::Vector3f attractorPos = m_attractionPoint->GetComponent<Ndk::NodeComponent>().GetPosition();
+			float attractorMass = 5'000.f;
 
-		Nz::PhysWorld3D& physWorld = m_world.GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
+			for (const Ndk::EntityHandle& entity : m_world.GetEntities())
+			{
+				if (entity->HasComponent<Ndk::PhysicsComponent3D>())
+				{
+					Nz::Vector3f entityPos = entity->GetComponent<Ndk::NodeComponent>().GetPosition();
+					auto& phys = entity->GetComponent<Ndk::PhysicsComponent3D>();
 
-		float explosionRadius = 50.f;
-		Nz::Vector3f torpedoPosition = projectilePhys.GetPosition();
-		Nz::Boxf detectionBox = Nz::Boxf(torpedoPosition - Nz::Vector3f(explosionRadius), torpedoPosition + Nz::Vector3f(explosionRadius));
+					Nz::Vector3f dir = attractorPos - entityPos;
+					float d2 = attractorPos.SquaredDistance(entityPos);
 
-		float maxSquaredRadius = explosionRadius * explosionRadius;
-		physWorld.ForEachBodyInAABB(detectionBox, [&](Nz::RigidBody3D& body)
+					phys.AddForce(dir * G * attractorMass * phys.GetMass() / d2);
+				}
+			}
+		}*/
+	}
+
+	void Arena::Update(float elapsedTime)
+	{
+		// Simulation runs at a fixed rate, whatever the server update rate is
+		m_tickAccumulator += elapsedTime;
+
+		std::size_t tickCount = 0;
+		while (m_tickAccumulator >= TickDuration)
 		{
-			Nz::Vector3f bodyPosition = body.GetPosition();
-			if (bodyPosition.SquaredDistance(torpedoPosition) < maxSquaredRadius)
+			if (tickCount >= MaxTicksPerUpdate)
 			{
-				Ndk::EntityId bodyId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(body.GetUserdata()));
-				const Ndk::EntityHandle& bodyEntity = m_world.GetEntity(bodyId);
+				// Server is too late to catch up, skip remaining ticks and shift tick time so it stays in sync with application time
+				Nz::UInt64 skippedTicks = static_cast<Nz::UInt64>(m_tickAccumulator / TickDuration);
+				m_tickAccumulator -= skippedTicks * TickDuration;
+				m_tickTimeOrigin += skippedTicks * 1000 / ServerTickRate;
 
-				float fade = std::clamp(bodyPosition.Distance(torpedoPosition) / explosionRadius, 0.f, 1.f);
+				// An overloaded arena is late every update, don't make it worse by logging each time
+				m_skippedTicks += skippedTicks;
 
-				if (bodyEntity->HasComponent<HealthComponent>())
+				Nz::UInt64 now = ServerApplication::GetAppTime();
+				if (now - m_lastSkippedTicksReport >= SkippedTicksReportInterval)
 				{
-					auto& health = bodyEntity->GetComponent<HealthComponent>();
-					health.Damage(static_cast<Nz::UInt16>(projectileComponent.GetDamageValue() / fade), projectile);
+					std::cerr << "Arena is running late, skipped " << m_skippedTicks << " tick(s) since last report" << std::endl;
+
+					m_lastSkippedTicksReport = now;
+					m_skippedTicks = 0;
 				}
+				break;
+			}
 
-				Nz::Vector3f force = bodyPosition - torpedoPosition;
-				force.Normalize();
-				force *= 500'000.f / fade;
+			m_tickAccumulator -= TickDuration;
+			Tick();
 
-				body.AddForce(force);
-			}
+			tickCount++;
+		}
+	}
 
-			return true;
-		});
+	void Arena::WorkerThread()
+	{
+		// Each arena runs its own simulation loop, other threads only interact with it through callbacks
+		Nz::UInt64 lastTime = Nz::GetElapsedMicroseconds();
+
+		ArenaCallback callback;
+		while (m_running.load(std::memory_order_acquire))
+		{
+			while (m_callbackQueue.try_dequeue(callback))
+				callback();
+
+			if (IsIdle())
+			{
+				// Hibernate: freeze the simulation until a callback (such as a player joining) wakes us up
+				// Tick time is shifted by the hibernation duration, so simulation resumes from the exact same state without catching up
+				m_commandBuffer.Playback(*this); //< Recorded entity ids wouldn't survive the refresh
+				m_world.Refresh(); //< Don't keep killed entities around
 
-		projectile->Kill(); //< Remember entity destruction is not immediate, we can still use it safely
+				Nz::UInt64 hibernationStart = ServerApplication::GetAppTime();
 
-		return false;
+				m_callbackQueue.wait_dequeue(callback);
+				callback();
+
+				m_tickTimeOrigin += ServerApplication::GetAppTime() - hibernationStart;
+				lastTime = Nz::GetElapsedMicroseconds();
+				continue;
+			}
+
+			Nz::UInt64 now = Nz::GetElapsedMicroseconds();
+			Update((now - lastTime) / 1'000'000.f);
+			lastTime = now;
+
+			// Sleep until next tick is due, callbacks (such as player inputs) wake us up earlier
+			float timeUntilNextTick = TickDuration - m_tickAccumulator;
+			if (timeUntilNextTick > 0.f && m_callbackQueue.wait_dequeue_timed(callback, static_cast<std::int64_t>(timeUntilNextTick * 1'000'000.f)))
+				callback();
+		}
 	}
 
 	void Arena::OnBroadcastEntityCreation(const BroadcastSystem* /*system*/, const Packets::CreateEntity& packet)
@@ -568,20 +684,12 @@ namespace ewn
 
 	void Arena::OnBroadcastStateUpdate(const BroadcastSystem* /*system*/, Packets::ArenaState& statePacket)
 	{
-		constexpr float stateBroadcastInterval = 1.f / 30.f;
-		if (m_stateBroadcastAccumulator >= stateBroadcastInterval)
+		// Broadcast rate is handled by the broadcast system (every few ticks)
+		for (auto& pair : m_players)
 		{
-			m_stateBroadcastAccumulator -= stateBroadcastInterval;
-
-			static Nz::UInt16 snapshotId = 0;
-			statePacket.stateId = snapshotId++;
+			statePacket.lastProcessedInputTime = pair.first->GetLastInputProcessedTime();
 
-			for (auto& pair : m_players)
-			{
-				statePacket.lastProcessedInputTime = pair.first->GetLastInputProcessedTime();
-
-				pair.first->SendPacket(statePacket);
-			}
+			pair.first->SendPacket(statePacket);
 		}
 
 		if constexpr (sendServerGhosts)
@@ -597,4 +705,16 @@ namespace ewn
 			m_debugSocket.SendPacket(debugAddress, debugState);
 		}
 	}
+
+	void Arena::OnProjectileCreated(const ProjectileEngine* /*engine*/, const Packets::CreateProjectile& packet)
+	{
+		for (auto& pair : m_players)
+			pair.first->SendPacket(packet);
+	}
+
+	void Arena::OnProjectileDestroyed(const ProjectileEngine* /*engine*/, const Packets::DeleteProjectile& packet)
+	{
+		for (auto& pair : m_players)
+			pair.first->SendPacket(packet);
+	}
 }
@@ -8,20 +8,28 @@
 #define EREWHON_SERVER_ARENA_HPP
 
 #include <Nazara/Core/Clock.hpp>
+#include <Nazara/Core/Thread.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
 #include <NDK/EntityList.hpp>
 #include <NDK/EntityOwner.hpp>
 #include <NDK/World.hpp>
+#include <Shared/Config.hpp>
 #include <Shared/NetworkReactor.hpp>
 #include <Shared/Protocol/Packets.hpp>
+#include <Server/EntityCommandBuffer.hpp>
+#include <Server/ProjectileEngine.hpp>
 #include <Server/ServerCommandStore.hpp>
+#include <Server/SystemScheduler.hpp>
+#include <Server/TaskPool.hpp>
+#include <Server/TimerWheel.hpp>
+#include <concurrentqueue/blockingconcurrentqueue.h>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-namespace Nz
-{
-	class RigidBody3D;
-}
-
 namespace ewn
 {
 	class BroadcastSystem;
@@ -30,9 +38,13 @@ namespace ewn
 
 	class Arena
 	{
+		friend EntityCommandBuffer;
 		friend Player;
 
 		public:
+			using ArenaCallback = std::function<void()>;
+			struct SpawnStats;
+
 			Arena(ServerApplication* app);
 			Arena(const Arena&) = delete;
 			Arena(Arena&&) = delete;
@@ -42,38 +54,80 @@ namespace ewn
 			void BroadcastPacket(const T& packet, Player* exceptPlayer = nullptr);
 
 			const Ndk::EntityHandle& CreatePlayerSpaceship(Player* owner);
-			const Ndk::EntityHandle& CreatePlasmaProjectile(Player* owner, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
-			const Ndk::EntityHandle& CreateTorpedo(Player* owner, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
+			void CreatePlasmaProjectile(const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, Nz::UInt64 shooterViewTime = 0);
+			void CreateTorpedo(const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
 
 			void DispatchChatMessage(const Nz::String& message);
 
-			Player* FindPlayerByName(const std::string& name) const;
+			inline std::size_t GetAssignedPlayerCount() const;
+			inline EntityCommandBuffer& GetCommandBuffer();
+			inline Nz::UInt64 GetCurrentTick() const;
+			inline Nz::UInt64 GetCurrentTime() const;
+			inline std::size_t GetEntityCount() const;
+			inline const std::unordered_map<std::size_t, SpawnStats>& GetSpawnStats() const;
+			inline TaskPool& GetTaskPool();
+			inline Nz::UInt64 GetTickAt(Nz::UInt64 time) const;
+			inline TimerWheel& GetTimerWheel();
 
-			void Reset();
+			inline bool HasLeavingPlayers() const;
 
-			void Update(float elapsedTime);
+			void InvalidateArenaData();
+
+			inline void RegisterCallback(ArenaCallback callback);
+			template<typename F> void RegisterPlayerCallback(Player* player, F&& callback);
+
+			void Reset();
 
 			Arena& operator=(const Arena&) = delete;
 			Arena& operator=(Arena&&) = delete;
 
+			static constexpr float TickDuration = 1.f / ServerTickRate;
+
+			// Cost of spaceship spawns (per spaceship hull), fresh ones versus those taken from the parked spaceship pool
+			struct SpawnStats
+			{
+				Nz::UInt64 createdCount = 0;
+				Nz::UInt64 createdTime = 0; //< In microseconds
+				Nz::UInt64 reusedCount = 0;
+				Nz::UInt64 reusedTime = 0; //< In microseconds
+			};
+
 		private:
-			const Ndk::EntityHandle& CreateEntity(std::string type, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
+			using CallbackQueue = moodycamel::BlockingConcurrentQueue<ArenaCallback>;
+
+			void ApplyProjectileHits();
+			void BuildArenaData();
+			const Ndk::EntityHandle& CreateEntity(std::size_t archetypeId, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, Nz::Collider3DRef collider = nullptr);
 			const Ndk::EntityHandle& CreateSpaceship(std::string name, Player* owner, std::size_t spaceshipHullId, const Nz::Vector3f& position, const Nz::Quaternionf& rotation);
 			void HandlePlayerLeave(Player* player);
 			void HandlePlayerJoin(Player* player);
-
-			bool HandlePlasmaProjectileCollision(const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody);
-			bool HandleTorpedoProjectileCollision(const Nz::RigidBody3D& firstBody, const Nz::RigidBody3D& secondBody);
+			bool IsIdle();
+			void ParkSpaceship(const Ndk::EntityHandle& spaceship);
+			void ScheduleRespawn(Player* player, Nz::UInt64 tick);
+			const Ndk::EntityHandle& TakeParkedSpaceship(const Nz::Collider3D* collider);
 
 			void OnBroadcastEntityCreation(const BroadcastSystem* system, const Packets::CreateEntity& packet);
 			void OnBroadcastEntityDestruction(const BroadcastSystem* system, const Packets::DeleteEntity& packet);
 			void OnBroadcastStateUpdate(const BroadcastSystem* system, Packets::ArenaState& statePacket);
+			void OnProjectileCreated(const ProjectileEngine* engine, const Packets::CreateProjectile& packet);
+			void OnProjectileDestroyed(const ProjectileEngine* engine, const Packets::DeleteProjectile& packet);
 
 			void SendArenaData(Player* player);
 
+			void Tick();
+
+			void Update(float elapsedTime);
+
+			void WorkerThread();
+
+			static constexpr std::size_t MaxParkedSpaceships = 8; //< Per collider
+			static constexpr std::size_t MaxTicksPerUpdate = 5; //< Catch-up limit, remaining late ticks are skipped
+			static constexpr Nz::UInt64 SkippedTicksReportInterval = 1000; //< In milliseconds
+			static constexpr Nz::UInt64 RespawnDelay = 5 * ServerTickRate; //< In ticks
+
 			struct PlayerData
 			{
-				Nz::UInt64 deathTime = 0;
+				TimerWheel::TimerId respawnTimer = TimerWheel::InvalidTimerId;
 			};
 
 			Nz::UdpSocket m_debugSocket;
@@ -82,12 +136,34 @@ namespace ewn
 			Ndk::EntityOwner m_spaceball;
 			Ndk::EntityList m_scriptControlledEntities;
 			Ndk::World m_world;
+			SystemScheduler m_systemScheduler;
+			EntityCommandBuffer m_commandBuffer;
+			ProjectileEngine m_projectileEngine;
+			TimerWheel m_timerWheel;
+			std::optional<CommandStore::SerializedPacket> m_arenaPrefabsPacket;
+			std::optional<CommandStore::SerializedPacket> m_arenaSoundsPacket;
+			std::unordered_map<std::size_t /*spaceshipHullId*/, SpawnStats> m_spawnStats;
+			std::unordered_map<const Nz::Collider3D*, std::vector<Ndk::EntityHandle>> m_parkedSpaceships;
 			std::unordered_map<Player*, PlayerData> m_players;
 			std::vector<Packets::CreateEntity> m_createEntityCache;
+			std::vector<Packets::CreateProjectile> m_createProjectileCache;
+			std::vector<ProjectileEngine::Hit> m_projectileHits;
+			std::atomic_bool m_running;
+			std::atomic_size_t m_entityCount;
+			std::size_t m_plasmaBeamArchetype;
+			std::size_t m_spaceshipArchetype;
+			std::size_t m_torpedoArchetype;
+			std::size_t m_assignedPlayerCount; //< Players in (or joining) this arena, only accessed by the main thread
+			std::size_t m_leavingPlayerCount; //< Players this arena was asked to release, only accessed by the main thread
+			CallbackQueue m_callbackQueue;
+			Nz::Thread m_thread;
 			ServerApplication* m_app;
-			float m_stateBroadcastAccumulator;
-			int m_plasmaMaterial;
-			int m_torpedoMaterial;
+			TaskPool& m_taskPool; //< Shared by every arena
+			Nz::UInt64 m_lastSkippedTicksReport;
+			Nz::UInt64 m_skippedTicks; //< Since the last report
+			Nz::UInt64 m_tick;
+			Nz::UInt64 m_tickTimeOrigin;
+			float m_tickAccumulator;
 	};
 }
 
@@ -16,4 +16,86 @@ namespace ewn
 				pair.first->SendPacket(packet);
 		}
 	}
+
+	// Main thread only, counts players assigned to this arena even if they didn't join it yet
+	inline std::size_t Arena::GetAssignedPlayerCount() const
+	{
+		return m_assignedPlayerCount;
+	}
+
+	inline Nz::UInt64 Arena::GetCurrentTick() const
+	{
+		return m_tick;
+	}
+
+	// Simulation time of the current tick (in milliseconds, follows application time), arena code should only rely on this
+	inline Nz::UInt64 Arena::GetCurrentTime() const
+	{
+		return m_tickTimeOrigin + m_tick * 1000 / ServerTickRate;
+	}
+
+	// Thread-safe, entity count as of the last tick
+	inline std::size_t Arena::GetEntityCount() const
+	{
+		return m_entityCount.load(std::memory_order_relaxed);
+	}
+
+	// Arena thread only
+	inline const std::unordered_map<std::size_t, Arena::SpawnStats>& Arena::GetSpawnStats() const
+	{
+		return m_spawnStats;
+	}
+
+	// First tick simulated at or after this time
+	inline Nz::UInt64 Arena::GetTickAt(Nz::UInt64 time) const
+	{
+		if (time <= m_tickTimeOrigin)
+			return 0;
+
+		return ((time - m_tickTimeOrigin) * ServerTickRate + 999) / 1000;
+	}
+
+	// Buffer of the system run by the calling thread, outside of systems (timers, projectile hits, ...) the arena own buffer which is played back after them
+	inline EntityCommandBuffer& Arena::GetCommandBuffer()
+	{
+		if (EntityCommandBuffer* boundBuffer = EntityCommandBuffer::GetBoundBuffer())
+			return *boundBuffer;
+
+		return m_commandBuffer;
+	}
+
+	inline TaskPool& Arena::GetTaskPool()
+	{
+		return m_taskPool;
+	}
+
+	// Scheduled callbacks run at the beginning of the tick they are due, before the world update
+	inline TimerWheel& Arena::GetTimerWheel()
+	{
+		return m_timerWheel;
+	}
+
+	// Main thread only, an arena must not be destroyed while players are leaving it
+	inline bool Arena::HasLeavingPlayers() const
+	{
+		return m_leavingPlayerCount > 0;
+	}
+
+	// Thread-safe, callback will be run by the arena thread before its next update
+	inline void Arena::RegisterCallback(ArenaCallback callback)
+	{
+		m_callbackQueue.enqueue(std::move(callback));
+	}
+
+	// Same as RegisterCallback, but the callback is dropped if the player left the arena in the meantime
+	template<typename F>
+	void Arena::RegisterPlayerCallback(Player* player, F&& callback)
+	{
+		RegisterCallback([this, player, cb = std::forward<F>(callback)]() mutable
+		{
+			// Players are only destroyed once they left their arena, checking membership is enough
+			if (m_players.find(player) != m_players.end())
+				cb();
+		});
+	}
 }
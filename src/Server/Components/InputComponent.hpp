@@ -19,16 +19,20 @@ namespace ewn
 			InputComponent();
 
 			inline Nz::UInt64 GetLastInputTime() const;
+			inline Nz::UInt64 GetLastReceivedInputTime() const;
 
-			template<typename F> void ProcessInputs(F inputFunc);
+			template<typename F> void ProcessInputs(Nz::UInt64 currentTick, F inputFunc);
 
-			inline void PushInput(Nz::UInt64 inputTime, const Nz::Vector3f& direction, const Nz::Vector3f& rotation);
+			inline bool PushInput(Nz::UInt64 inputTick, Nz::UInt64 inputTime, const Nz::Vector3f& direction, const Nz::Vector3f& rotation);
+
+			inline void Reset();
 
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
 			struct InputData
 			{
+				Nz::UInt64 serverTick;
 				Nz::UInt64 serverTime;
 				Nz::Vector3f direction;
 				Nz::Vector3f rotation;
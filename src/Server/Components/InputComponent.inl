@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Components/InputComponent.hpp>
+#include <iterator>
 
 namespace ewn
 {
@@ -16,22 +17,32 @@ namespace ewn
 		return m_lastInputTime;
 	}
 
+	inline Nz::UInt64 InputComponent::GetLastReceivedInputTime() const
+	{
+		return (!m_inputs.empty()) ? m_inputs.back().serverTime : m_lastInputTime;
+	}
+
 	template<typename F>
-	void InputComponent::ProcessInputs(F inputFunc)
+	void InputComponent::ProcessInputs(Nz::UInt64 currentTick, F inputFunc)
 	{
-		for (const InputData& input : m_inputs)
-			inputFunc(input.serverTime, input.direction, input.rotation);
+		// Inputs are stored in tick order, only apply those scheduled up to the current tick
+		auto it = m_inputs.begin();
+		for (; it != m_inputs.end() && it->serverTick <= currentTick; ++it)
+			inputFunc(it->serverTime, it->direction, it->rotation);
 
-		if (!m_inputs.empty())
+		if (it != m_inputs.begin())
 		{
-			m_lastInputTime = m_inputs.back().serverTime;
-			m_inputs.clear();
+			m_lastInputTime = std::prev(it)->serverTime;
+			m_inputs.erase(m_inputs.begin(), it);
 		}
 	}
 
-	inline void InputComponent::PushInput(Nz::UInt64 inputTime, const Nz::Vector3f& movement, const Nz::Vector3f& rotation)
+	inline bool InputComponent::PushInput(Nz::UInt64 inputTick, Nz::UInt64 inputTime, const Nz::Vector3f& movement, const Nz::Vector3f& rotation)
 	{
-		assert(inputTime > m_lastInputTime);
+		// Inputs may be received multiple times (as they're sent redundantly), only keep the new ones
+		if (inputTime <= GetLastReceivedInputTime())
+			return false;
+
 		assert(movement.x >= -1.f && movement.x <= 1.f);
 		assert(movement.y >= -1.f && movement.y <= 1.f);
 		assert(movement.z >= -1.f && movement.z <= 1.f);
@@ -40,10 +51,18 @@ namespace ewn
 		assert(rotation.z >= -1.f && rotation.z <= 1.f);
 
 		InputData inputData;
+		inputData.serverTick = inputTick;
 		inputData.serverTime = inputTime;
 		inputData.direction = movement * 50.f;
 		inputData.rotation = rotation * 200.f;
 
 		m_inputs.emplace_back(std::move(inputData));
+		return true;
+	}
+
+	inline void InputComponent::Reset()
+	{
+		m_inputs.clear();
+		m_lastInputTime = 0;
 	}
 }
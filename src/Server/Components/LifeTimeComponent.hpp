@@ -8,6 +8,7 @@
 #define EREWHON_SERVER_LIFETIMECOMPONENT_HPP
 
 #include <NDK/Component.hpp>
+#include <optional>
 
 namespace ewn
 {
@@ -16,14 +17,16 @@ namespace ewn
 		public:
 			inline LifeTimeComponent(float durationInSeconds);
 
-			inline bool DecreaseDuration(float timeInSeconds);
+			inline float GetDuration() const;
+			inline const std::optional<Nz::UInt64>& GetExpirationTick() const;
 
-			inline float GetRemainingDuration() const;
+			inline void SetExpirationTick(Nz::UInt64 tick);
 
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
-			float m_remainingDuration;
+			std::optional<Nz::UInt64> m_expirationTick; //< Set by the LifeTimeSystem
+			float m_duration;
 	};
 }
 
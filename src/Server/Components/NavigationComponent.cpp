@@ -4,20 +4,20 @@
 
 #include <Server/Components/NavigationComponent.hpp>
 #include <Shared/Utils.hpp>
-#include <NDK/Components/NodeComponent.hpp>
+#include <NDK/World.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
 #include <type_traits>
 
 namespace ewn
 {
-	NavigationComponent::NavigationResults NavigationComponent::ComputeMovement(float elapsedTime, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, const Nz::Vector3f& linearVel, const Nz::Vector3f& angularVel)
+	bool NavigationComponent::GetTargetPosition(Nz::Vector3f* targetPos) const
 	{
-		Nz::Vector3f targetPos;
-		bool hasTarget = std::visit([&targetPos](auto&& arg) -> bool
+		return std::visit([targetPos](auto&& arg) -> bool
 		{
 			using T = std::decay_t<decltype(arg)>;
 			if constexpr (std::is_same_v<T, Nz::Vector3f>)
 			{
-				targetPos = arg;
+				*targetPos = arg;
 				return true;
 			}
 			else if constexpr (std::is_same_v<T, Ndk::EntityHandle>)
@@ -25,12 +25,15 @@ namespace ewn
 				if (!arg)
 					return false;
 
-#ifdef NAZARA_COMPILER_MSVC
-				// Looks like MSVC 15.6.6 doesn't like that template keyword here
-				targetPos = arg->GetComponent<Ndk::NodeComponent>().GetPosition();
-#else
-				targetPos = arg->template GetComponent<Ndk::NodeComponent>().GetPosition();
-#endif
+				Ndk::World* world = arg->GetWorld();
+				Ndk::EntityId targetId = arg->GetId();
+
+				// Disabled entities aren't part of the snapshot
+				const TransformSnapshotSystem& transforms = world->GetSystem<TransformSnapshotSystem>();
+				if (!transforms.IsCaptured(targetId))
+					return false;
+
+				*targetPos = transforms.GetPosition(targetId);
 				return true;
 			}
 			else if constexpr (std::is_same_v<T, NoTarget>)
@@ -39,25 +42,6 @@ namespace ewn
 				static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
 
 		}, m_target);
-
-		if (!hasTarget)
-			return { Nz::Vector3f::Zero(), Nz::Vector3f::Zero() };
-
-		Nz::Vector3f desiredHeading = targetPos - position;
-		bool isCloseEnough = (desiredHeading.GetSquaredLength() <= m_triggerDistance * m_triggerDistance);
-
-		desiredHeading.Normalize();
-
-		Nz::Vector3f currentHeading = rotation * Nz::Vector3f::Forward();
-		Nz::Vector3f headingError = currentHeading.CrossProduct(desiredHeading);
-
-		Nz::Vector3f torque = m_headingController.Update(headingError, elapsedTime);
-
-		Nz::Vector3f force = Nz::Vector3f::Zero();
-		if (currentHeading.DotProduct(desiredHeading) > 0.95)
-			force = Nz::Vector3f::Forward();
-
-		return { force, torque, isCloseEnough };
 	}
 
 	Ndk::ComponentIndex NavigationComponent::componentIndex;
@@ -10,57 +10,54 @@
 #include <Nazara/Math/Quaternion.hpp>
 #include <Nazara/Math/Vector3.hpp>
 #include <NDK/Component.hpp>
-#include <Shared/Utils/PidController.hpp>
 #include <functional>
 #include <variant>
 #include <vector>
 
 namespace ewn
 {
+	// Navigation orders of a script-controlled ship, steering itself is computed for every ship at once by the NavigationSystem
 	class NavigationComponent : public Ndk::Component<NavigationComponent>
 	{
 		public:
 			using ProximityCallback = std::function<void()>;
-			struct NavigationResults;
 
 			inline NavigationComponent();
 			~NavigationComponent() = default;
 
-			inline void AddImpulse(const Nz::Vector3f& thrust, Nz::UInt64 expirationTime);
+			inline Nz::UInt32 AddImpulse(const Nz::Vector3f& thrust);
 
 			inline void ClearTarget();
 
-			inline NavigationResults Run(Nz::UInt64 currentTime, float elapsedTime, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, const Nz::Vector3f& linearVel, const Nz::Vector3f& angularVel);
+			inline const Nz::Vector3f& GetImpulseThrust() const;
+			bool GetTargetPosition(Nz::Vector3f* targetPos) const;
+			inline float GetTriggerDistance() const;
+
+			inline void RemoveImpulse(Nz::UInt32 impulseId);
 
 			inline void SetTarget(const Ndk::EntityHandle& entity);
 			inline void SetTarget(const Ndk::EntityHandle& entity, float triggerDistance, ProximityCallback proximityCallback);
 			inline void SetTarget(const Nz::Vector3f& position);
 			inline void SetTarget(const Nz::Vector3f& position, float triggerDistance, ProximityCallback proximityCallback);
 
-			static Ndk::ComponentIndex componentIndex;
+			inline void TriggerProximityCallback();
 
-			struct NavigationResults
-			{
-				Nz::Vector3f thrust;
-				Nz::Vector3f rotation;
-				bool triggerDistance;
-			};
+			static Ndk::ComponentIndex componentIndex;
 
 		private:
-			NavigationResults ComputeMovement(float elapsedTime, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, const Nz::Vector3f& linearVel, const Nz::Vector3f& angularVel);
-
 			struct Impulsion
 			{
-				Nz::UInt64 expirationTime;
+				Nz::UInt32 id;
 				Nz::Vector3f thrust;
 			};
 
 			struct NoTarget {}; //< Fixes std::monostate which GDB fail to demangle
 
 			ProximityCallback m_proximityCallback;
-			PidController<Nz::Vector3f> m_headingController;
 			std::variant<NoTarget, Ndk::EntityHandle, Nz::Vector3f> m_target;
 			std::vector<Impulsion> m_impulses;
+			Nz::UInt32 m_nextImpulseId;
+			Nz::Vector3f m_impulseThrust; //< Sum of active impulses
 			float m_triggerDistance;
 	};
 }
@@ -3,22 +3,30 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Components/NavigationComponent.hpp>
-#include <Nazara/Math/Algorithm.hpp>
+#include <algorithm>
 
 namespace ewn
 {
 	inline NavigationComponent::NavigationComponent() :
-	m_headingController(1.f, 0.f, 0.6382979f)
+	m_nextImpulseId(0),
+	m_impulseThrust(Nz::Vector3f::Zero()),
+	m_triggerDistance(0.f)
 	{
 	}
 
-	inline void NavigationComponent::AddImpulse(const Nz::Vector3f& thrust, Nz::UInt64 expirationTime)
+	// Impulse lasts until removed, expiration is scheduled by the caller (see EngineModule::Impulse)
+	inline Nz::UInt32 NavigationComponent::AddImpulse(const Nz::Vector3f& thrust)
 	{
+		Nz::UInt32 impulseId = m_nextImpulseId++;
+
 		Impulsion impulsion;
-		impulsion.expirationTime = expirationTime;
+		impulsion.id = impulseId;
 		impulsion.thrust = thrust;
 
 		m_impulses.emplace_back(std::move(impulsion));
+		m_impulseThrust += thrust;
+
+		return impulseId;
 	}
 
 	inline void NavigationComponent::ClearTarget()
@@ -26,42 +34,29 @@ namespace ewn
 		m_target = NoTarget{};
 	}
 
-	inline NavigationComponent::NavigationResults NavigationComponent::Run(Nz::UInt64 currentTime, float elapsedTime, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, const Nz::Vector3f& linearVel, const Nz::Vector3f& angularVel)
+	// Sum of active impulses
+	inline const Nz::Vector3f& NavigationComponent::GetImpulseThrust() const
 	{
-		Nz::Vector3f thrustForce = Nz::Vector3f::Zero();
-		Nz::Vector3f rotationForce = Nz::Vector3f::Zero();
-
-		for (auto it = m_impulses.begin(); it != m_impulses.end();)
-		{
-			if (currentTime < it->expirationTime)
-			{
-				thrustForce += it->thrust;
-
-				++it;
-			}
-			else
-				it = m_impulses.erase(it);
-		}
-
-		auto [linearForce, angularForce, isClose] = ComputeMovement(elapsedTime, position, rotation, linearVel, angularVel);
+		return m_impulseThrust;
+	}
 
-		thrustForce += linearForce;
-		rotationForce += angularForce;
+	inline float NavigationComponent::GetTriggerDistance() const
+	{
+		return m_triggerDistance;
+	}
 
-		thrustForce.x = Nz::Clamp(thrustForce.x, -1.f, 1.f);
-		thrustForce.y = Nz::Clamp(thrustForce.y, -1.f, 1.f);
-		thrustForce.z = Nz::Clamp(thrustForce.z, -1.f, 1.f);
-		rotationForce.x = Nz::Clamp(rotationForce.x, -1.f, 1.f);
-		rotationForce.y = Nz::Clamp(rotationForce.y, -1.f, 1.f);
-		rotationForce.z = Nz::Clamp(rotationForce.z, -1.f, 1.f);
+	inline void NavigationComponent::RemoveImpulse(Nz::UInt32 impulseId)
+	{
+		auto it = std::find_if(m_impulses.begin(), m_impulses.end(), [&](const Impulsion& impulsion) { return impulsion.id == impulseId; });
+		if (it == m_impulses.end())
+			return;
 
-		if (isClose && m_proximityCallback)
-		{
-			m_proximityCallback();
-			m_proximityCallback = nullptr;
-		}
+		m_impulses.erase(it);
 
-		return { thrustForce, rotationForce, isClose };
+		// Sum is rebuilt instead of subtracted so floating-point errors don't accumulate
+		m_impulseThrust = Nz::Vector3f::Zero();
+		for (const Impulsion& impulsion : m_impulses)
+			m_impulseThrust += impulsion.thrust;
 	}
 
 	inline void NavigationComponent::SetTarget(const Ndk::EntityHandle& entity)
@@ -87,4 +82,16 @@ namespace ewn
 		m_triggerDistance = triggerDistance;
 		m_proximityCallback = std::move(proximityCallback);
 	}
+
+	// Proximity callback only triggers once
+	inline void NavigationComponent::TriggerProximityCallback()
+	{
+		if (m_proximityCallback)
+		{
+			ProximityCallback callback = std::move(m_proximityCallback);
+			m_proximityCallback = nullptr;
+
+			callback();
+		}
+	}
 }
@@ -19,10 +19,12 @@ namespace ewn
 
 			inline Player* GetOwner() const;
 
+			inline void ResetOwner();
+
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
-			PlayerHandle m_owner;
+			Player* m_owner; //< Reset by the arena when the player leaves it
 	};
 }
 
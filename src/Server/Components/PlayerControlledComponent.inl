@@ -15,4 +15,9 @@ namespace ewn
 	{
 		return m_owner;
 	}
+
+	inline void PlayerControlledComponent::ResetOwner()
+	{
+		m_owner = nullptr;
+	}
 }
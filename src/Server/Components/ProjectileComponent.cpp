@@ -1,10 +0,0 @@
-// Copyright (C) 2018 Jérôme Leclercq
-// This file is part of the "Erewhon Shared" project
-// For conditions of distribution and use, see copyright notice in LICENSE
-
-#include <Server/Components/ProjectileComponent.hpp>
-
-namespace ewn
-{
-	Ndk::ComponentIndex ProjectileComponent::componentIndex;
-}
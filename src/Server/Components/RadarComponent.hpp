@@ -10,50 +10,77 @@
 #include <Nazara/Math/Vector3.hpp>
 #include <NDK/Component.hpp>
 #include <NDK/Entity.hpp>
-#include <unordered_map>
+#include <NDK/EntityList.hpp>
+#include <string>
+#include <vector>
 
 namespace ewn
 {
 	class RadarComponent : public Ndk::Component<RadarComponent>
 	{
+		friend class RadarSystem;
+
 		public:
-			using OnDestructionCallback = std::function<void(Ndk::Entity*)>;
-			using OnLeaveCallback = std::function<void(Ndk::Entity*)>;
+			struct Event;
 
-			RadarComponent() = default;
-			RadarComponent(const RadarComponent& radar);
+			inline RadarComponent();
+			RadarComponent(const RadarComponent& radar) = default;
 			RadarComponent(RadarComponent&&) = delete;
 			~RadarComponent() = default;
 
-			void ClearLockedTargets();
+			inline void ClearLockedTargets();
 
-			void CheckTargetRange(const Nz::Vector3f& position, float maxRange);
+			inline void EnablePassiveScan(bool enable);
 
+			inline float GetDetectionRadius() const;
 			inline std::size_t GetLockedEntityCount() const;
 
-			inline bool IsEntityLocked(Ndk::EntityId entityId);
+			inline bool IsEntityInRange(Ndk::EntityId entityId) const;
+			inline bool IsEntityLocked(Ndk::EntityId entityId) const;
+			inline bool IsPassiveScanEnabled() const;
+
+			inline void LockEntity(const Ndk::EntityHandle& entity);
+
+			template<typename F> void ProcessEvents(F&& callback);
 
-			inline void LockEntity(Ndk::Entity* entity, OnDestructionCallback destructionCallback, OnLeaveCallback leaveCallback);
-			inline void UnlockEntity(Ndk::Entity* entity);
+			inline void SetDetectionRadius(float detectionRadius);
+
+			inline void UnlockEntity(Ndk::EntityId entityId);
 
 			RadarComponent& operator=(const RadarComponent&) = delete;
 			RadarComponent& operator=(RadarComponent&&) = delete;
 
+			enum class EventType
+			{
+				NewObjectInRange,
+				ObjectDestroyed,
+				ObjectLeftRange
+			};
+
+			struct Event
+			{
+				EventType type;
+				Ndk::EntityId entityId;
+				Nz::Vector3f position;
+				std::string objectType; //< Only for NewObjectInRange
+			};
+
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
-			void OnWatchedEntityDestroyed(Ndk::Entity* entity);
-
 			struct LockedTarget
 			{
-				OnDestructionCallback destructionCallback;
-				OnLeaveCallback rangeLeaveCallback;
 				Ndk::EntityHandle target;
-
-				NazaraSlot(Ndk::Entity, OnEntityDestruction, onEntityDestroyed);
+				Ndk::EntityId entityId;
+				Nz::Vector3f lastPosition;
 			};
 
-			std::unordered_map<Ndk::EntityId, LockedTarget> m_lockedTargets;
+			std::vector<Event> m_events; //< Filled by the radar system, until processed
+			std::vector<LockedTarget> m_lockedTargets;
+			Ndk::EntityList m_entitiesInRange;
+			Nz::UInt64 m_lastPassiveScanTime;
+			float m_detectionRadius;
+			bool m_isPassiveScanEnabled;
 	};
 }
 
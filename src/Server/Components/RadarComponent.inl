@@ -3,32 +3,81 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Components/RadarComponent.hpp>
+#include <NDK/World.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <algorithm>
 
 namespace ewn
 {
-	inline std::size_t ewn::RadarComponent::GetLockedEntityCount() const
+	inline RadarComponent::RadarComponent() :
+	m_lastPassiveScanTime(0),
+	m_detectionRadius(0.f),
+	m_isPassiveScanEnabled(true)
+	{
+	}
+
+	inline void RadarComponent::ClearLockedTargets()
+	{
+		m_lockedTargets.clear();
+	}
+
+	inline void RadarComponent::EnablePassiveScan(bool enable)
+	{
+		m_isPassiveScanEnabled = enable;
+	}
+
+	inline float RadarComponent::GetDetectionRadius() const
+	{
+		return m_detectionRadius;
+	}
+
+	inline std::size_t RadarComponent::GetLockedEntityCount() const
 	{
 		return m_lockedTargets.size();
 	}
 
-	inline bool RadarComponent::IsEntityLocked(Ndk::EntityId entityId)
+	inline bool RadarComponent::IsEntityInRange(Ndk::EntityId entityId) const
 	{
-		return m_lockedTargets.find(entityId) != m_lockedTargets.end();
+		return m_entitiesInRange.Has(entityId);
 	}
 
-	inline void RadarComponent::LockEntity(Ndk::Entity* entity, OnDestructionCallback destructionCallback, OnLeaveCallback leaveCallback)
+	inline bool RadarComponent::IsEntityLocked(Ndk::EntityId entityId) const
 	{
-		LockedTarget targetData;
-		targetData.destructionCallback = std::move(destructionCallback);
-		targetData.rangeLeaveCallback = std::move(leaveCallback);
-		targetData.target = entity;
-		targetData.onEntityDestroyed.Connect(entity->OnEntityDestruction, this, &RadarComponent::OnWatchedEntityDestroyed);
+		return std::find_if(m_lockedTargets.begin(), m_lockedTargets.end(), [&](const LockedTarget& lockedTarget) { return lockedTarget.entityId == entityId; }) != m_lockedTargets.end();
+	}
+
+	inline bool RadarComponent::IsPassiveScanEnabled() const
+	{
+		return m_isPassiveScanEnabled;
+	}
+
+	inline void RadarComponent::LockEntity(const Ndk::EntityHandle& entity)
+	{
+		LockedTarget& lockedTarget = m_lockedTargets.emplace_back();
+		lockedTarget.entityId = entity->GetId();
+		lockedTarget.lastPosition = entity->GetWorld()->GetSystem<TransformSnapshotSystem>().GetPosition(entity->GetId());
+		lockedTarget.target = entity;
+	}
+
+	// Callback is called for every event generated by the radar system since the last call
+	template<typename F>
+	void RadarComponent::ProcessEvents(F&& callback)
+	{
+		for (Event& event : m_events)
+			callback(event);
 
-		m_lockedTargets.emplace(entity->GetId(), std::move(targetData));
+		m_events.clear();
+	}
+
+	inline void RadarComponent::SetDetectionRadius(float detectionRadius)
+	{
+		m_detectionRadius = detectionRadius;
 	}
 
-	inline void RadarComponent::UnlockEntity(Ndk::Entity* entity)
+	inline void RadarComponent::UnlockEntity(Ndk::EntityId entityId)
 	{
-		m_lockedTargets.erase(entity->GetId());
+		auto it = std::find_if(m_lockedTargets.begin(), m_lockedTargets.end(), [&](const LockedTarget& lockedTarget) { return lockedTarget.entityId == entityId; });
+		if (it != m_lockedTargets.end())
+			m_lockedTargets.erase(it);
 	}
 }
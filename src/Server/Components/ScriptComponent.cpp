@@ -4,11 +4,11 @@
 
 #include <Server/Components/ScriptComponent.hpp>
 #include <Nazara/Core/CallOnExit.hpp>
-#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Lua/LuaInstance.hpp>
 #include <Nazara/Math/Vector3.hpp>
 #include <NDK/LuaAPI.hpp>
 #include <Server/ServerApplication.hpp>
+#include <Server/Components/ArenaComponent.hpp>
 #include <Server/Components/InputComponent.hpp>
 #include <Server/Components/OwnerComponent.hpp>
 #include <Server/Modules/EngineModule.hpp>
@@ -106,7 +106,7 @@ namespace ewn
 		}
 		m_instance.SetGlobal("Spaceship");
 
-		m_core->PushCallback(0, "OnStart");
+		m_core->PushCallback(0, SpaceshipCore::CallbackType::OnStart);
 
 		return true;
 	}
@@ -120,8 +120,8 @@ namespace ewn
 
 		m_core->Run();
 
-		std::string callbackName;
-		SpaceshipCore::CallbackArgFunction argFunction;
+		SpaceshipCore::CallbackType callbackType;
+		SpaceshipCore::CallbackArgs callbackArgs;
 
 		Nz::CallOnExit incrementTickCount([&]()
 		{
@@ -130,12 +130,8 @@ namespace ewn
 
 		if (m_tickCounter >= 0.5f)
 		{
-			callbackName = "OnTick";
-			argFunction = [](Nz::LuaState& state)
-			{
-				state.Push(0.5f);
-				return 1;
-			};
+			callbackType = SpaceshipCore::CallbackType::OnTick;
+			callbackArgs = SpaceshipCore::TickArgs{ 0.5f };
 
 			m_tickCounter -= 0.5f;
 		}
@@ -145,21 +141,20 @@ namespace ewn
 			if (!callback)
 				return true;
 
-			callbackName = std::move(callback->first);
-			argFunction = std::move(callback->second);
+			callbackType = callback->first;
+			callbackArgs = std::move(callback->second);
 		}
 
 		incrementTickCount.CallAndReset();
 
 		if (m_instance.GetGlobal("Spaceship") == Nz::LuaType_Table)
 		{
-			if (m_instance.GetField(callbackName) == Nz::LuaType_Function)
+			if (m_instance.GetField(SpaceshipCore::GetCallbackName(callbackType)) == Nz::LuaType_Function)
 			{
 				m_instance.PushValue(-2); // Spaceship
 
 				unsigned int argCount = 1;
-				if (argFunction)
-					argCount += argFunction(m_instance);
+				argCount += SpaceshipCore::PushCallbackArgs(m_instance, callbackArgs);
 
 				if (!m_instance.Call(argCount, 0))
 				{
@@ -180,7 +175,7 @@ namespace ewn
 
 	void ScriptComponent::SendMessage(BotMessageType messageType, Nz::String message)
 	{
-		Nz::UInt64 now = Nz::GetElapsedMilliseconds();
+		Nz::UInt64 now = m_entity->GetComponent<ArenaComponent>().GetArena().GetCurrentTime();
 		//if (messageType != BotMessageType::Error && now - m_lastMessageTime < 100)
 		//	return;
 
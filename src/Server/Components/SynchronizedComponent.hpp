@@ -29,6 +29,8 @@ namespace ewn
 
 			inline void ResetPriorityAccumulator();
 
+			inline void SetName(std::string name);
+
 			static Ndk::ComponentIndex componentIndex;
 
 		private:
@@ -60,4 +60,9 @@ namespace ewn
 	{
 		m_priorityAccumulator = 0;
 	}
+
+	inline void SynchronizedComponent::SetName(std::string name)
+	{
+		m_name = std::move(name);
+	}
 }
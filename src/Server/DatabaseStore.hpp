@@ -19,6 +19,7 @@ namespace ewn
 	class DatabaseStore
 	{
 		friend class DatabaseLoader;
+		friend class ServerApplication;
 
 		public:
 			virtual ~DatabaseStore();
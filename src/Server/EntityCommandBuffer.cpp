@@ -0,0 +1,87 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/EntityCommandBuffer.hpp>
+#include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Shared/Utils.hpp>
+#include <Server/Arena.hpp>
+#include <Server/Components/HealthComponent.hpp>
+#include <Server/Systems/PhysicsActivitySystem.hpp>
+
+namespace ewn
+{
+	// Must be called from the arena thread, commands are applied in recording order
+	void EntityCommandBuffer::Playback(Arena& arena)
+	{
+		Ndk::World& world = arena.m_world;
+		PhysicsActivitySystem& physicsActivity = world.GetSystem<PhysicsActivitySystem>();
+
+		auto GetEntity = [&](Ndk::EntityId entityId) -> const Ndk::EntityHandle&
+		{
+			if (entityId == NoEntity || !world.IsEntityIdValid(entityId))
+				return Ndk::EntityHandle::InvalidHandle;
+
+			return world.GetEntity(entityId);
+		};
+
+		// Commands may record other commands (a death killing entities for example), those are played back as well
+		for (std::size_t i = 0; i < m_commands.size(); ++i)
+		{
+			Command command = std::move(m_commands[i]);
+
+			std::visit([&](auto&& arg)
+			{
+				using T = std::decay_t<decltype(arg)>;
+
+				if constexpr (std::is_same_v<T, AddComponentCommand>)
+				{
+					if (const Ndk::EntityHandle& entity = GetEntity(arg.entityId))
+						arg.addComponent(entity);
+				}
+				else if constexpr (std::is_same_v<T, AddForceCommand>)
+				{
+					const Ndk::EntityHandle& entity = GetEntity(arg.entityId);
+					if (!entity || !entity->IsEnabled()) //< Parked spaceship
+						return;
+
+					// Forces would be lost on a parked body
+					physicsActivity.WakeUp(entity);
+
+					auto& entityPhys = entity->GetComponent<Ndk::PhysicsComponent3D>();
+					if (arg.isTorque)
+						entityPhys.AddTorque(arg.force, arg.coordSys);
+					else
+						entityPhys.AddForce(arg.force, arg.coordSys);
+				}
+				else if constexpr (std::is_same_v<T, CreateEntityCommand>)
+				{
+					const Ndk::EntityHandle& entity = arena.CreateEntity(arg.archetypeId, std::move(arg.name), arg.owner, arg.position, arg.rotation);
+					if (arg.onCreated)
+						arg.onCreated(entity);
+				}
+				else if constexpr (std::is_same_v<T, DamageCommand>)
+				{
+					const Ndk::EntityHandle& entity = GetEntity(arg.entityId);
+					if (!entity || !entity->IsEnabled() || !entity->HasComponent<HealthComponent>())
+						return;
+
+					auto& health = entity->GetComponent<HealthComponent>();
+					if (health.GetHealth() > 0) //< Don't kill the same entity twice
+						health.Damage(arg.damage, GetEntity(arg.attackerId));
+				}
+				else if constexpr (std::is_same_v<T, DestroyCommand>)
+				{
+					if (const Ndk::EntityHandle& entity = GetEntity(arg.entityId))
+						entity->Kill();
+				}
+				else
+					static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+			}, command);
+		}
+
+		m_commands.clear();
+	}
+
+	thread_local EntityCommandBuffer* EntityCommandBuffer::s_boundBuffer = nullptr;
+}
@@ -0,0 +1,124 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_ENTITYCOMMANDBUFFER_HPP
+#define EREWHON_SERVER_ENTITYCOMMANDBUFFER_HPP
+
+#include <Nazara/Core/Enums.hpp>
+#include <Nazara/Math/Quaternion.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/Entity.hpp>
+#include <functional>
+#include <limits>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace ewn
+{
+	class Arena;
+	class Player;
+
+	// Records structural changes (entity creation/destruction, components) and physics forces to apply them later, at a sync point
+	// Entities are referenced by id, they stay valid until the next world refresh which only happens once every buffer has been played back
+	// A buffer is only filled by one thread at a time, the system scheduler binds one buffer per system to the thread running it
+	class EntityCommandBuffer
+	{
+		public:
+			class Binding;
+			using EntityCallback = std::function<void(const Ndk::EntityHandle& entity)>;
+
+			EntityCommandBuffer() = default;
+			EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+			EntityCommandBuffer(EntityCommandBuffer&&) = default;
+			~EntityCommandBuffer() = default;
+
+			template<typename T, typename... Args> void AddComponent(Ndk::Entity* entity, Args&&... args);
+			inline void AddForce(Ndk::Entity* entity, const Nz::Vector3f& force, Nz::CoordSys coordSys = Nz::CoordSys_Global);
+			inline void AddTorque(Ndk::Entity* entity, const Nz::Vector3f& torque, Nz::CoordSys coordSys = Nz::CoordSys_Global);
+
+			inline void Clear();
+
+			inline void CreateEntity(std::size_t archetypeId, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, EntityCallback onCreated = nullptr);
+
+			inline void Damage(Ndk::Entity* entity, Nz::UInt16 damage, Ndk::Entity* attacker);
+			inline void Destroy(Ndk::Entity* entity);
+
+			inline bool IsEmpty() const;
+
+			void Playback(Arena& arena);
+
+			EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+			EntityCommandBuffer& operator=(EntityCommandBuffer&&) = default;
+
+			static inline EntityCommandBuffer* GetBoundBuffer();
+
+			// Makes a buffer the one of the current thread for its lifetime (previous binding is restored on destruction)
+			class Binding
+			{
+				public:
+					inline Binding(EntityCommandBuffer& buffer);
+					Binding(const Binding&) = delete;
+					Binding(Binding&&) = delete;
+					inline ~Binding();
+
+					Binding& operator=(const Binding&) = delete;
+					Binding& operator=(Binding&&) = delete;
+
+				private:
+					EntityCommandBuffer* m_previousBuffer;
+			};
+
+		private:
+			struct AddComponentCommand
+			{
+				Ndk::EntityId entityId;
+				EntityCallback addComponent;
+			};
+
+			struct AddForceCommand
+			{
+				Ndk::EntityId entityId;
+				Nz::CoordSys coordSys;
+				Nz::Vector3f force;
+				bool isTorque;
+			};
+
+			struct CreateEntityCommand
+			{
+				std::size_t archetypeId;
+				std::string name;
+				EntityCallback onCreated;
+				Nz::Quaternionf rotation;
+				Nz::Vector3f position;
+				Player* owner;
+			};
+
+			struct DamageCommand
+			{
+				Ndk::EntityId attackerId;
+				Ndk::EntityId entityId;
+				Nz::UInt16 damage;
+			};
+
+			struct DestroyCommand
+			{
+				Ndk::EntityId entityId;
+			};
+
+			using Command = std::variant<AddComponentCommand, AddForceCommand, CreateEntityCommand, DamageCommand, DestroyCommand>;
+
+			static constexpr Ndk::EntityId NoEntity = std::numeric_limits<Ndk::EntityId>::max();
+
+			std::vector<Command> m_commands; //< In recording order
+
+			static thread_local EntityCommandBuffer* s_boundBuffer;
+	};
+}
+
+#include <Server/EntityCommandBuffer.inl>
+
+#endif // EREWHON_SERVER_ENTITYCOMMANDBUFFER_HPP
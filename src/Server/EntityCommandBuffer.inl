@@ -0,0 +1,105 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/EntityCommandBuffer.hpp>
+#include <tuple>
+
+namespace ewn
+{
+	// Component arguments are copied until playback
+	template<typename T, typename... Args>
+	void EntityCommandBuffer::AddComponent(Ndk::Entity* entity, Args&&... args)
+	{
+		AddComponentCommand command;
+		command.entityId = entity->GetId();
+		command.addComponent = [arguments = std::make_tuple(std::forward<Args>(args)...)](const Ndk::EntityHandle& target)
+		{
+			std::apply([&](const auto&... componentArgs)
+			{
+				target->AddComponent<T>(componentArgs...);
+			}, arguments);
+		};
+
+		m_commands.emplace_back(std::move(command));
+	}
+
+	inline void EntityCommandBuffer::AddForce(Ndk::Entity* entity, const Nz::Vector3f& force, Nz::CoordSys coordSys)
+	{
+		AddForceCommand command;
+		command.coordSys = coordSys;
+		command.entityId = entity->GetId();
+		command.force = force;
+		command.isTorque = false;
+
+		m_commands.emplace_back(std::move(command));
+	}
+
+	inline void EntityCommandBuffer::AddTorque(Ndk::Entity* entity, const Nz::Vector3f& torque, Nz::CoordSys coordSys)
+	{
+		AddForceCommand command;
+		command.coordSys = coordSys;
+		command.entityId = entity->GetId();
+		command.force = torque;
+		command.isTorque = true;
+
+		m_commands.emplace_back(std::move(command));
+	}
+
+	inline void EntityCommandBuffer::Clear()
+	{
+		m_commands.clear();
+	}
+
+	inline void EntityCommandBuffer::CreateEntity(std::size_t archetypeId, std::string name, Player* owner, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, EntityCallback onCreated)
+	{
+		CreateEntityCommand command;
+		command.archetypeId = archetypeId;
+		command.name = std::move(name);
+		command.onCreated = std::move(onCreated);
+		command.owner = owner;
+		command.position = position;
+		command.rotation = rotation;
+
+		m_commands.emplace_back(std::move(command));
+	}
+
+	inline void EntityCommandBuffer::Damage(Ndk::Entity* entity, Nz::UInt16 damage, Ndk::Entity* attacker)
+	{
+		DamageCommand command;
+		command.attackerId = (attacker) ? attacker->GetId() : NoEntity;
+		command.damage = damage;
+		command.entityId = entity->GetId();
+
+		m_commands.emplace_back(std::move(command));
+	}
+
+	inline void EntityCommandBuffer::Destroy(Ndk::Entity* entity)
+	{
+		DestroyCommand command;
+		command.entityId = entity->GetId();
+
+		m_commands.emplace_back(std::move(command));
+	}
+
+	inline bool EntityCommandBuffer::IsEmpty() const
+	{
+		return m_commands.empty();
+	}
+
+	inline EntityCommandBuffer* EntityCommandBuffer::GetBoundBuffer()
+	{
+		return s_boundBuffer;
+	}
+
+	inline EntityCommandBuffer::Binding::Binding(EntityCommandBuffer& buffer) :
+	m_previousBuffer(s_boundBuffer)
+	{
+		s_boundBuffer = &buffer;
+	}
+
+	inline EntityCommandBuffer::Binding::~Binding()
+	{
+		s_boundBuffer = m_previousBuffer;
+	}
+}
@@ -4,8 +4,10 @@
 
 #include <Server/Modules/EngineModule.hpp>
 #include <NDK/LuaAPI.hpp>
+#include <Server/Arena.hpp>
+#include <Server/Components/ArenaComponent.hpp>
 #include <Server/Components/NavigationComponent.hpp>
-#include <Server/ServerApplication.hpp>
+#include <mutex>
 
 namespace ewn
 {
@@ -15,18 +17,29 @@ namespace ewn
 		impulse.y = Nz::Clamp(impulse.y, -1.f, 1.f);
 		impulse.z = Nz::Clamp(impulse.z, -1.f, 1.f);
 
-		NavigationComponent& spaceshipNavigation = GetSpaceship()->GetComponent<NavigationComponent>();
-		spaceshipNavigation.AddImpulse(impulse, ServerApplication::GetAppTime() + Nz::UInt64(duration * 1'000));
+		const Ndk::EntityHandle& spaceship = GetSpaceship();
+		Arena& arena = spaceship->GetComponent<ArenaComponent>().GetArena();
+
+		NavigationComponent& spaceshipNavigation = spaceship->GetComponent<NavigationComponent>();
+		Nz::UInt32 impulseId = spaceshipNavigation.AddImpulse(impulse);
+
+		Nz::UInt64 expirationTick = arena.GetTickAt(arena.GetCurrentTime() + Nz::UInt64(duration * 1'000));
+		arena.GetTimerWheel().Schedule(expirationTick, [spaceship, impulseId]()
+		{
+			if (spaceship && spaceship->HasComponent<NavigationComponent>())
+				spaceship->GetComponent<NavigationComponent>().RemoveImpulse(impulseId);
+		});
 	}
 
 	void EngineModule::Register(Nz::LuaState& lua)
 	{
-		if (!s_binding)
+		static std::once_flag bindingFlag;
+		std::call_once(bindingFlag, []()
 		{
 			s_binding.emplace("Engine");
 
 			s_binding->BindMethod("Impulse", &EngineModule::Impulse);
-		}
+		});
 
 		s_binding->Register(lua);
 
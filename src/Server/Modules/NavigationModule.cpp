@@ -7,6 +7,7 @@
 #include <Server/Components/NavigationComponent.hpp>
 #include <Server/Components/RadarComponent.hpp>
 #include <iostream>
+#include <mutex>
 
 namespace ewn
 {
@@ -42,7 +43,7 @@ namespace ewn
 				if (!moduleHandle)
 					return;
 
-				moduleHandle->PushCallback("OnNavigationDestinationReached");
+				moduleHandle->PushCallback(SpaceshipCore::CallbackType::OnNavigationDestinationReached);
 			});
 		}
 		else
@@ -63,7 +64,7 @@ namespace ewn
 			if (!moduleHandle)
 				return;
 
-			moduleHandle->PushCallback("OnNavigationDestinationReached");
+			moduleHandle->PushCallback(SpaceshipCore::CallbackType::OnNavigationDestinationReached);
 		});
 	}
 
@@ -75,7 +76,8 @@ namespace ewn
 
 	void NavigationModule::Register(Nz::LuaState& lua)
 	{
-		if (!s_binding)
+		static std::once_flag bindingFlag;
+		std::call_once(bindingFlag, []()
 		{
 			s_binding.emplace("Navigation");
 
@@ -132,7 +134,7 @@ namespace ewn
 			});
 
 			s_binding->BindMethod("Stop", &NavigationModule::Stop);
-		}
+		});
 
 		s_binding->Register(lua);
 
@@ -14,6 +14,6 @@ namespace ewn
 		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
 		Arena& spaceshipArena = spaceship->GetComponent<ewn::ArenaComponent>();
 
-		spaceshipArena.CreatePlasmaProjectile(nullptr, spaceship, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
+		spaceshipArena.CreatePlasmaProjectile(spaceship, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
 	}
 }
@@ -4,17 +4,15 @@
 
 #include <Server/Modules/RadarModule.hpp>
 #include <Nazara/Core/Clock.hpp>
-#include <Nazara/Math/BoundingVolume.hpp>
-#include <Nazara/Physics3D/PhysWorld3D.hpp>
 #include <NDK/LuaAPI.hpp>
 #include <NDK/World.hpp>
-#include <NDK/Components/NodeComponent.hpp>
-#include <NDK/Components/PhysicsComponent3D.hpp>
-#include <NDK/Systems/PhysicsSystem3D.hpp>
 #include <Server/Components/RadarComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
 #include <Server/Scripting/LuaTypes.hpp>
+#include <Server/Systems/SpatialIndexSystem.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
 #include <iostream>
+#include <mutex>
 
 namespace ewn
 {
@@ -24,41 +22,44 @@ namespace ewn
 		radar.ClearLockedTargets();
 	}
 
+	void RadarModule::EnablePassiveScan(bool enable)
+	{
+		RadarComponent& radar = GetSpaceship()->GetComponent<RadarComponent>();
+		radar.EnablePassiveScan(enable);
+	}
+
 	std::optional<RadarModule::TargetInfo> RadarModule::GetTargetInfo(Ndk::EntityId targetId)
 	{
 		const Ndk::EntityHandle& spaceship = GetSpaceship();
 		Ndk::World* world = spaceship->GetWorld();
 
-		if (!m_entitiesInRadius.Has(targetId))
+		RadarComponent& radar = spaceship->GetComponent<RadarComponent>();
+		if (!radar.IsEntityInRange(targetId))
 			return {};
 
 		const Ndk::EntityHandle& targetEntity = world->GetEntity(targetId);
 
-		auto& nodeComponent = targetEntity->GetComponent<Ndk::NodeComponent>();
-
 		TargetInfo targetInfo;
 
 		if (targetEntity->HasComponent<SynchronizedComponent>())
 			targetInfo.name = targetEntity->GetComponent<SynchronizedComponent>().GetName();
 
-		targetInfo.position = nodeComponent.GetPosition();
-		targetInfo.rotation = nodeComponent.GetRotation();
-
-		if (targetEntity->HasComponent<Ndk::PhysicsComponent3D>())
-		{
-			auto& physComponent = targetEntity->GetComponent<Ndk::PhysicsComponent3D>();
-			targetInfo.angularVelocity = physComponent.GetAngularVelocity();
-			targetInfo.linearVelocity = physComponent.GetLinearVelocity();
-		}
-		else
-		{
-			targetInfo.angularVelocity = Nz::Vector3f::Zero();
-			targetInfo.linearVelocity = Nz::Vector3f::Zero();
-		}
+		// Velocities of entities without physics are zero
+		const TransformSnapshotSystem& transforms = world->GetSystem<TransformSnapshotSystem>();
+		targetInfo.angularVelocity = transforms.GetAngularVelocity(targetId);
+		targetInfo.linearVelocity = transforms.GetLinearVelocity(targetId);
+		targetInfo.position = transforms.GetPosition(targetId);
+		targetInfo.rotation = transforms.GetRotation(targetId);
 
 		return targetInfo;
 	}
 
+	bool RadarModule::IsPassiveScanEnabled() const
+	{
+		RadarComponent& radar = GetSpaceship()->GetComponent<RadarComponent>();
+		return radar.IsPassiveScanEnabled();
+	}
+
 	bool RadarModule::IsTargetLocked(Ndk::EntityId targetId) const
 	{
 		RadarComponent& radar = GetSpaceship()->GetComponent<RadarComponent>();
@@ -73,70 +74,61 @@ namespace ewn
 		if (!world->IsEntityIdValid(targetId))
 			return false;
 
-		if (!m_entitiesInRadius.Has(targetId))
+		RadarComponent& radar = spaceship->GetComponent<RadarComponent>();
+		if (!radar.IsEntityInRange(targetId))
 			return false;
 
-		RadarComponent& radar = spaceship->GetComponent<RadarComponent>();
+		if (radar.IsEntityLocked(targetId))
+			return true;
+
 		if (radar.GetLockedEntityCount() + 1 > m_maxLockableTargets)
 			return false;
 
 		const Ndk::EntityHandle& targetEntity = world->GetEntity(targetId);
 
-		radar.LockEntity(targetEntity,
-		[moduleHandle = CreateHandle()](Ndk::Entity* entity)
-		{
-			if (!moduleHandle)
-				return;
+		radar.LockEntity(targetEntity);
 
-			moduleHandle->RemoveEntityFromRadius(entity);
+		return true;
+	}
 
-			auto& nodeComponent = entity->GetComponent<Ndk::NodeComponent>();
+	std::vector<RadarModule::ScanResult> RadarModule::ScanInCone(const Nz::Vector3f& direction)
+	{
+		const Ndk::EntityHandle& spaceship = GetSpaceship();
 
-			moduleHandle->PushCallback("OnRadarObjectDestroyed", [id = entity->GetId(), lastPos = nodeComponent.GetPosition()](Nz::LuaState& state)
-			{
-				state.Push(id);
-				state.Push(LuaVec3(lastPos));
-				return 2;
-			}, false);
-		},
-		[moduleHandle = CreateHandle()](Ndk::Entity* entity)
-		{
-			if (!moduleHandle)
-				return;
+		Ndk::World* world = spaceship->GetWorld();
+		const SpatialGrid& spatialGrid = world->GetSystem<SpatialIndexSystem>().GetGrid();
+		const TransformSnapshotSystem& transforms = world->GetSystem<TransformSnapshotSystem>();
 
-			moduleHandle->RemoveEntityFromRadius(entity);
+		// Direction is relative to the spaceship
+		Nz::Vector3f scanDirection = transforms.GetRotation(spaceship->GetId()) * direction;
 
-			auto& nodeComponent = entity->GetComponent<Ndk::NodeComponent>();
+		std::vector<ScanResult> results;
+		spatialGrid.ForEachInCone(transforms.GetPosition(spaceship->GetId()), scanDirection, ConeScanHalfAngle, m_detectionRadius, [&](const SpatialGrid::Entry& entry)
+		{
+			if (entry.entityId == spaceship->GetId())
+				return;
 
-			moduleHandle->PushCallback("OnRadarObjectLeftRange", [id = entity->GetId(), lastPos = nodeComponent.GetPosition()](Nz::LuaState& state)
-			{
-				state.Push(id);
-				state.Push(LuaVec3(lastPos));
+			const Ndk::EntityHandle& entity = world->GetEntity(entry.entityId);
 
-				return 2;
-			}, false);
+			ScanResult& result = results.emplace_back();
+			result.id = entry.entityId;
+			result.position = entry.position;
+			result.type = entity->GetComponent<SynchronizedComponent>().GetType();
 		});
 
-		return true;
+		return results;
 	}
 
 	void RadarModule::UnlockTarget(Ndk::EntityId targetId)
 	{
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		Ndk::World* world = spaceship->GetWorld();
-
-		if (!world->IsEntityIdValid(targetId))
-			return;
-
-		const Ndk::EntityHandle& targetEntity = world->GetEntity(targetId);
-
-		RadarComponent& radar = spaceship->GetComponent<RadarComponent>();
-		radar.UnlockEntity(targetEntity);
+		RadarComponent& radar = GetSpaceship()->GetComponent<RadarComponent>();
+		radar.UnlockEntity(targetId);
 	}
 
 	void RadarModule::Register(Nz::LuaState& lua)
 	{
-		if (!s_binding)
+		static std::once_flag bindingFlag;
+		std::call_once(bindingFlag, []()
 		{
 			s_binding.emplace("Radar");
 
@@ -149,7 +141,25 @@ namespace ewn
 			s_binding->BindMethod("UnlockTarget", &RadarModule::UnlockTarget);
 
 			// Workaround for value reply bug
-			//s_binding->BindMethod("ScanInCone", &RadarModule::ScanInCone);
+			s_binding->BindMethod("ScanInCone", [](Nz::LuaState& state, RadarModule* radar, std::size_t /*argCount*/)
+			{
+				int argIndex = 2;
+				std::vector<ScanResult> results = radar->ScanInCone(state.Check<Nz::Vector3f>(&argIndex));
+
+				state.PushTable(results.size());
+				for (std::size_t i = 0; i < results.size(); ++i)
+				{
+					state.PushInteger(i + 1);
+					state.PushTable(0, 3);
+						state.PushField("id", results[i].id);
+						state.PushField("position", results[i].position);
+						state.PushField("type", results[i].type);
+					state.SetTable();
+				}
+
+				return 1;
+			});
+
 			s_binding->BindMethod("GetTargetInfo", [](Nz::LuaState& state, RadarModule* radar, std::size_t /*argCount*/)
 			{
 				int argIndex = 2;
@@ -168,7 +178,7 @@ namespace ewn
 
 				return 1;
 			});
-		}
+		});
 
 		s_binding->Register(lua);
 
@@ -177,67 +187,32 @@ namespace ewn
 
 	void RadarModule::Run()
 	{
-		if (m_isPassiveScanEnabled)
+		// Scans and range checks are done for every radar at once by the radar system, forward their results to the script
+		RadarComponent& radar = GetSpaceship()->GetComponent<RadarComponent>();
+		radar.ProcessEvents([&](RadarComponent::Event& event)
 		{
-			Nz::UInt64 now = ServerApplication::GetAppTime();
-			if (now - m_lastPassiveScanTime > 500)
+			switch (event.type)
 			{
-				PerformScan();
-				m_lastPassiveScanTime = now;
-			}
-		}
-
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
-		auto& spaceshipRadar = spaceship->GetComponent<RadarComponent>();
-
-		spaceshipRadar.CheckTargetRange(spaceshipNode.GetPosition(), m_detectionRadius);
-	}
-
-	void RadarModule::Initialize(Ndk::Entity* spaceship)
-	{
-		spaceship->AddComponent<RadarComponent>();
-	}
-
-	void RadarModule::PerformScan()
-	{
-		const Ndk::EntityHandle& spaceship = GetSpaceship();
-		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
-		auto& spaceshipPhys = spaceship->GetComponent<Ndk::PhysicsComponent3D>();
-
-		Nz::Vector3f position = spaceshipNode.GetPosition();
-		Nz::Boxf detectionBox = Nz::Boxf(position - Nz::Vector3f(m_detectionRadius), position + Nz::Vector3f(m_detectionRadius));
+				case RadarComponent::EventType::NewObjectInRange:
+					PushCallback(SpaceshipCore::CallbackType::OnRadarNewObjectInRange, SpaceshipCore::RadarNewObjectArgs{ event.entityId, event.position, std::move(event.objectType) }, false);
+					break;
 
-		Ndk::World* world = spaceship->GetWorld();
-		Nz::PhysWorld3D& physWorld = world->GetSystem<Ndk::PhysicsSystem3D>().GetWorld();
-		float maxSquaredRadius = m_detectionRadius * m_detectionRadius;
-		physWorld.ForEachBodyInAABB(detectionBox, [&](Nz::RigidBody3D& body)
-		{
-			Nz::Vector3f bodyPosition = body.GetPosition();
-			if (bodyPosition.SquaredDistance(position) < maxSquaredRadius)
-			{
-				Ndk::EntityId bodyId = static_cast<Ndk::EntityId>(reinterpret_cast<std::ptrdiff_t>(body.GetUserdata()));
-				if (!m_entitiesInRadius.Has(bodyId) && bodyId != spaceship->GetId())
+				case RadarComponent::EventType::ObjectDestroyed:
+				case RadarComponent::EventType::ObjectLeftRange:
 				{
-					const Ndk::EntityHandle& bodyEntity = world->GetEntity(bodyId);
-					auto& syncComponent = bodyEntity->GetComponent<SynchronizedComponent>();
-
-					m_entitiesInRadius.Insert(bodyEntity);
-
-					PushCallback("OnRadarNewObjectInRange", [id = bodyId, type = syncComponent.GetType(), bodyPosition](Nz::LuaState& state)
-					{
-						state.Push(id);
-						state.Push(type);
-						state.Push(LuaVec3(bodyPosition));
-						return 3;
-					},
-					false);
+					SpaceshipCore::CallbackType callbackType = (event.type == RadarComponent::EventType::ObjectDestroyed) ? SpaceshipCore::CallbackType::OnRadarObjectDestroyed : SpaceshipCore::CallbackType::OnRadarObjectLeftRange;
+					PushCallback(callbackType, SpaceshipCore::RadarObjectArgs{ event.entityId, event.position }, false);
+					break;
 				}
 			}
-
-			return true;
 		});
 	}
 
+	void RadarModule::Initialize(Ndk::Entity* spaceship)
+	{
+		RadarComponent& radar = spaceship->AddComponent<RadarComponent>();
+		radar.SetDetectionRadius(m_detectionRadius);
+	}
+
 	std::optional<Nz::LuaClass<RadarModuleHandle>> RadarModule::s_binding;
 }
@@ -10,10 +10,11 @@
 #include <Nazara/Core/HandledObject.hpp>
 #include <Nazara/Core/ObjectHandle.hpp>
 #include <Nazara/Lua/LuaClass.hpp>
-#include <NDK/EntityList.hpp>
+#include <Nazara/Math/Algorithm.hpp>
 #include <Server/SpaceshipModule.hpp>
 #include <Server/Scripting/LuaMathTypes.hpp>
 #include <optional>
+#include <vector>
 
 namespace ewn
 {
@@ -24,6 +25,7 @@ namespace ewn
 	class RadarModule : public SpaceshipModule, public Nz::HandledObject<RadarModule>
 	{
 		public:
+			struct ScanResult;
 			struct TargetInfo;
 
 			inline RadarModule(SpaceshipCore* core, const Ndk::EntityHandle& spaceship, float detectionRadius, std::size_t maxLockableTarget);
@@ -32,20 +34,30 @@ namespace ewn
 			// Script functions
 			void ClearLockedTargets();
 
-			inline void EnablePassiveScan(bool enable);
+			void EnablePassiveScan(bool enable);
 
 			std::optional<TargetInfo> GetTargetInfo(Ndk::EntityId targetId);
 
-			inline bool IsPassiveScanEnabled() const;
+			bool IsPassiveScanEnabled() const;
 			bool IsTargetLocked(Ndk::EntityId targetId) const;
 
 			bool LockTarget(Ndk::EntityId targetId);
+
+			std::vector<ScanResult> ScanInCone(const Nz::Vector3f& direction);
+
 			void UnlockTarget(Ndk::EntityId targetId);
 
 			// C++ functions
 			void Register(Nz::LuaState& lua) override;
 			void Run() override;
 
+			struct ScanResult
+			{
+				Ndk::EntityId id;
+				std::string type;
+				ewn::LuaVec3 position;
+			};
+
 			struct TargetInfo
 			{
 				std::string name;
@@ -57,14 +69,11 @@ namespace ewn
 
 		private:
 			void Initialize(Ndk::Entity* spaceship) override;
-			void PerformScan();
-			inline void RemoveEntityFromRadius(Ndk::Entity* entity);
 
 			std::size_t m_maxLockableTargets;
-			Ndk::EntityList m_entitiesInRadius;
-			Nz::UInt64 m_lastPassiveScanTime;
 			float m_detectionRadius;
-			bool m_isPassiveScanEnabled;
+
+			static constexpr float ConeScanHalfAngle = Nz::DegreeToRadian(60.f); //< Six scans along the axes cover every direction
 
 			static std::optional<Nz::LuaClass<RadarModuleHandle>> s_binding;
 	};
@@ -9,25 +9,9 @@ namespace ewn
 	inline RadarModule::RadarModule(SpaceshipCore* core, const Ndk::EntityHandle & spaceship, float detectionRadius, std::size_t maxLockableTarget) :
 	SpaceshipModule(core, spaceship, true),
 	m_maxLockableTargets(maxLockableTarget),
-	m_detectionRadius(detectionRadius),
-	m_isPassiveScanEnabled(true)
+	m_detectionRadius(detectionRadius)
 	{
 	}
-
-	inline void RadarModule::EnablePassiveScan(bool enable)
-	{
-		m_isPassiveScanEnabled = enable;
-	}
-
-	inline bool RadarModule::IsPassiveScanEnabled() const
-	{
-		return m_isPassiveScanEnabled;
-	}
-
-	inline void RadarModule::RemoveEntityFromRadius(Ndk::Entity* entity)
-	{
-		m_entitiesInRadius.Remove(entity);
-	}
 }
 
 namespace Nz
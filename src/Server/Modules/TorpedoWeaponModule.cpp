@@ -14,6 +14,6 @@ namespace ewn
 		auto& spaceshipNode = spaceship->GetComponent<Ndk::NodeComponent>();
 		Arena& spaceshipArena = spaceship->GetComponent<ewn::ArenaComponent>();
 
-		spaceshipArena.CreateTorpedo(nullptr, spaceship, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
+		spaceshipArena.CreateTorpedo(spaceship, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
 	}
 }
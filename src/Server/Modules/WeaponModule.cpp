@@ -3,13 +3,15 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Modules/WeaponModule.hpp>
-#include <Nazara/Core/Clock.hpp>
+#include <Server/Arena.hpp>
+#include <Server/Components/ArenaComponent.hpp>
+#include <mutex>
 
 namespace ewn
 {
 	void WeaponModule::Shoot()
 	{
-		Nz::UInt64 currentTime = Nz::GetElapsedMilliseconds();
+		Nz::UInt64 currentTime = GetSpaceship()->GetComponent<ArenaComponent>().GetArena().GetCurrentTime();
 		if (currentTime - m_lastShootTime < 500)
 			return;
 
@@ -20,12 +22,13 @@ namespace ewn
 
 	void WeaponModule::Register(Nz::LuaState& lua)
 	{
-		if (!s_binding)
+		static std::once_flag bindingFlag;
+		std::call_once(bindingFlag, []()
 		{
 			s_binding.emplace("Weapon");
 
 			s_binding->BindMethod("Shoot", &WeaponModule::Shoot);
-		}
+		});
 
 		s_binding->Register(lua);
 
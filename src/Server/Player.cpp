@@ -7,32 +7,33 @@
 #include <NDK/Components/PhysicsComponent3D.hpp>
 #include <Server/Arena.hpp>
 #include <Server/ServerApplication.hpp>
+#include <Server/Components/ArenaComponent.hpp>
 #include <Server/Components/InputComponent.hpp>
 #include <Server/Components/PlayerControlledComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
+#include <Server/Systems/SpatialIndexSystem.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace ewn
 {
 	Player::Player(ServerApplication* app, std::size_t peerId, NetworkReactor& reactor, const ServerCommandStore& commandStore) :
 	m_arena(nullptr),
+	m_joinedArena(nullptr),
 	m_app(app),
 	m_networkReactor(reactor),
 	m_commandStore(commandStore),
 	m_peerId(peerId),
 	m_permissionLevel(0),
 	m_databaseId(0),
+	m_inputLatency(0),
 	m_lastInputTime(0),
-	m_authenticated(false)
+	m_sentNetworkStringsHash(0),
+	m_authenticated(false),
+	m_leavingArena(false)
 	{
 	}
 
-	Player::~Player()
-	{
-		if (m_arena)
-			m_arena->HandlePlayerLeave(this);
-	}
-
 	void Player::Authenticate(Nz::UInt32 dbId, std::function<void(Player*, bool succeeded)> authenticationCallback)
 	{
 		m_databaseId = dbId;
@@ -77,9 +78,10 @@ namespace ewn
 
 	const Ndk::EntityHandle& Player::InstantiateBot(std::size_t spaceshipHullId)
 {
+		Arena& arena = m_controlledEntity->GetComponent<ArenaComponent>().GetArena();
 		auto& spaceshipNode = m_controlledEntity->GetComponent<Ndk::NodeComponent>();
 
-		m_botEntity = m_arena->CreateSpaceship("Bot (" + m_login + ')', this, spaceshipHullId, spaceshipNode.GetPosition() + spaceshipNode.GetDown() * 10.f, spaceshipNode.GetRotation());
+		m_botEntity = arena.CreateSpaceship("Bot (" + m_login + ')', this, spaceshipHullId, spaceshipNode.GetPosition() + spaceshipNode.GetDown() * 10.f, spaceshipNode.GetRotation());
 
 		return m_botEntity;
 	}
@@ -99,12 +101,16 @@ namespace ewn
 	{
 		assert(m_arena != arena);
 
+		// Arena load is tracked here, as soon as the player is assigned (see ServerApplication::FindArenaForPlayer)
 		if (m_arena)
-			m_arena->HandlePlayerLeave(this);
+			m_arena->m_assignedPlayerCount--;
 
 		m_arena = arena;
+
 		if (m_arena)
-			m_arena->HandlePlayerJoin(this);
+			m_arena->m_assignedPlayerCount++;
+
+		UpdateArenaMembership();
 	}
 
 	void Player::PrintMessage(std::string chatMessage)
@@ -115,22 +121,48 @@ namespace ewn
 		SendPacket(chatPacket);
 	}
 
-	void Player::Shoot()
+	// Gives the controlled entity up without destroying it (the arena keeps dead player spaceships around to reuse them)
+	void Player::ReleaseControlledEntity()
+	{
+		if (!m_controlledEntity)
+			return;
+
+		m_controlledEntity.Release();
+
+		Packets::ControlEntity controlPacket;
+		controlPacket.id = 0;
+		SendPacket(controlPacket);
+	}
+
+	void Player::Shoot(Nz::UInt32 renderDelay)
 	{
-		if (ServerApplication::GetAppTime() - m_lastShootTime < 500)
+		if (!m_controlledEntity)
+			return;
+
+		Arena& arena = m_controlledEntity->GetComponent<ArenaComponent>().GetArena();
+
+		Nz::UInt64 now = arena.GetCurrentTime();
+		if (now - m_lastShootTime < 500)
 			return;
 
-		m_lastShootTime = ServerApplication::GetAppTime();
+		m_lastShootTime = now;
 
 		auto& spaceshipNode = m_controlledEntity->GetComponent<Ndk::NodeComponent>();
 
-		m_arena->CreatePlasmaProjectile(this, m_controlledEntity, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation());
+		// The player saw other entities one round-trip late plus its interpolation delay, hits are checked against where they were back then
+		// Rewinding is capped by the positions history (larger client delays are simply clamped)
+		constexpr Nz::UInt64 MaxRewindTime = (SpatialIndexSystem::HistoryTickCount - 1) * 1000 / ServerTickRate;
+
+		Nz::UInt64 rewindTime = std::min<Nz::UInt64>(2 * m_inputLatency + renderDelay, MaxRewindTime);
+		Nz::UInt64 viewTime = (now > rewindTime) ? now - rewindTime : 0;
+
+		arena.CreatePlasmaProjectile(m_controlledEntity, spaceshipNode.GetPosition() + spaceshipNode.GetForward() * 12.f, spaceshipNode.GetRotation(), viewTime);
 
 		Packets::PlaySound playSound;
 		playSound.position = spaceshipNode.GetPosition();
 		playSound.soundId = 0;
 
-		m_arena->BroadcastPacket(playSound, this);
+		arena.BroadcastPacket(playSound, this);
 	}
 
 	void Player::UpdateControlledEntity(const Ndk::EntityHandle& entity)
@@ -159,33 +191,19 @@ namespace ewn
 		if (!m_controlledEntity)
 			return;
 
-		if (!std::isfinite(movement.x) ||
-			!std::isfinite(movement.y) ||
-			!std::isfinite(movement.z))
-		{
-			std::cout << "Client #" << m_peerId << " (" << m_login << " has non-finite movement: " << movement << std::endl;
-			return;
-		}
-
-		if (!std::isfinite(rotation.x) ||
-			!std::isfinite(rotation.y) ||
-			!std::isfinite(rotation.z))
-		{
-			std::cout << "Client #" << m_peerId << " (" << m_login << " has non-finite rotation: " << movement << std::endl;
-			return;
-		}
+		Arena& arena = m_controlledEntity->GetComponent<ArenaComponent>().GetArena();
 
-		// TODO: Set speed limit accordingly to spaceship data
-		movement.x = Nz::Clamp(movement.x, -1.f, 1.f);
-		movement.y = Nz::Clamp(movement.y, -1.f, 1.f);
-		movement.z = Nz::Clamp(movement.z, -1.f, 1.f);
+		// Client clock is synchronized with ours, the input age is a (smoothed) estimation of the one-way latency
+		Nz::UInt64 now = arena.GetCurrentTime();
+		Nz::UInt64 inputAge = (now > lastInputTime) ? now - lastInputTime : 0;
+		m_inputLatency = (7 * m_inputLatency + inputAge) / 8;
 
-		rotation.x = Nz::Clamp(rotation.x, -1.f, 1.f);
-		rotation.y = Nz::Clamp(rotation.y, -1.f, 1.f);
-		rotation.z = Nz::Clamp(rotation.z, -1.f, 1.f);
+		// Inputs are applied at the arena tick matching their time, don't let a client schedule them too far ahead
+		Nz::UInt64 inputTick = std::min(arena.GetTickAt(lastInputTime), arena.GetCurrentTick() + ServerTickRate);
 
+		// Movement and rotation were validated and clamped when the packet was decoded (see Packets::Validate)
 		auto& controlComponent = m_controlledEntity->GetComponent<InputComponent>();
-		controlComponent.PushInput(lastInputTime, movement, rotation);
+		controlComponent.PushInput(inputTick, lastInputTime, movement, rotation);
 	}
 
 	void Player::UpdatePermissionLevel(Nz::UInt16 permissionLevel, std::function<void(bool updateSucceeded)> databaseCallback)
@@ -213,4 +231,41 @@ namespace ewn
 
 		m_authenticated = true;
 	}
+
+	void Player::UpdateArenaMembership()
+	{
+		// Arena-side player state (entities, inputs) is only accessed by its arena thread
+		// Never let two arenas use the player at the same time: join the new arena only once the previous one released the player
+		if (m_leavingArena || m_joinedArena == m_arena)
+			return;
+
+		if (m_joinedArena)
+		{
+			Arena* previousArena = m_joinedArena;
+			m_joinedArena = nullptr;
+			m_leavingArena = true;
+			previousArena->m_leavingPlayerCount++;
+
+			previousArena->RegisterCallback([app = m_app, previousArena, player = this]()
+			{
+				previousArena->HandlePlayerLeave(player);
+
+				app->RegisterCallback([previousArena, player]()
+				{
+					previousArena->m_leavingPlayerCount--;
+
+					player->m_leavingArena = false;
+					player->UpdateArenaMembership();
+				});
+			});
+		}
+		else
+		{
+			m_joinedArena = m_arena;
+			m_joinedArena->RegisterCallback([arena = m_joinedArena, player = this]()
+			{
+				arena->HandlePlayerJoin(player);
+			});
+		}
+	}
 }
@@ -23,16 +23,18 @@ namespace ewn
 
 	class Player : public Nz::HandledObject<Player>
 	{
+		friend class Arena;
 		friend class ServerCommandStore;
 
 		public:
 			Player(ServerApplication* app, std::size_t peerId, NetworkReactor& reactor, const ServerCommandStore& commandStore);
-			~Player();
+			~Player() = default;
 
 			void Authenticate(Nz::UInt32 dbId, std::function<void (Player*, bool succeeded)> authenticationCallback);
 
 			inline void Disconnect(Nz::UInt32 data = 0);
 
+			inline ServerApplication& GetApp();
 			inline Arena* GetArena() const;
 			inline const Ndk::EntityHandle& GetBotEntity() const;
 			inline const Ndk::EntityHandle& GetControlledEntity() const;
@@ -42,18 +44,26 @@ namespace ewn
 			inline Nz::UInt16 GetPermissionLevel() const;
 			inline const std::string& GetName() const;
 			inline std::size_t GetPeerId() const;
+			inline Nz::UInt64 GetSentNetworkStringsHash() const;
 
 			const Ndk::EntityHandle& InstantiateBot(std::size_t spaceshipHullId);
 
 			inline bool IsAuthenticated() const;
+			inline bool IsLeavingArena() const;
 
 			void MoveToArena(Arena* arena);
 
 			void PrintMessage(std::string chatMessage);
 
+			void ReleaseControlledEntity();
+
+			inline void SendPacket(const CommandStore::SerializedPacket& packet);
 			template<typename T> void SendPacket(const T& packet);
 
-			void Shoot();
+			inline void SetNetworkImpairment(std::optional<NetworkReactor::Impairment> impairment);
+			inline void SetSentNetworkStringsHash(Nz::UInt64 hash);
+
+			void Shoot(Nz::UInt32 renderDelay);
 
 			void UpdateControlledEntity(const Ndk::EntityHandle& entity);
 			void UpdateInput(Nz::UInt64 time, Nz::Vector3f direction, Nz::Vector3f rotation);
@@ -62,7 +72,10 @@ namespace ewn
 		private:
 			void OnAuthenticated(std::string login, std::string displayName, Nz::UInt16 permissionLevel);
 
-			Arena* m_arena;
+			void UpdateArenaMembership();
+
+			Arena* m_arena; //< Arena the player is in (or is joining), only accessed by the main thread
+			Arena* m_joinedArena; //< Arena which was asked to add the player, only accessed by the main thread
 			ServerApplication* m_app;
 			NetworkReactor& m_networkReactor;
 			const ServerCommandStore& m_commandStore;
@@ -73,9 +86,12 @@ namespace ewn
 			Ndk::EntityOwner m_controlledEntity;
 			Nz::UInt16 m_permissionLevel;
 			Nz::UInt32 m_databaseId;
+			Nz::UInt64 m_inputLatency; //< Smoothed one-way latency estimation (in milliseconds), used for lag compensation
 			Nz::UInt64 m_lastInputTime;
 			Nz::UInt64 m_lastShootTime;
+			Nz::UInt64 m_sentNetworkStringsHash; //< Hash of the last networked string table sent to the player (0 if none)
 			bool m_authenticated;
+			bool m_leavingArena;
 	};
 }
 
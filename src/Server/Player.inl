@@ -14,6 +14,11 @@ namespace ewn
 		m_networkReactor.DisconnectPeer(m_peerId, data);
 	}
 
+	inline ServerApplication& Player::GetApp()
+	{
+		return *m_app;
+	}
+
 	inline Arena* Player::GetArena() const
 	{
 		return m_arena;
@@ -54,11 +59,30 @@ namespace ewn
 		return m_peerId;
 	}
 
+	inline Nz::UInt64 Player::GetSentNetworkStringsHash() const
+	{
+		return m_sentNetworkStringsHash;
+	}
+
 	inline bool Player::IsAuthenticated() const
 	{
 		return m_authenticated;
 	}
 
+	// Players must not be destroyed while an arena thread may still reference them
+	inline bool Player::IsLeavingArena() const
+	{
+		return m_leavingArena;
+	}
+
+	inline void Player::SendPacket(const CommandStore::SerializedPacket& packet)
+	{
+		Nz::NetPacket data;
+		data.Write(packet.data.GetConstBuffer(), packet.data.GetSize());
+
+		m_networkReactor.SendData(m_peerId, packet.channelId, packet.flags, std::move(data));
+	}
+
 	template<typename T>
 	void Player::SendPacket(const T& packet)
 	{
@@ -69,4 +93,14 @@ namespace ewn
 
 		m_networkReactor.SendData(m_peerId, command.channelId, command.flags, std::move(data));
 	}
+
+	inline void Player::SetNetworkImpairment(std::optional<NetworkReactor::Impairment> impairment)
+	{
+		m_networkReactor.SetPeerImpairment(m_peerId, std::move(impairment));
+	}
+
+	inline void Player::SetSentNetworkStringsHash(Nz::UInt64 hash)
+	{
+		m_sentNetworkStringsHash = hash;
+	}
 }
@@ -0,0 +1,200 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/ProjectileEngine.hpp>
+#include <Server/Arena.hpp>
+#include <Server/SpatialGrid.hpp>
+#include <Server/StateHistory.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	ProjectileEngine::ProjectileEngine(Arena* arena) :
+	m_arena(arena),
+	m_nextProjectileId(0)
+	{
+	}
+
+	void ProjectileEngine::AddStaticObstacle(Ndk::EntityId entityId, const Nz::Vector3f& position, float radius)
+	{
+		StaticObstacle& obstacle = m_staticObstacles.emplace_back();
+		obstacle.entityId = entityId;
+		obstacle.position = position;
+		obstacle.radius = radius;
+	}
+
+	void ProjectileEngine::Clear()
+	{
+		while (!m_ids.empty())
+			Destroy(m_ids.size() - 1);
+	}
+
+	void ProjectileEngine::ClearStaticObstacles()
+	{
+		m_staticObstacles.clear();
+	}
+
+	void ProjectileEngine::CreateAllProjectiles(std::vector<Packets::CreateProjectile>& packetVector) const
+	{
+		packetVector.resize(m_ids.size());
+		for (std::size_t i = 0; i < m_ids.size(); ++i)
+			BuildCreateProjectile(i, packetVector[i]);
+	}
+
+	Nz::UInt32 ProjectileEngine::Spawn(const ProjectileInfo& info, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, const Nz::Vector3f& velocity, Nz::UInt32 rewindTicks)
+	{
+		Nz::UInt32 projectileId = m_nextProjectileId++;
+
+		m_damages.push_back(info.damage);
+		m_emitters.push_back(emitter);
+		m_explosionRadii.push_back(info.explosionRadius);
+		m_ids.push_back(projectileId);
+		m_positions.push_back(position);
+		m_prefabIds.push_back(info.prefabId);
+		m_radii.push_back(info.radius);
+		m_remainingTimes.push_back(info.lifeTime);
+		m_rewindTicks.push_back(rewindTicks);
+		m_rotations.push_back(rotation);
+		m_velocities.push_back(velocity);
+
+		Packets::CreateProjectile createPacket;
+		BuildCreateProjectile(m_ids.size() - 1, createPacket);
+
+		OnProjectileCreated(this, createPacket);
+
+		return projectileId;
+	}
+
+	void ProjectileEngine::Update(float elapsedTime, const SpatialGrid& grid, const StateHistory& history, std::vector<Hit>& hits)
+	{
+		std::size_t i = 0;
+		while (i < m_ids.size())
+		{
+			Nz::Vector3f from = m_positions[i];
+			Nz::Vector3f to = from + m_velocities[i] * elapsedTime;
+
+			const Ndk::EntityHandle& emitter = m_emitters[i];
+
+			// Only the first entity crossed by the projectile during this tick is hit
+			Ndk::EntityId hitEntityId = 0;
+			float hitFactor = 2.f;
+			auto CheckHit = [&](Ndk::EntityId entityId, float factor)
+			{
+				if (emitter && emitter->GetId() == entityId)
+					return;
+
+				if (factor < hitFactor)
+				{
+					hitEntityId = entityId;
+					hitFactor = factor;
+				}
+			};
+
+			Nz::UInt64 rewindTick = 0;
+			bool isRewound = false;
+			if (m_rewindTicks[i] > 0 && history.HasTick(history.GetLatestTick()))
+			{
+				// Clamped to the oldest recorded tick, players lagging more than that are not fully compensated
+				Nz::UInt64 latestTick = history.GetLatestTick();
+				rewindTick = latestTick - std::min<Nz::UInt64>(m_rewindTicks[i], latestTick - history.GetOldestTick());
+				isRewound = (rewindTick < latestTick);
+			}
+
+			if (isRewound)
+			{
+				// Candidates are found from current positions (inflated by how far entities may have moved since), then checked against where they were
+				float maxDisplacement = history.GetMaxDisplacement(rewindTick);
+				grid.ForEachOnSegment(from, to, m_radii[i] + maxDisplacement, [&](const SpatialGrid::Entry& entry, float /*factor*/)
+				{
+					const StateHistory::Entry* pastEntry = history.FindEntry(rewindTick, entry.entityId);
+					if (!pastEntry)
+						return;
+
+					float factor;
+					if (SpatialGrid::ComputeSegmentHitFactor(from, to, pastEntry->position, pastEntry->radius + m_radii[i], &factor))
+						CheckHit(entry.entityId, factor);
+				});
+			}
+			else
+			{
+				grid.ForEachOnSegment(from, to, m_radii[i], [&](const SpatialGrid::Entry& entry, float factor)
+				{
+					CheckHit(entry.entityId, factor);
+				});
+			}
+
+			// Static obstacles never move, lag compensation doesn't apply to them
+			for (const StaticObstacle& obstacle : m_staticObstacles)
+			{
+				float factor;
+				if (SpatialGrid::ComputeSegmentHitFactor(from, to, obstacle.position, obstacle.radius + m_radii[i], &factor))
+					CheckHit(obstacle.entityId, factor);
+			}
+
+			if (hitFactor <= 1.f)
+			{
+				Hit& hit = hits.emplace_back();
+				hit.damage = m_damages[i];
+				hit.emitter = emitter;
+				hit.explosionRadius = m_explosionRadii[i];
+				hit.hitEntityId = hitEntityId;
+				hit.position = Nz::Vector3f::Lerp(from, to, hitFactor);
+				hit.velocity = m_velocities[i];
+
+				Destroy(i);
+				continue;
+			}
+
+			m_positions[i] = to;
+
+			m_remainingTimes[i] -= elapsedTime;
+			if (m_remainingTimes[i] <= 0.f)
+			{
+				Destroy(i);
+				continue;
+			}
+
+			++i;
+		}
+	}
+
+	void ProjectileEngine::BuildCreateProjectile(std::size_t index, Packets::CreateProjectile& createPacket) const
+	{
+		createPacket.linearVelocity = m_velocities[index];
+		createPacket.position = m_positions[index];
+		createPacket.prefabId = m_prefabIds[index];
+		createPacket.projectileId = m_ids[index];
+		createPacket.rotation = m_rotations[index];
+		createPacket.spawnTime = m_arena->GetCurrentTime();
+	}
+
+	void ProjectileEngine::Destroy(std::size_t index)
+	{
+		Packets::DeleteProjectile deletePacket;
+		deletePacket.projectileId = m_ids[index];
+
+		OnProjectileDestroyed(this, deletePacket);
+
+		std::size_t lastIndex = m_ids.size() - 1;
+		auto SwapRemove = [=](auto& vec)
+		{
+			if (index != lastIndex)
+				vec[index] = std::move(vec[lastIndex]);
+
+			vec.pop_back();
+		};
+
+		SwapRemove(m_damages);
+		SwapRemove(m_emitters);
+		SwapRemove(m_explosionRadii);
+		SwapRemove(m_ids);
+		SwapRemove(m_positions);
+		SwapRemove(m_prefabIds);
+		SwapRemove(m_radii);
+		SwapRemove(m_remainingTimes);
+		SwapRemove(m_rewindTicks);
+		SwapRemove(m_rotations);
+		SwapRemove(m_velocities);
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_PROJECTILEENGINE_HPP
+#define EREWHON_SERVER_PROJECTILEENGINE_HPP
+
+#include <Nazara/Core/Signal.hpp>
+#include <Nazara/Math/Quaternion.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/Entity.hpp>
+#include <Shared/Protocol/Packets.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class Arena;
+	class SpatialGrid;
+	class StateHistory;
+
+	// Projectiles are not entities: they move in a straight line and are swept against the spatial grid every tick
+	class ProjectileEngine
+	{
+		public:
+			struct Hit;
+			struct ProjectileInfo;
+
+			ProjectileEngine(Arena* arena);
+			ProjectileEngine(const ProjectileEngine&) = delete;
+			ProjectileEngine(ProjectileEngine&&) = delete;
+			~ProjectileEngine() = default;
+
+			void AddStaticObstacle(Ndk::EntityId entityId, const Nz::Vector3f& position, float radius);
+
+			void Clear();
+			void ClearStaticObstacles();
+
+			void CreateAllProjectiles(std::vector<Packets::CreateProjectile>& packetVector) const;
+
+			inline std::size_t GetProjectileCount() const;
+
+			Nz::UInt32 Spawn(const ProjectileInfo& info, const Ndk::EntityHandle& emitter, const Nz::Vector3f& position, const Nz::Quaternionf& rotation, const Nz::Vector3f& velocity, Nz::UInt32 rewindTicks = 0);
+
+			void Update(float elapsedTime, const SpatialGrid& grid, const StateHistory& history, std::vector<Hit>& hits);
+
+			ProjectileEngine& operator=(const ProjectileEngine&) = delete;
+			ProjectileEngine& operator=(ProjectileEngine&&) = delete;
+
+			struct Hit
+			{
+				Ndk::EntityHandle emitter;
+				Ndk::EntityId hitEntityId;
+				Nz::Vector3f position;
+				Nz::Vector3f velocity;
+				Nz::UInt16 damage;
+				float explosionRadius;
+			};
+
+			struct ProjectileInfo
+			{
+				Nz::UInt16 damage;
+				Nz::UInt32 prefabId;
+				float explosionRadius = 0.f; //< Zero if the projectile only damages what it hits
+				float lifeTime;
+				float radius;
+			};
+
+			NazaraSignal(OnProjectileCreated, const ProjectileEngine* /*engine*/, const Packets::CreateProjectile& /*packet*/);
+			NazaraSignal(OnProjectileDestroyed, const ProjectileEngine* /*engine*/, const Packets::DeleteProjectile& /*packet*/);
+
+		private:
+			void BuildCreateProjectile(std::size_t index, Packets::CreateProjectile& createPacket) const;
+			void Destroy(std::size_t index);
+
+			// Static bodies have no physics body so they're not in the spatial grid, projectiles are checked against them separately
+			struct StaticObstacle
+			{
+				Nz::Vector3f position;
+				Ndk::EntityId entityId;
+				float radius;
+			};
+
+			// Projectiles are stored as a structure of arrays, removal swaps with the last one
+			std::vector<Ndk::EntityHandle> m_emitters;
+			std::vector<Nz::Quaternionf> m_rotations;
+			std::vector<Nz::UInt16> m_damages;
+			std::vector<Nz::UInt32> m_ids;
+			std::vector<Nz::UInt32> m_prefabIds;
+			std::vector<Nz::UInt32> m_rewindTicks; //< Lag compensation, targets are checked where they were this many ticks ago
+			std::vector<Nz::Vector3f> m_positions;
+			std::vector<Nz::Vector3f> m_velocities;
+			std::vector<float> m_explosionRadii;
+			std::vector<float> m_radii;
+			std::vector<float> m_remainingTimes;
+			std::vector<StaticObstacle> m_staticObstacles;
+			Arena* m_arena;
+			Nz::UInt32 m_nextProjectileId;
+	};
+}
+
+#include <Server/ProjectileEngine.inl>
+
+#endif // EREWHON_SERVER_PROJECTILEENGINE_HPP
@@ -11,24 +11,40 @@
 #include <Server/Player.hpp>
 #include <argon2/argon2.h>
 #include <cctype>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <regex>
 
 namespace ewn
 {
+	static constexpr Nz::UInt64 arenaReclaimDelay = 60'000; //< How long an arena instance has to stay empty before being destroyed (ms)
+
 	ServerApplication::ServerApplication() :
+	m_arenaMaxEntities(0),
+	m_arenaMaxInstances(0),
+	m_arenaMaxPlayers(0),
 	m_playerPool(sizeof(Player)),
+	m_authenticatingGate(AdmissionStage::Authenticating),
+	m_connectingGate(AdmissionStage::Connecting),
+	m_inArenaGate(AdmissionStage::InArena),
+	m_loadingGate(AdmissionStage::Loading),
 	m_chatCommandStore(this),
 	m_commandStore(this)
 	{
 		RegisterConfigOptions();
 		RegisterNetworkedStrings();
-
-		m_arenas.emplace_back(std::make_unique<Arena>(this));
 	}
 
 	ServerApplication::~ServerApplication()
 	{
+		// Stop arena threads first, they may reference players
+		m_arenas.clear();
+
+		for (Player* player : m_leavingPlayers)
+			m_playerPool.Delete(player);
+
 		for (Player* player : m_players)
 		{
 			if (player)
@@ -65,14 +81,21 @@ namespace ewn
 				m_stringStore.RegisterString(m_visualMeshStore.GetEntryFilePath(i));
 		}
 
+		InvalidateNetworkStrings();
+
 		return true;
 	}
 
 	bool ServerApplication::Run()
 	{
-		float updateTime = GetUpdateTime();
-		for (const auto& arenaPtr : m_arenas)
-			arenaPtr->Update(updateTime);
+		// Connecting and loading stages are limited per update
+		m_connectingGate.ReleaseAll();
+		m_loadingGate.ReleaseAll();
+
+		m_connectingGate.Update();
+		m_authenticatingGate.Update();
+		m_inArenaGate.Update();
+		m_loadingGate.Update();
 
 		m_globalDatabase->Poll();
 
@@ -80,9 +103,96 @@ namespace ewn
 		while (m_callbackQueue.try_dequeue(func))
 			func();
 
+		// Disconnected players are destroyed once their arena released them
+		for (auto it = m_leavingPlayers.begin(); it != m_leavingPlayers.end();)
+		{
+			Player* player = *it;
+			if (!player->IsLeavingArena())
+			{
+				m_playerPool.Delete(player);
+				it = m_leavingPlayers.erase(it);
+			}
+			else
+				++it;
+		}
+
+		ReclaimArenas();
+
 		return BaseApplication::Run();
 	}
 
+	Player* ServerApplication::FindPlayerByName(const std::string& name) const
+	{
+		for (Player* player : m_players)
+		{
+			if (player && player->IsAuthenticated() && player->GetName() == name)
+				return player;
+		}
+
+		return nullptr;
+	}
+
+	Arena* ServerApplication::CreateArena()
+	{
+		// Every instance starts from the same default arena (see Arena::Reset)
+		ArenaInstance& instance = m_arenas.emplace_back();
+		instance.arena = std::make_unique<Arena>(this);
+		instance.emptySince = GetAppTime();
+
+		std::cout << "Created a new arena instance (" << m_arenas.size() << " running)" << std::endl;
+
+		return instance.arena.get();
+	}
+
+	Arena* ServerApplication::FindArenaForPlayer()
+	{
+		// Keep every arena within its player and entity budget (which bounds broadcast and physics cost), spawn new instances when all are full
+		auto IsOverBudget = [this](const Arena& arena)
+		{
+			if (m_arenaMaxPlayers > 0 && arena.GetAssignedPlayerCount() >= m_arenaMaxPlayers)
+				return true;
+
+			if (m_arenaMaxEntities > 0 && arena.GetEntityCount() >= m_arenaMaxEntities)
+				return true;
+
+			return false;
+		};
+
+		Arena* bestArena = nullptr;
+		Arena* leastLoadedArena = nullptr;
+		for (const ArenaInstance& instance : m_arenas)
+		{
+			Arena* arena = instance.arena.get();
+			if (!leastLoadedArena || arena->GetAssignedPlayerCount() < leastLoadedArena->GetAssignedPlayerCount())
+				leastLoadedArena = arena;
+
+			if (IsOverBudget(*arena))
+				continue;
+
+			if (!bestArena || arena->GetAssignedPlayerCount() < bestArena->GetAssignedPlayerCount())
+				bestArena = arena;
+		}
+
+		if (bestArena)
+			return bestArena;
+
+		if (m_arenaMaxInstances == 0 || m_arenas.size() < m_arenaMaxInstances)
+			return CreateArena();
+
+		// Instance limit reached, exceed budget of the least loaded arena
+		assert(leastLoadedArena);
+		return leastLoadedArena;
+	}
+
+	const CommandStore::SerializedPacket& ServerApplication::GetNetworkStringsPacket()
+	{
+		// Every client receives the whole string table on connection, serialize it only once
+		if (!m_networkStringsPacket)
+			m_networkStringsPacket = m_commandStore.SerializePacket(m_stringStore.BuildPacket(0));
+
+		return *m_networkStringsPacket;
+	}
+
 	void ServerApplication::HandleCreateSpaceship(std::size_t peerId, const Packets::CreateSpaceship& data)
 	{
 		Player* player = m_players[peerId];
@@ -149,21 +259,49 @@ namespace ewn
 		if (peerId >= m_players.size())
 			m_players.resize(peerId + 1);
 
-		m_players[peerId] = m_playerPool.New<Player>(this, peerId, *reactor, m_commandStore);
+		Player* player = m_playerPool.New<Player>(this, peerId, *reactor, m_commandStore);
+		m_players[peerId] = player;
 		std::cout << "Client #" << peerId << " connected with data " << data << std::endl;
 
-		// Send newtorked strings
-		m_players[peerId]->SendPacket(m_stringStore.BuildPacket(0));
+		m_connectingGate.Enter(player, [this, player]()
+		{
+			// Advertise networked strings, client will query the ones it doesn't have in cache
+			Packets::NetworkStringsHash stringsHash;
+			stringsHash.hash = m_stringStore.GetHash();
+			stringsHash.stringCount = Nz::UInt32(m_stringStore.GetStringCount());
+
+			player->SendPacket(stringsHash);
+		});
 	}
 
 	void ServerApplication::HandlePeerDisconnection(std::size_t peerId, Nz::UInt32 data)
 	{
 		std::cout << "Client #" << peerId << " disconnected with data " << data << std::endl;
 
-		m_playerPool.Delete(m_players[peerId]);
+		Player* player = m_players[peerId];
+		m_connectingGate.Leave(player);
+		m_authenticatingGate.Leave(player);
+		m_loadingGate.Leave(player);
+		m_inArenaGate.Leave(player);
+
+		if (player->GetArena())
+			player->MoveToArena(nullptr);
+
+		// Arena threads may still reference the player until it left its arena
+		if (player->IsLeavingArena())
+			m_leavingPlayers.push_back(player);
+		else
+			m_playerPool.Delete(player);
+
 		m_players[peerId] = nullptr;
 	}
 
+	void ServerApplication::HandlePeerMessage(std::size_t peerId, Packets::AnyPacket&& message)
+	{
+		// Packets were already decoded and validated by the network reactor
+		m_commandStore.DispatchPacket(peerId, message);
+	}
+
 	void ServerApplication::HandlePeerPacket(std::size_t peerId, Nz::NetPacket&& packet)
 	{
 		//std::cout << "Client #" << peerId << " sent packet of size " << packet.GetDataSize() << std::endl;
@@ -185,6 +323,20 @@ namespace ewn
 		m_globalDatabase->SpawnWorkers(workerCount);
 	}
 
+	void ServerApplication::InvalidateNetworkStrings()
+	{
+		m_networkStringsPacket.reset();
+
+		// Arena data references networked strings
+		for (const ArenaInstance& instance : m_arenas)
+		{
+			instance.arena->RegisterCallback([arena = instance.arena.get()]()
+			{
+				arena->InvalidateArenaData();
+			});
+		}
+	}
+
 	void ServerApplication::OnConfigLoaded(const ConfigFile& config)
 	{
 		const std::string& dbHost = m_config.GetStringOption("Database.Host");
@@ -198,6 +350,30 @@ namespace ewn
 
 		InitGameWorkers(gameWorkerCount);
 		InitGlobalDatabase(dbWorkerCount, dbHost, dbPort, dbUser, dbPassword, dbName);
+
+		m_authenticatingGate.SetLimit(m_config.GetIntegerOption<std::size_t>("Admission.MaxAuthenticating"));
+		m_connectingGate.SetLimit(m_config.GetIntegerOption<std::size_t>("Admission.MaxConnectingPerUpdate"));
+		m_inArenaGate.SetLimit(m_config.GetIntegerOption<std::size_t>("Admission.MaxInArena"));
+		m_loadingGate.SetLimit(m_config.GetIntegerOption<std::size_t>("Admission.MaxLoadingPerUpdate"));
+
+		m_arenaMaxEntities = m_config.GetIntegerOption<std::size_t>("Arena.MaxEntities");
+		m_arenaMaxInstances = m_config.GetIntegerOption<std::size_t>("Arena.MaxInstances");
+		m_arenaMaxPlayers = m_config.GetIntegerOption<std::size_t>("Arena.MaxPlayers");
+
+		m_taskPool.emplace(m_config.GetIntegerOption<std::size_t>("Arena.SimulationWorkerCount"));
+
+		// Arenas run their systems on the task pool, the first one can only be created once it exists
+		CreateArena();
+
+		// Network impairment is only meant for testing netcode under bad conditions, it should be disabled in production
+		m_networkImpairment.latency = m_config.GetIntegerOption<Nz::UInt32>("NetworkImpairment.Latency");
+		m_networkImpairment.jitter = m_config.GetIntegerOption<Nz::UInt32>("NetworkImpairment.Jitter");
+		m_networkImpairment.duplicationChance = m_config.GetFloatOption<float>("NetworkImpairment.DuplicationChance");
+		m_networkImpairment.lossChance = m_config.GetFloatOption<float>("NetworkImpairment.LossChance");
+		m_networkImpairment.reorderChance = m_config.GetFloatOption<float>("NetworkImpairment.ReorderChance");
+
+		if (m_networkImpairment.IsEnabled())
+			std::cout << "Warning: network impairment is enabled" << std::endl;
 	}
 
 	void ServerApplication::HandleLogin(std::size_t peerId, const Packets::Login& data)
@@ -209,8 +385,23 @@ namespace ewn
 		if (data.login.empty() || data.login.size() > 20)
 			return;
 
-		m_globalDatabase->ExecuteQuery("FindAccountByLogin", { data.login },
-		[this, ply = player->CreateHandle(), login = data.login, pwd = data.passwordHash](DatabaseResult& result)
+		if (m_authenticatingGate.IsAdmitted(player) || m_authenticatingGate.IsQueued(player))
+			return; //< Already logging in
+
+		// Gates drop players on disconnection, so capturing them is safe
+		m_connectingGate.RunWhenAdmitted(player, [this, player, login = data.login, pwd = data.passwordHash]()
+		{
+			m_authenticatingGate.Enter(player, [this, player, login, pwd]()
+			{
+				StartAuthentication(player, login, pwd);
+			});
+		});
+	}
+
+	void ServerApplication::StartAuthentication(Player* player, const std::string& login, const std::string& passwordHash)
+	{
+		m_globalDatabase->ExecuteQuery("FindAccountByLogin", { login },
+		[this, ply = player->CreateHandle(), login, pwd = passwordHash](DatabaseResult& result)
 		{
 			if (!ply)
 				return;
@@ -223,6 +414,7 @@ namespace ewn
 				loginFailure.reason = LoginFailureReason::ServerError;
 
 				ply->SendPacket(loginFailure);
+				m_authenticatingGate.Leave(ply);
 				return;
 			}
 
@@ -234,6 +426,7 @@ namespace ewn
 				loginFailure.reason = LoginFailureReason::AccountNotFound;
 
 				ply->SendPacket(loginFailure);
+				m_authenticatingGate.Leave(ply);
 				return;
 			}
 
@@ -294,13 +487,15 @@ namespace ewn
 
 				if (!failure)
 				{
-					RegisterCallback([ply, id]()
+					RegisterCallback([this, ply, id]()
 					{
 						if (!ply)
 							return;
 
-						ply->Authenticate(id, [](Player* player, bool loginSuccess)
+						ply->Authenticate(id, [this](Player* player, bool loginSuccess)
 						{
+							m_authenticatingGate.Leave(player);
+
 							if (loginSuccess)
 							{
 								player->SendPacket(Packets::LoginSuccess());
@@ -321,11 +516,13 @@ namespace ewn
 				}
 				else
 				{
-					RegisterCallback([ply, login, reason = failure.value(), argon2Ret]()
+					RegisterCallback([this, ply, login, reason = failure.value(), argon2Ret]()
 					{
 						if (!ply)
 							return;
 
+						m_authenticatingGate.Leave(ply);
+
 						Packets::LoginFailure loginFailure;
 						loginFailure.reason = reason;
 
@@ -358,12 +555,23 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		if (data.arenaIndex > m_arenas.size())
+		// Only one arena template exists for now, the instance is picked by the server
+		if (data.arenaIndex != 0)
 			return;
 
-		Arena* arena = m_arenas[data.arenaIndex].get();
-		if (player->GetArena() != arena)
-			player->MoveToArena(arena);
+		if (player->GetArena())
+			return;
+
+		// Joining an arena sends every entity to the player, limit how many players can do this per update
+		m_inArenaGate.Enter(player, [this, player]()
+		{
+			m_loadingGate.Enter(player, [this, player]()
+			{
+				// Pick the arena only now, so placement relies on up-to-date arena load
+				if (!player->GetArena())
+					player->MoveToArena(FindArenaForPlayer());
+			});
+		});
 	}
 
 	void ServerApplication::HandlePlayerChat(std::size_t peerId, const Packets::PlayerChat& data)
@@ -397,7 +605,10 @@ namespace ewn
 
 			std::cout << message << std::endl;
 
-			arena->DispatchChatMessage(message);
+			arena->RegisterCallback([arena, message = std::move(message)]()
+			{
+				arena->DispatchChatMessage(message);
+			});
 		}
 	}
 
@@ -407,7 +618,20 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		player->UpdateInput(data.inputTime, data.direction, data.rotation);
+		Arena* arena = player->GetArena();
+		if (!arena)
+			return;
+
+		arena->RegisterPlayerCallback(player, [player, data]()
+		{
+			// Inputs are sent multiple times to survive packet loss, the player will ignore the ones it already received
+			Nz::UInt64 inputTime = data.inputTime;
+			for (const auto& input : data.inputs)
+			{
+				inputTime += input.timeDelta;
+				player->UpdateInput(inputTime, input.direction, input.rotation);
+			}
+		});
 	}
 
 	void ServerApplication::HandlePlayerShoot(std::size_t peerId, const Packets::PlayerShoot& data)
@@ -416,7 +640,32 @@ namespace ewn
 		if (!player->IsAuthenticated())
 			return;
 
-		player->Shoot();
+		if (Arena* arena = player->GetArena())
+		{
+			arena->RegisterPlayerCallback(player, [player, renderDelay = data.renderDelay]()
+			{
+				player->Shoot(renderDelay);
+			});
+		}
+	}
+
+	void ServerApplication::HandleQueryNetworkStrings(std::size_t peerId, const Packets::QueryNetworkStrings& data)
+	{
+		Player* player = m_players[peerId];
+
+		// Clients query each advertised table once, don't let them trigger large replies over and over
+		Nz::UInt64 tableHash = m_stringStore.GetHash();
+		if (player->GetSentNetworkStringsHash() == tableHash)
+			return;
+
+		player->SetSentNetworkStringsHash(tableHash);
+
+		// Strings are only ever appended, if the client has a valid prefix of our table send only what it's missing
+		std::size_t knownCount = data.knownCount;
+		if (knownCount > 0 && knownCount <= m_stringStore.GetStringCount() && m_stringStore.GetHash(knownCount) == data.knownHash)
+			player->SendPacket(m_stringStore.BuildPacket(knownCount));
+		else
+			player->SendPacket(GetNetworkStringsPacket());
 	}
 
 	void ServerApplication::HandleQuerySpaceshipInfo(std::size_t peerId, const Packets::QuerySpaceshipInfo & data)
@@ -650,28 +899,39 @@ namespace ewn
 					return;
 				}
 
-				const Ndk::EntityHandle& playerBot = ply->InstantiateBot(spaceshipHullId);
-				ScriptComponent& botScript = playerBot->AddComponent<ScriptComponent>();
-				if (!botScript.Initialize(this, moduleIds))
-				{
-					ply->PrintMessage("Server: Failed to initialize bot, please contact an administrator");
+				Player* player = ply;
+				Arena* arena = player->GetArena();
+				if (!arena)
 					return;
-				}
 
-				Nz::String lastError;
-				if (botScript.Execute(spaceshipCode, &lastError))
-					ply->PrintMessage("Server: Script loaded with success");
-				else
-					ply->PrintMessage("Server: Failed to execute script: " + lastError.ToStdString());
+				// Bot lives in the arena world, spawn it from the arena thread
+				arena->RegisterPlayerCallback(player, [this, player, spaceshipHullId, moduleIds = std::move(moduleIds), spaceshipCode]()
+				{
+					if (!player->GetControlledEntity())
+						return;
+
+					const Ndk::EntityHandle& playerBot = player->InstantiateBot(spaceshipHullId);
+					ScriptComponent& botScript = playerBot->AddComponent<ScriptComponent>();
+					if (!botScript.Initialize(this, moduleIds))
+					{
+						player->PrintMessage("Server: Failed to initialize bot, please contact an administrator");
+						return;
+					}
+
+					Nz::String lastError;
+					if (botScript.Execute(spaceshipCode, &lastError))
+						player->PrintMessage("Server: Script loaded with success");
+					else
+						player->PrintMessage("Server: Failed to execute script: " + lastError.ToStdString());
+				});
 			});
 		});
 	}
 
 	void ServerApplication::HandleTimeSyncRequest(std::size_t peerId, const Packets::TimeSyncRequest& data)
 	{
+		// Usually answered by the reactor thread (see RegisterFastPathHandlers), this only handles requests received before registration
 		Player* player = m_players[peerId];
-		if (!player->IsAuthenticated())
-			return;
 
 		Packets::TimeSyncResponse response;
 		response.requestId = data.requestId;
@@ -731,15 +991,57 @@ namespace ewn
 		});
 	}
 
+	void ServerApplication::ReloadModules(std::function<void(bool success)> callback)
+	{
+		m_moduleStore.QueryDatabase(*m_globalDatabase, [this, cb = std::move(callback)](DatabaseResult&& result)
+		{
+			if (!result)
+			{
+				std::cerr << "Failed to reload modules: " << result.GetLastErrorMessage() << std::endl;
+				cb(false);
+				return;
+			}
+
+			// Arenas read the module store when spawning bots, it can only be refilled while none of them is running
+			bool succeeded;
+			SuspendArenas([&]()
+			{
+				succeeded = m_moduleStore.FillStoreFromDatabase(this, result);
+			});
+
+			cb(succeeded);
+		});
+	}
+
+	void ServerApplication::SetNetworkImpairment(const NetworkReactor::Impairment& impairment)
+	{
+		m_networkImpairment = impairment;
+
+		for (std::size_t i = 0; i < GetReactorCount(); ++i)
+			GetReactor(i)->SetImpairment(m_networkImpairment);
+	}
+
 	bool ServerApplication::SetupNetwork(std::size_t clientPerReactor, std::size_t reactorCount, Nz::NetProtocol protocol, Nz::UInt16 firstPort)
 	{
 		m_peerPerReactor = clientPerReactor;
 
+		// Command store is immutable once constructed, reactors can use it to decode packets on their own thread
+		auto packetDecoder = [this](std::size_t peerId, Nz::NetPacket&& packet, Packets::AnyPacket& decoded)
+		{
+			return m_commandStore.DecodePacket(peerId, std::move(packet), decoded);
+		};
+
 		ClearReactors();
 		try
 		{
 			for (std::size_t i = 0; i < reactorCount; ++i)
-				AddReactor(std::make_unique<NetworkReactor>(m_peerPerReactor * i, protocol, Nz::UInt16(firstPort + i), clientPerReactor));
+			{
+				auto reactor = std::make_unique<NetworkReactor>(m_peerPerReactor * i, protocol, Nz::UInt16(firstPort + i), clientPerReactor, packetDecoder);
+				RegisterFastPathHandlers(*reactor);
+				reactor->SetImpairment(m_networkImpairment);
+
+				AddReactor(std::move(reactor));
+			}
 
 			return true;
 		}
@@ -750,8 +1052,53 @@ namespace ewn
 		}
 	}
 
+	void ServerApplication::ReclaimArenas()
+	{
+		Nz::UInt64 now = GetAppTime();
+
+		for (auto it = m_arenas.begin(); it != m_arenas.end();)
+		{
+			ArenaInstance& instance = *it;
+
+			// Players may still reference an arena they are leaving, it can only be destroyed once they are released
+			if (instance.arena->GetAssignedPlayerCount() > 0 || instance.arena->HasLeavingPlayers())
+			{
+				instance.emptySince = 0;
+				++it;
+				continue;
+			}
+
+			if (instance.emptySince == 0)
+				instance.emptySince = now;
+
+			// Always keep one arena running so joining players don't wait for an instance to be created
+			if (m_arenas.size() > 1 && now - instance.emptySince >= arenaReclaimDelay)
+			{
+				it = m_arenas.erase(it); //< Stops the arena thread
+
+				std::cout << "Reclaimed an empty arena instance (" << m_arenas.size() << " running)" << std::endl;
+			}
+			else
+				++it;
+		}
+	}
+
 	void ServerApplication::RegisterConfigOptions()
 	{
+		// Admission limits (0 means no limit)
+		m_config.RegisterIntegerOption("Admission.MaxAuthenticating", 0, 4096);
+		m_config.RegisterIntegerOption("Admission.MaxConnectingPerUpdate", 0, 4096);
+		m_config.RegisterIntegerOption("Admission.MaxInArena", 0, 4096);
+		m_config.RegisterIntegerOption("Admission.MaxLoadingPerUpdate", 0, 4096);
+
+		// Arena instancing (0 means no limit)
+		m_config.RegisterIntegerOption("Arena.MaxEntities", 0, 100'000);
+		m_config.RegisterIntegerOption("Arena.MaxInstances", 0, 256);
+		m_config.RegisterIntegerOption("Arena.MaxPlayers", 0, 4096);
+
+		// Threads helping arenas to run their systems (0 means arenas only use their own thread)
+		m_config.RegisterIntegerOption("Arena.SimulationWorkerCount", 0, 256);
+
 		m_config.RegisterStringOption("AssetsFolder");
 
 		// Database configuration
@@ -771,13 +1118,72 @@ namespace ewn
 		m_config.RegisterIntegerOption("Game.MaxClients", 0, 4096); //< 4096 due to ENet limitation
 		m_config.RegisterIntegerOption("Game.Port", 1, 0xFFFF);
 		m_config.RegisterIntegerOption("Game.WorkerCount", 1, 100);
+
+		m_config.RegisterFloatOption("NetworkImpairment.DuplicationChance", 0.0, 1.0);
+		m_config.RegisterIntegerOption("NetworkImpairment.Jitter", 0, 10000);
+		m_config.RegisterIntegerOption("NetworkImpairment.Latency", 0, 10000);
+		m_config.RegisterFloatOption("NetworkImpairment.LossChance", 0.0, 1.0);
+		m_config.RegisterFloatOption("NetworkImpairment.ReorderChance", 0.0, 1.0);
+	}
+
+	void ServerApplication::RegisterFastPathHandlers(NetworkReactor& reactor)
+	{
+		// Time sync is answered directly by the reactor thread to keep main loop jitter out of round-trip measures
+		// This handler is stateless (no player access), it only uses the immutable command store and the application clock
+		reactor.RegisterFastPathHandler(PacketType::TimeSyncRequest, [this](NetworkReactor& reactor, std::size_t peerId, const Packets::AnyPacket& packet)
+		{
+			Packets::TimeSyncResponse response;
+			response.requestId = std::get<Packets::TimeSyncRequest>(packet).requestId;
+			response.serverTime = GetAppTime();
+
+			SendFastPathPacket(reactor, peerId, response);
+		});
 	}
 
 	void ServerApplication::RegisterNetworkedStrings()
 	{
-		m_stringStore.RegisterString("earth");
-		m_stringStore.RegisterString("light");
-		m_stringStore.RegisterString("plasmabeam");
-		m_stringStore.RegisterString("torpedo");
+		m_archetypeRegistry.RegisterNetworkStrings(m_stringStore);
+
+		InvalidateNetworkStrings();
+	}
+
+	// Blocks every arena thread (between two ticks) while func runs, for shared data arenas read without synchronization
+	void ServerApplication::SuspendArenas(const std::function<void()>& func)
+	{
+		struct SuspendState
+		{
+			std::condition_variable signal;
+			std::mutex mutex;
+			std::size_t suspendedArenaCount = 0;
+			bool resumed = false;
+		};
+
+		// Shared with the arena callbacks, which may still be waking up once we're gone
+		auto state = std::make_shared<SuspendState>();
+
+		for (const ArenaInstance& instance : m_arenas)
+		{
+			instance.arena->RegisterCallback([state]()
+			{
+				std::unique_lock<std::mutex> lock(state->mutex);
+				state->suspendedArenaCount++;
+				state->signal.notify_all();
+
+				state->signal.wait(lock, [&] { return state->resumed; });
+			});
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(state->mutex);
+			state->signal.wait(lock, [&] { return state->suspendedArenaCount == m_arenas.size(); });
+		}
+
+		func();
+
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->resumed = true;
+		}
+		state->signal.notify_all();
 	}
 }
@@ -10,11 +10,14 @@
 #include <Shared/BaseApplication.hpp>
 #include <Shared/Protocol/NetworkStringStore.hpp>
 #include <Nazara/Core/MemoryPool.hpp>
+#include <Server/AdmissionGate.hpp>
+#include <Server/ArchetypeRegistry.hpp>
 #include <Server/Arena.hpp>
 #include <Server/GameWorker.hpp>
 #include <Server/GlobalDatabase.hpp>
 #include <Server/ServerCommandStore.hpp>
 #include <Server/ServerChatCommandStore.hpp>
+#include <Server/TaskPool.hpp>
 #include <Server/Store/CollisionMeshStore.hpp>
 #include <Server/Store/ModuleStore.hpp>
 #include <Server/Store/SpaceshipHullStore.hpp>
@@ -39,15 +42,20 @@ namespace ewn
 
 			inline void DispatchWork(WorkerFunction workFunc);
 
+			Player* FindPlayerByName(const std::string& name) const;
+
+			inline const ArchetypeRegistry& GetArchetypeRegistry() const;
 			inline Database& GetGlobalDatabase();
 			inline CollisionMeshStore& GetCollisionMeshStore();
 			inline const CollisionMeshStore& GetCollisionMeshStore() const;
+			inline const ServerCommandStore& GetCommandStore() const;
 			inline ModuleStore& GetModuleStore();
 			inline const ModuleStore& GetModuleStore() const;
 			inline std::size_t GetPeerPerReactor() const;
 			inline const NetworkStringStore& GetNetworkStringStore() const;
 			inline SpaceshipHullStore& GetSpaceshipHullStore();
 			inline const SpaceshipHullStore& GetSpaceshipHullStore() const;
+			inline TaskPool& GetTaskPool();
 
 			bool LoadDatabase();
 
@@ -60,6 +68,7 @@ namespace ewn
 			void HandlePlayerChat(std::size_t peerId, const Packets::PlayerChat& data);
 			void HandlePlayerMovement(std::size_t peerId, const Packets::PlayerMovement& data);
 			void HandlePlayerShoot(std::size_t peerId, const Packets::PlayerShoot& data);
+			void HandleQueryNetworkStrings(std::size_t peerId, const Packets::QueryNetworkStrings& data);
 			void HandleQuerySpaceshipInfo(std::size_t peerId, const Packets::QuerySpaceshipInfo& data);
 			void HandleQuerySpaceshipList(std::size_t peerId, const Packets::QuerySpaceshipList& data);
 			void HandleRegister(std::size_t peerId, const Packets::Register& data);
@@ -69,32 +78,69 @@ namespace ewn
 
 			inline void RegisterCallback(ServerCallback callback);
 
+			void ReloadModules(std::function<void(bool success)> callback);
+
+			void SetNetworkImpairment(const NetworkReactor::Impairment& impairment);
+
 			bool SetupNetwork(std::size_t clientPerReactor, std::size_t reactorCount, Nz::NetProtocol protocol, Nz::UInt16 firstPort);
 
 		private:
 			using CallbackQueue = moodycamel::ConcurrentQueue<ServerCallback>;
 			using WorkerQueue = moodycamel::BlockingConcurrentQueue<WorkerFunction>;
 
+			Arena* CreateArena();
+			Arena* FindArenaForPlayer();
+			const CommandStore::SerializedPacket& GetNetworkStringsPacket();
 			inline WorkerQueue& GetWorkerQueue();
 
+			template<typename T> void SendFastPathPacket(NetworkReactor& reactor, std::size_t peerId, const T& packet) const;
+
 			void HandlePeerConnection(bool outgoing, std::size_t peerId, Nz::UInt32 data) override;
 			void HandlePeerDisconnection(std::size_t peerId, Nz::UInt32 data) override;
+			void HandlePeerMessage(std::size_t peerId, Packets::AnyPacket&& message) override;
 			void HandlePeerPacket(std::size_t peerId, Nz::NetPacket&& packet) override;
 
 			void InitGameWorkers(std::size_t workerCount);
 			void InitGlobalDatabase(std::size_t workerCount, std::string dbHost, Nz::UInt16 port, std::string dbUser, std::string dbPassword, std::string dbName);
 
+			void InvalidateNetworkStrings();
+
 			void OnConfigLoaded(const ConfigFile& config) override;
 
+			void ReclaimArenas();
+
 			void RegisterConfigOptions();
+			void RegisterFastPathHandlers(NetworkReactor& reactor);
 			void RegisterNetworkedStrings();
 
+			void StartAuthentication(Player* player, const std::string& login, const std::string& passwordHash);
+
+			void SuspendArenas(const std::function<void()>& func);
+
+			struct ArenaInstance
+			{
+				std::unique_ptr<Arena> arena;
+				Nz::UInt64 emptySince = 0; //< Application time since which the arena has no player (0 if it has some)
+			};
+
+			std::optional<CommandStore::SerializedPacket> m_networkStringsPacket;
 			std::optional<GlobalDatabase> m_globalDatabase;
+			std::optional<TaskPool> m_taskPool;
+			std::size_t m_arenaMaxEntities;
+			std::size_t m_arenaMaxInstances;
+			std::size_t m_arenaMaxPlayers;
 			std::size_t m_peerPerReactor;
 			std::vector<std::unique_ptr<GameWorker>> m_workers;
+			std::vector<Player*> m_leavingPlayers;
 			std::vector<Player*> m_players;
-			std::vector<std::unique_ptr<Arena>> m_arenas;
+			std::vector<ArenaInstance> m_arenas;
 			Nz::MemoryPool m_playerPool;
+			NetworkReactor::Impairment m_networkImpairment;
+			AdmissionGate m_authenticatingGate;
+			AdmissionGate m_connectingGate;
+			AdmissionGate m_inArenaGate;
+			AdmissionGate m_loadingGate;
+			ArchetypeRegistry m_archetypeRegistry;
 			CallbackQueue m_callbackQueue;
 			CollisionMeshStore m_collisionMeshStore;
 			ModuleStore m_moduleStore;
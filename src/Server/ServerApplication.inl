@@ -11,6 +11,11 @@ namespace ewn
 		m_workerQueue.enqueue(std::move(workFunc));
 	}
 
+	inline const ArchetypeRegistry& ServerApplication::GetArchetypeRegistry() const
+	{
+		return m_archetypeRegistry;
+	}
+
 	inline Database& ServerApplication::GetGlobalDatabase()
 	{
 		assert(m_globalDatabase.has_value());
@@ -27,6 +32,11 @@ namespace ewn
 		return m_collisionMeshStore;
 	}
 
+	inline const ServerCommandStore& ServerApplication::GetCommandStore() const
+	{
+		return m_commandStore;
+	}
+
 	inline ModuleStore& ServerApplication::GetModuleStore()
 	{
 		return m_moduleStore;
@@ -57,6 +67,12 @@ namespace ewn
 		return m_spaceshipHullStore;
 	}
 
+	inline TaskPool& ServerApplication::GetTaskPool()
+	{
+		assert(m_taskPool.has_value());
+		return *m_taskPool;
+	}
+
 	inline void ServerApplication::RegisterCallback(ServerCallback callback)
 	{
 		m_callbackQueue.enqueue(std::move(callback));
@@ -66,4 +82,16 @@ namespace ewn
 	{
 		return m_workerQueue;
 	}
+
+	template<typename T>
+	void ServerApplication::SendFastPathPacket(NetworkReactor& reactor, std::size_t peerId, const T& packet) const
+	{
+		// Called from the reactor thread, only rely on immutable state (the command store)
+		const auto& command = m_commandStore.GetOutgoingCommand<T>();
+
+		Nz::NetPacket data;
+		m_commandStore.SerializePacket(data, packet);
+
+		reactor.SendData(peerId, command.channelId, command.flags, std::move(data));
+	}
 }
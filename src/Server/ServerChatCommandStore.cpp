@@ -7,32 +7,52 @@
 #include <Server/Player.hpp>
 #include <Server/ServerApplication.hpp>
 #include <Server/Components/HealthComponent.hpp>
+#include <Nazara/Math/Algorithm.hpp>
+#include <string>
 
 namespace ewn
 {
+	namespace
+	{
+		NetworkReactor::Impairment BuildImpairment(Nz::UInt32 latency, Nz::UInt32 jitter, float lossPercent, float duplicationPercent, float reorderPercent)
+		{
+			NetworkReactor::Impairment impairment;
+			impairment.latency = latency;
+			impairment.jitter = jitter;
+			impairment.duplicationChance = Nz::Clamp(duplicationPercent / 100.f, 0.f, 1.f);
+			impairment.lossChance = Nz::Clamp(lossPercent / 100.f, 0.f, 1.f);
+			impairment.reorderChance = Nz::Clamp(reorderPercent / 100.f, 0.f, 1.f);
+
+			return impairment;
+		}
+	}
+
 	bool ChatCommandProcessArg(Player* player, std::string_view& cmdArgs, Player** arg, Nz::TypeTag<Player*>)
 	{
 		std::string playerName;
 		if (!ChatCommandProcessArg(player, cmdArgs, &playerName, Nz::TypeTag<std::string>()))
 			return false;
 
-		if (Player* targetPlayer = player->GetArena()->FindPlayerByName(playerName))
-		{
-			*arg = targetPlayer;
-			return true;
-		}
-		else
+		// Arena player lists belong to arena threads, look for the target on the application side
+		Player* targetPlayer = player->GetApp().FindPlayerByName(playerName);
+		if (!targetPlayer || !targetPlayer->GetArena() || targetPlayer->GetArena() != player->GetArena())
 			return false;
+
+		*arg = targetPlayer;
+		return true;
 	}
 
 	void ServerChatCommandStore::BuildStore(ServerApplication* /*app*/)
 	{
 		RegisterCommand("crashserver", &ServerChatCommandStore::HandleCrashServer);
+		RegisterCommand("impairnetwork", &ServerChatCommandStore::HandleImpairNetwork);
+		RegisterCommand("impairplayer", &ServerChatCommandStore::HandleImpairPlayer);
 		RegisterCommand("kamikaze", &ServerChatCommandStore::HandleSuicide);
 		RegisterCommand("kick", &ServerChatCommandStore::HandleKickPlayer);
 		RegisterCommand("killbot", &ServerChatCommandStore::HandleKillBot);
 		RegisterCommand("reloadmodules", &ServerChatCommandStore::HandleReloadModules);
 		RegisterCommand("resetarena", &ServerChatCommandStore::HandleResetArena);
+		RegisterCommand("spawnstats", &ServerChatCommandStore::HandleSpawnStats);
 		RegisterCommand("suicide", &ServerChatCommandStore::HandleSuicide);
 		RegisterCommand("stopserver", &ServerChatCommandStore::HandleStopServer);
 		RegisterCommand("updatepermission", &ServerChatCommandStore::HandleUpdatePermission);
@@ -48,6 +68,36 @@ namespace ewn
 		return true;
 	}
 
+	bool ServerChatCommandStore::HandleImpairNetwork(ServerApplication* app, Player* player, Nz::UInt32 latency, Nz::UInt32 jitter, float lossPercent, float duplicationPercent, float reorderPercent)
+	{
+		if (player->GetPermissionLevel() < 30)
+			return false;
+
+		NetworkReactor::Impairment impairment = BuildImpairment(latency, jitter, lossPercent, duplicationPercent, reorderPercent);
+
+		app->SetNetworkImpairment(impairment);
+
+		player->PrintMessage((impairment.IsEnabled()) ? "Network impairment updated" : "Network impairment disabled");
+		return true;
+	}
+
+	bool ServerChatCommandStore::HandleImpairPlayer(ServerApplication* /*app*/, Player* player, Player* target, Nz::UInt32 latency, Nz::UInt32 jitter, float lossPercent, float duplicationPercent, float reorderPercent)
+	{
+		if (player->GetPermissionLevel() < 30)
+			return false;
+
+		NetworkReactor::Impairment impairment = BuildImpairment(latency, jitter, lossPercent, duplicationPercent, reorderPercent);
+
+		// A disabled impairment resets the player to the global one
+		if (impairment.IsEnabled())
+			target->SetNetworkImpairment(impairment);
+		else
+			target->SetNetworkImpairment(std::nullopt);
+
+		player->PrintMessage("Network impairment of " + target->GetName() + " updated");
+		return true;
+	}
+
 	bool ServerChatCommandStore::HandleKickPlayer(ServerApplication* app, Player* player, Player* target)
 	{
 		if (player->GetPermissionLevel() < 30)
@@ -65,8 +115,14 @@ namespace ewn
 
 	bool ServerChatCommandStore::HandleKillBot(ServerApplication* /*app*/, Player* player)
 	{
-		if (const Ndk::EntityHandle& botEntity = player->GetBotEntity())
-			botEntity->Kill();
+		if (Arena* arena = player->GetArena())
+		{
+			arena->RegisterPlayerCallback(player, [arena, player]()
+			{
+				if (const Ndk::EntityHandle& botEntity = player->GetBotEntity())
+					arena->GetCommandBuffer().Destroy(botEntity);
+			});
+		}
 
 		return true;
 	}
@@ -76,8 +132,7 @@ namespace ewn
 		if (player->GetPermissionLevel() < 30)
 			return false;
 
-		ModuleStore& moduleStore = app->GetModuleStore();
-		moduleStore.LoadFromDatabase(app, app->GetGlobalDatabase(), [ply = player->CreateHandle()](bool updateSucceeded)
+		app->ReloadModules([ply = player->CreateHandle()](bool updateSucceeded)
 		{
 			if (updateSucceeded)
 				ply->PrintMessage("Module reloaded");
@@ -94,17 +149,60 @@ namespace ewn
 			return false;
 
 		if (Arena* arena = player->GetArena())
-			arena->Reset();
+		{
+			arena->RegisterCallback([arena]()
+			{
+				arena->Reset();
+			});
+		}
+
+		return true;
+	}
+
+	bool ServerChatCommandStore::HandleSpawnStats(ServerApplication* /*app*/, Player* player)
+	{
+		if (player->GetPermissionLevel() < 20)
+			return false;
+
+		if (Arena* arena = player->GetArena())
+		{
+			arena->RegisterPlayerCallback(player, [arena, player]()
+			{
+				auto AverageTime = [](Nz::UInt64 totalTime, Nz::UInt64 count) -> std::string
+				{
+					return (count > 0) ? std::to_string(totalTime / count) + "us" : "-";
+				};
+
+				const auto& spawnStatsByHull = arena->GetSpawnStats();
+				if (spawnStatsByHull.empty())
+				{
+					player->PrintMessage("No spaceship spawned yet");
+					return;
+				}
+
+				for (const auto& [spaceshipHullId, spawnStats] : spawnStatsByHull)
+				{
+					player->PrintMessage("Hull #" + std::to_string(spaceshipHullId) + " spawns: " + std::to_string(spawnStats.createdCount) + " created (avg " + AverageTime(spawnStats.createdTime, spawnStats.createdCount) + "), " +
+					                     std::to_string(spawnStats.reusedCount) + " reused (avg " + AverageTime(spawnStats.reusedTime, spawnStats.reusedCount) + ')');
+				}
+			});
+		}
 
 		return true;
 	}
 
 	bool ServerChatCommandStore::HandleSuicide(ServerApplication* /*app*/, Player* player)
 	{
-		if (const Ndk::EntityHandle& playerSpaceship = player->GetControlledEntity())
+		if (Arena* arena = player->GetArena())
 		{
-			HealthComponent& spaceshipHealth = playerSpaceship->GetComponent<HealthComponent>();
-			spaceshipHealth.Damage(spaceshipHealth.GetHealth(), playerSpaceship);
+			arena->RegisterPlayerCallback(player, [arena, player]()
+			{
+				if (const Ndk::EntityHandle& playerSpaceship = player->GetControlledEntity())
+				{
+					HealthComponent& spaceshipHealth = playerSpaceship->GetComponent<HealthComponent>();
+					arena->GetCommandBuffer().Damage(playerSpaceship, spaceshipHealth.GetHealth(), playerSpaceship);
+				}
+			});
 		}
 
 		return true;
@@ -24,10 +24,13 @@ namespace ewn
 			void BuildStore(ServerApplication* app);
 
 			static bool HandleCrashServer(ServerApplication* app, Player* player);
+			static bool HandleImpairNetwork(ServerApplication* app, Player* player, Nz::UInt32 latency, Nz::UInt32 jitter, float lossPercent, float duplicationPercent, float reorderPercent);
+			static bool HandleImpairPlayer(ServerApplication* app, Player* player, Player* target, Nz::UInt32 latency, Nz::UInt32 jitter, float lossPercent, float duplicationPercent, float reorderPercent);
 			static bool HandleKickPlayer(ServerApplication* app, Player* player, Player* target);
 			static bool HandleKillBot(ServerApplication* app, Player* player);
 			static bool HandleReloadModules(ServerApplication* app, Player* player);
 			static bool HandleResetArena(ServerApplication* app, Player* player);
+			static bool HandleSpawnStats(ServerApplication* app, Player* player);
 			static bool HandleSuicide(ServerApplication* app, Player* player);
 			static bool HandleStopServer(ServerApplication* app, Player* player);
 			static bool HandleUpdatePermission(ServerApplication* app, Player* player, Player* target, Nz::UInt16 permissionLevel);
@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/ServerCommandStore.hpp>
+#include <Shared/Config.hpp>
 #include <Server/ServerApplication.hpp>
 
 namespace ewn
@@ -11,6 +12,8 @@ namespace ewn
 	{
 		using namespace std::placeholders;
 
+		SetMaxIncomingPacketSize(ClientPacketMaxSize);
+
 #define IncomingCommand(Type) RegisterIncomingCommand<Packets::Type>(#Type, [app](std::size_t peerId, const Packets::Type& packet) \
 { \
 	app->Handle##Type(peerId, packet); \
@@ -25,6 +28,7 @@ namespace ewn
 		IncomingCommand(PlayerChat);
 		IncomingCommand(PlayerMovement);
 		IncomingCommand(PlayerShoot);
+		IncomingCommand(QueryNetworkStrings);
 		IncomingCommand(QuerySpaceshipInfo);
 		IncomingCommand(QuerySpaceshipList);
 		IncomingCommand(Register);
@@ -33,6 +37,7 @@ namespace ewn
 		IncomingCommand(UpdateSpaceship);
 
 		// Outgoing commands
+		OutgoingCommand(AdmissionQueuePosition, Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ArenaPrefabs,           Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ArenaSounds,            Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ArenaState,             0,                           0);
@@ -40,11 +45,14 @@ namespace ewn
 		OutgoingCommand(ChatMessage,            Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ControlEntity,          Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(CreateEntity,           Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(CreateProjectile,       Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(DeleteEntity,           Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(DeleteProjectile,       Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(IntegrityUpdate,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(LoginFailure,           Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(LoginSuccess,           Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(NetworkStrings,         Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(NetworkStringsHash,     Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(PlaySound,              Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(RegisterFailure,        Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(RegisterSuccess,        Nz::ENetPacketFlag_Reliable, 0);
@@ -3,10 +3,13 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/SpaceshipCore.hpp>
-#include <NDK/Components/PhysicsComponent3D.hpp>
+#include <NDK/World.hpp>
 #include <Server/SpaceshipModule.hpp>
 #include <Server/Components/HealthComponent.hpp>
-#include <iostream>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <Shared/Utils.hpp>
+#include <mutex>
+#include <type_traits>
 
 namespace ewn
 {
@@ -24,8 +27,8 @@ namespace ewn
 
 	LuaVec3 SpaceshipCore::GetAngularVelocity() const
 	{
-		auto& nodeComponent = m_spaceship->GetComponent<Ndk::PhysicsComponent3D>();
-		return LuaVec3(nodeComponent.GetAngularVelocity());
+		const TransformSnapshotSystem& transforms = m_spaceship->GetWorld()->GetSystem<TransformSnapshotSystem>();
+		return LuaVec3(transforms.GetAngularVelocity(m_spaceship->GetId()));
 	}
 
 	float SpaceshipCore::GetIntegrity() const
@@ -36,25 +39,96 @@ namespace ewn
 
 	LuaVec3 SpaceshipCore::GetLinearVelocity() const
 	{
-		auto& nodeComponent = m_spaceship->GetComponent<Ndk::PhysicsComponent3D>();
-		return LuaVec3(nodeComponent.GetLinearVelocity());
+		const TransformSnapshotSystem& transforms = m_spaceship->GetWorld()->GetSystem<TransformSnapshotSystem>();
+		return LuaVec3(transforms.GetLinearVelocity(m_spaceship->GetId()));
 	}
 
 	LuaVec3 SpaceshipCore::GetPosition() const
 	{
-		auto& nodeComponent = m_spaceship->GetComponent<Ndk::PhysicsComponent3D>();
-		return LuaVec3(nodeComponent.GetPosition());
+		const TransformSnapshotSystem& transforms = m_spaceship->GetWorld()->GetSystem<TransformSnapshotSystem>();
+		return LuaVec3(transforms.GetPosition(m_spaceship->GetId()));
 	}
 
 	LuaQuaternion SpaceshipCore::GetRotation() const
 	{
-		auto& nodeComponent = m_spaceship->GetComponent<Ndk::PhysicsComponent3D>();
-		return LuaQuaternion(nodeComponent.GetRotation());
+		const TransformSnapshotSystem& transforms = m_spaceship->GetWorld()->GetSystem<TransformSnapshotSystem>();
+		return LuaQuaternion(transforms.GetRotation(m_spaceship->GetId()));
+	}
+
+	void SpaceshipCore::PushCallback(Nz::UInt64 triggerTime, CallbackType type, CallbackArgs args, bool unique)
+	{
+		std::size_t& uniqueCallbackIndex = m_uniqueCallbacks[static_cast<std::size_t>(type)];
+		if (unique && uniqueCallbackIndex != InvalidIndex)
+		{
+			// Callback is already waiting, update it and move it to its new place in the heap
+			PendingCallback& callback = m_callbackPool[uniqueCallbackIndex];
+			callback.args = std::move(args);
+			callback.sequence = m_nextCallbackSequence++;
+			callback.triggerTime = triggerTime;
+
+			SiftUp(callback.heapIndex);
+			SiftDown(callback.heapIndex);
+			return;
+		}
+
+		std::size_t poolIndex;
+		if (!m_freeCallbacks.empty())
+		{
+			poolIndex = m_freeCallbacks.back();
+			m_freeCallbacks.pop_back();
+		}
+		else
+		{
+			poolIndex = m_callbackPool.size();
+			m_callbackPool.emplace_back();
+		}
+
+		PendingCallback& callback = m_callbackPool[poolIndex];
+		callback.args = std::move(args);
+		callback.heapIndex = m_callbackHeap.size();
+		callback.sequence = m_nextCallbackSequence++;
+		callback.triggerTime = triggerTime;
+		callback.type = type;
+		callback.unique = unique;
+
+		if (unique)
+			uniqueCallbackIndex = poolIndex;
+
+		m_callbackHeap.push_back(poolIndex);
+		SiftUp(callback.heapIndex);
+	}
+
+	std::optional<std::pair<SpaceshipCore::CallbackType, SpaceshipCore::CallbackArgs>> SpaceshipCore::PopCallback()
+	{
+		if (m_callbackHeap.empty())
+			return {};
+
+		std::size_t poolIndex = m_callbackHeap.front();
+		PendingCallback& callback = m_callbackPool[poolIndex];
+
+		Nz::UInt64 now = m_spaceship->GetComponent<ArenaComponent>().GetArena().GetCurrentTime();
+		if (callback.triggerTime >= now)
+			return {};
+
+		SwapHeapEntries(0, m_callbackHeap.size() - 1);
+		m_callbackHeap.pop_back();
+
+		if (!m_callbackHeap.empty())
+			SiftDown(0);
+
+		if (callback.unique)
+			m_uniqueCallbacks[static_cast<std::size_t>(callback.type)] = InvalidIndex;
+
+		m_freeCallbacks.push_back(poolIndex);
+
+		return std::make_pair(callback.type, std::move(callback.args));
 	}
 
 	void SpaceshipCore::Register(Nz::LuaState& lua)
 	{
-		if (!s_binding)
+		// Bindings are shared by every arena thread, only build them once
+		static std::once_flag bindingFlag;
+		std::call_once(bindingFlag, []()
 		{
 			s_binding.emplace("Core");
 
@@ -63,7 +137,7 @@ namespace ewn
 			s_binding->BindMethod("GetLinearVelocity",  &SpaceshipCore::GetLinearVelocity);
 			s_binding->BindMethod("GetPosition",        &SpaceshipCore::GetPosition);
 			s_binding->BindMethod("GetRotation",        &SpaceshipCore::GetRotation);
-		}
+		});
 
 		s_binding->Register(lua);
 
@@ -79,5 +153,84 @@ namespace ewn
 			modulePtr->Run();
 	}
 
+	const char* SpaceshipCore::GetCallbackName(CallbackType type)
+	{
+		switch (type)
+		{
+			case CallbackType::OnNavigationDestinationReached: return "OnNavigationDestinationReached";
+			case CallbackType::OnRadarNewObjectInRange:        return "OnRadarNewObjectInRange";
+			case CallbackType::OnRadarObjectDestroyed:         return "OnRadarObjectDestroyed";
+			case CallbackType::OnRadarObjectLeftRange:         return "OnRadarObjectLeftRange";
+			case CallbackType::OnStart:                        return "OnStart";
+			case CallbackType::OnTick:                         return "OnTick";
+		}
+
+		return "";
+	}
+
+	int SpaceshipCore::PushCallbackArgs(Nz::LuaState& state, const CallbackArgs& args)
+	{
+		return std::visit([&](auto&& arg) -> int
+		{
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, NoArgs>)
+				return 0;
+			else if constexpr (std::is_same_v<T, RadarNewObjectArgs>)
+			{
+				state.Push(arg.entityId);
+				state.Push(arg.objectType);
+				state.Push(LuaVec3(arg.position));
+				return 3;
+			}
+			else if constexpr (std::is_same_v<T, RadarObjectArgs>)
+			{
+				state.Push(arg.entityId);
+				state.Push(LuaVec3(arg.position));
+				return 2;
+			}
+			else if constexpr (std::is_same_v<T, TickArgs>)
+			{
+				state.Push(arg.elapsedTime);
+				return 1;
+			}
+			else
+				static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+		}, args);
+	}
+
+	void SpaceshipCore::SiftDown(std::size_t heapIndex)
+	{
+		std::size_t heapSize = m_callbackHeap.size();
+		for (;;)
+		{
+			std::size_t firstChild = heapIndex * 2 + 1;
+			if (firstChild >= heapSize)
+				break;
+
+			std::size_t dueChild = firstChild;
+			if (firstChild + 1 < heapSize && IsCallbackDue(firstChild + 1, firstChild))
+				dueChild = firstChild + 1;
+
+			if (!IsCallbackDue(dueChild, heapIndex))
+				break;
+
+			SwapHeapEntries(heapIndex, dueChild);
+			heapIndex = dueChild;
+		}
+	}
+
+	void SpaceshipCore::SiftUp(std::size_t heapIndex)
+	{
+		while (heapIndex > 0)
+		{
+			std::size_t parent = (heapIndex - 1) / 2;
+			if (!IsCallbackDue(heapIndex, parent))
+				break;
+
+			SwapHeapEntries(heapIndex, parent);
+			heapIndex = parent;
+		}
+	}
+
 	std::optional<Nz::LuaClass<SpaceshipCoreHandle>> SpaceshipCore::s_binding;
 }
@@ -12,9 +12,11 @@
 #include <Nazara/Lua/LuaClass.hpp>
 #include <NDK/Entity.hpp>
 #include <Server/Scripting/LuaMathTypes.hpp>
-#include <functional>
+#include <array>
+#include <limits>
 #include <optional>
-#include <unordered_map>
+#include <string>
+#include <variant>
 #include <vector>
 
 namespace ewn
@@ -27,7 +29,25 @@ namespace ewn
 	class SpaceshipCore : public Nz::HandledObject<SpaceshipCore>
 	{
 		public:
-			using CallbackArgFunction = std::function<int(Nz::LuaState& state)>;
+			struct NoArgs {};
+			struct RadarNewObjectArgs;
+			struct RadarObjectArgs;
+			struct TickArgs;
+
+			using CallbackArgs = std::variant<NoArgs, RadarNewObjectArgs, RadarObjectArgs, TickArgs>;
+
+			// Callbacks are identified by an id instead of their script function name, see GetCallbackName
+			enum class CallbackType : Nz::UInt8
+			{
+				OnNavigationDestinationReached,
+				OnRadarNewObjectInRange,
+				OnRadarObjectDestroyed,
+				OnRadarObjectLeftRange,
+				OnStart,
+				OnTick,
+
+				Max = OnTick
+			};
 
 			inline SpaceshipCore(const Ndk::EntityHandle& spaceship);
 			SpaceshipCore(const SpaceshipCore&) = delete;
@@ -44,25 +64,61 @@ namespace ewn
 			void Register(Nz::LuaState& lua);
 			void Run();
 
-			inline void PushCallback(std::string callbackName, CallbackArgFunction argFunc = nullptr, bool unique = true);
-			inline void PushCallback(Nz::UInt64 triggerTime, std::string callbackName, CallbackArgFunction argFunc = nullptr, bool unique = true);
-			inline std::optional<std::pair<std::string, CallbackArgFunction>> PopCallback();
+			inline void PushCallback(CallbackType type, CallbackArgs args = NoArgs{}, bool unique = true);
+			void PushCallback(Nz::UInt64 triggerTime, CallbackType type, CallbackArgs args = NoArgs{}, bool unique = true);
+			std::optional<std::pair<CallbackType, CallbackArgs>> PopCallback();
 
 			SpaceshipCore& operator=(const SpaceshipCore&) = delete;
 
+			static const char* GetCallbackName(CallbackType type);
+			static int PushCallbackArgs(Nz::LuaState& state, const CallbackArgs& args);
+
+			static constexpr std::size_t CallbackTypeCount = static_cast<std::size_t>(CallbackType::Max) + 1;
+
+			struct RadarNewObjectArgs
+			{
+				Ndk::EntityId entityId;
+				Nz::Vector3f position;
+				std::string objectType;
+			};
+
+			struct RadarObjectArgs
+			{
+				Ndk::EntityId entityId;
+				Nz::Vector3f position;
+			};
+
+			struct TickArgs
+			{
+				float elapsedTime;
+			};
+
 		private:
-			struct Callback
+			inline bool IsCallbackDue(std::size_t lhsHeapIndex, std::size_t rhsHeapIndex) const;
+			void SiftDown(std::size_t heapIndex);
+			void SiftUp(std::size_t heapIndex);
+			inline void SwapHeapEntries(std::size_t firstHeapIndex, std::size_t secondHeapIndex);
+
+			static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+			struct PendingCallback
 			{
+				CallbackArgs args;
+				Nz::UInt64 sequence; //< Callbacks with the same trigger time run in the order they were pushed
 				Nz::UInt64 triggerTime;
-				std::string callbackName;
-				CallbackArgFunction argFunc;
+				std::size_t heapIndex;
+				CallbackType type;
+				bool unique;
 			};
 
-			std::unordered_map<std::string, bool> m_pushedCallbacks;
+			std::array<std::size_t, CallbackTypeCount> m_uniqueCallbacks; //< Pool index of the waiting unique callback of each type
 			std::vector<std::shared_ptr<SpaceshipModule>> m_modules;
 			std::vector<std::shared_ptr<SpaceshipModule>> m_runnableModules;
-			std::vector<Callback> m_callbacks;
+			std::vector<std::size_t> m_callbackHeap; //< Pool indices, min-heap on trigger time
+			std::vector<std::size_t> m_freeCallbacks;
+			std::vector<PendingCallback> m_callbackPool; //< Slots are reused, never shrinks
 			Ndk::EntityHandle m_spaceship;
+			Nz::UInt64 m_nextCallbackSequence;
 
 			static std::optional<Nz::LuaClass<SpaceshipCoreHandle>> s_binding;
 	};
@@ -3,84 +3,40 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/SpaceshipCore.hpp>
-#include <Server/ServerApplication.hpp>
+#include <Server/Arena.hpp>
+#include <Server/Components/ArenaComponent.hpp>
 
 namespace ewn
 {
 	inline SpaceshipCore::SpaceshipCore(const Ndk::EntityHandle& spaceship) :
-	m_spaceship(spaceship)
+	m_spaceship(spaceship),
+	m_nextCallbackSequence(0)
 	{
+		m_uniqueCallbacks.fill(InvalidIndex);
 	}
 
-	inline void SpaceshipCore::PushCallback(std::string callbackName, CallbackArgFunction argFunc, bool unique)
+	inline void SpaceshipCore::PushCallback(CallbackType type, CallbackArgs args, bool unique)
 	{
-		PushCallback(ServerApplication::GetAppTime(), std::move(callbackName), std::move(argFunc), unique);
+		PushCallback(m_spaceship->GetComponent<ArenaComponent>().GetArena().GetCurrentTime(), type, std::move(args), unique);
 	}
 
-	inline void SpaceshipCore::PushCallback(Nz::UInt64 triggerTime, std::string callbackName, CallbackArgFunction argFunc, bool unique)
+	inline bool SpaceshipCore::IsCallbackDue(std::size_t lhsHeapIndex, std::size_t rhsHeapIndex) const
 	{
-		auto SortCallbacks = [](const Callback& lhs, const Callback& rhs)
-		{
-			return lhs.triggerTime > rhs.triggerTime;
-		};
+		const PendingCallback& lhs = m_callbackPool[m_callbackHeap[lhsHeapIndex]];
+		const PendingCallback& rhs = m_callbackPool[m_callbackHeap[rhsHeapIndex]];
 
-		// Check if callback is already in the waiting queue
-		if (unique)
-		{
-			auto it = m_pushedCallbacks.find(callbackName);
-			if (it == m_pushedCallbacks.end())
-				it = m_pushedCallbacks.emplace(callbackName, true).first;
-			else if (it->second)
-			{
-				// If callback is already present, update its trigger time and resort callback
-				for (auto callbackIt = m_callbacks.begin(); callbackIt != m_callbacks.end(); ++callbackIt)
-				{
-					if (callbackIt->callbackName == callbackName)
-					{
-						callbackIt->argFunc = std::move(argFunc);
-						callbackIt->triggerTime = triggerTime;
-						std::sort(m_callbacks.begin(), m_callbacks.end(), SortCallbacks);
-						return;
-					}
-				}
-			}
-			else
-				it->second = true;
-		}
+		if (lhs.triggerTime != rhs.triggerTime)
+			return lhs.triggerTime < rhs.triggerTime;
 
-		// Insert a new callback in the queue
-		Callback callback;
-		callback.argFunc = std::move(argFunc);
-		callback.callbackName = std::move(callbackName);
-		callback.triggerTime = triggerTime;
-
-		auto callbackIt = std::upper_bound(m_callbacks.begin(), m_callbacks.end(), callback, SortCallbacks);
-
-		m_callbacks.emplace(callbackIt, std::move(callback));
+		return lhs.sequence < rhs.sequence;
 	}
 
-	inline std::optional<std::pair<std::string, SpaceshipCore::CallbackArgFunction>> SpaceshipCore::PopCallback()
+	inline void SpaceshipCore::SwapHeapEntries(std::size_t firstHeapIndex, std::size_t secondHeapIndex)
 	{
-		if (m_callbacks.empty())
-			return {};
-
-		Nz::UInt64 now = ServerApplication::GetAppTime();
-		if (m_callbacks.back().triggerTime >= now)
-			return {};
-
-		Callback callback = std::move(m_callbacks.back());
-		m_callbacks.pop_back();
-
-		auto it = m_pushedCallbacks.find(callback.callbackName);
-		if (it != m_pushedCallbacks.end())
-		{
-			assert(it->second);
-			it->second = false;
-		}
-
-		std::cout << "Executing " << callback.callbackName << " (late by " << (now - callback.triggerTime) << "ms)" << std::endl;
+		std::swap(m_callbackHeap[firstHeapIndex], m_callbackHeap[secondHeapIndex]);
 
-		return std::make_pair(callback.callbackName, std::move(callback.argFunc));
+		m_callbackPool[m_callbackHeap[firstHeapIndex]].heapIndex = firstHeapIndex;
+		m_callbackPool[m_callbackHeap[secondHeapIndex]].heapIndex = secondHeapIndex;
 	}
 }
 
@@ -0,0 +1,47 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SpatialGrid.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	void SpatialGrid::Build()
+	{
+		// Entries of the same cell are made contiguous, cells only store a range
+		std::sort(m_entries.begin(), m_entries.end(), [](const KeyedEntry& lhs, const KeyedEntry& rhs)
+		{
+			return lhs.cellKey < rhs.cellKey;
+		});
+
+		m_cells.clear();
+		for (std::size_t i = 0; i < m_entries.size(); ++i)
+		{
+			auto [it, inserted] = m_cells.try_emplace(m_entries[i].cellKey, CellRange{ i, 0 });
+			it->second.count++;
+		}
+	}
+
+	void SpatialGrid::FindNearest(const Nz::Vector3f& center, float maxRadius, std::size_t maxCount, std::vector<Entry>& results) const
+	{
+		results.clear();
+		ForEachInSphere(center, maxRadius, [&](const Entry& entry)
+		{
+			results.push_back(entry);
+		});
+
+		auto CompareDistance = [&](const Entry& lhs, const Entry& rhs)
+		{
+			return lhs.position.SquaredDistance(center) < rhs.position.SquaredDistance(center);
+		};
+
+		if (results.size() > maxCount)
+		{
+			std::partial_sort(results.begin(), results.begin() + maxCount, results.end(), CompareDistance);
+			results.resize(maxCount);
+		}
+		else
+			std::sort(results.begin(), results.end(), CompareDistance);
+	}
+}
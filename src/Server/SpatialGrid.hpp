@@ -0,0 +1,82 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_SPATIALGRID_HPP
+#define EREWHON_SERVER_SPATIALGRID_HPP
+
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/Entity.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace ewn
+{
+	// Uniform grid of entity positions, meant to be rebuilt from scratch (Clear, Insert, Build) when positions change
+	class SpatialGrid
+	{
+		public:
+			struct Entry;
+
+			inline SpatialGrid(float cellSize);
+			~SpatialGrid() = default;
+
+			void Build();
+
+			inline void Clear();
+
+			void FindNearest(const Nz::Vector3f& center, float maxRadius, std::size_t maxCount, std::vector<Entry>& results) const;
+
+			template<typename F> void ForEachInCone(const Nz::Vector3f& origin, const Nz::Vector3f& direction, float halfAngle, float range, F&& callback) const;
+			template<typename F> void ForEachInSphere(const Nz::Vector3f& center, float radius, F&& callback) const;
+			template<typename F> void ForEachOnSegment(const Nz::Vector3f& from, const Nz::Vector3f& to, float radius, F&& callback) const;
+
+			inline std::size_t GetEntryCount() const;
+
+			inline void Insert(Ndk::EntityId entityId, const Nz::Vector3f& position, float radius);
+
+			static inline bool ComputeSegmentHitFactor(const Nz::Vector3f& from, const Nz::Vector3f& to, const Nz::Vector3f& center, float radius, float* factor);
+
+			struct Entry
+			{
+				Ndk::EntityId entityId;
+				Nz::Vector3f position;
+				float radius; //< Bounding radius, only used by segment queries
+			};
+
+		private:
+			struct CellCoords
+			{
+				int x;
+				int y;
+				int z;
+			};
+
+			struct CellRange
+			{
+				std::size_t first;
+				std::size_t count;
+			};
+
+			struct KeyedEntry
+			{
+				Nz::UInt64 cellKey;
+				Entry entry;
+			};
+
+			inline CellCoords ComputeCellCoords(const Nz::Vector3f& position) const;
+			static inline Nz::UInt64 ComputeCellKey(const CellCoords& coords);
+
+			std::unordered_map<Nz::UInt64, CellRange> m_cells;
+			std::vector<KeyedEntry> m_entries;
+			float m_cellSize;
+			float m_invCellSize;
+			float m_maxEntryRadius;
+	};
+}
+
+#include <Server/SpatialGrid.inl>
+
+#endif // EREWHON_SERVER_SPATIALGRID_HPP
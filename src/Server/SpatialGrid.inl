@@ -0,0 +1,160 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SpatialGrid.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ewn
+{
+	inline SpatialGrid::SpatialGrid(float cellSize) :
+	m_cellSize(cellSize),
+	m_invCellSize(1.f / cellSize),
+	m_maxEntryRadius(0.f)
+	{
+		assert(cellSize > 0.f);
+	}
+
+	inline void SpatialGrid::Clear()
+	{
+		m_cells.clear();
+		m_entries.clear();
+		m_maxEntryRadius = 0.f;
+	}
+
+	// Callback is called with entries in the cone (halfAngle in radians), apex excluded
+	template<typename F>
+	void SpatialGrid::ForEachInCone(const Nz::Vector3f& origin, const Nz::Vector3f& direction, float halfAngle, float range, F&& callback) const
+	{
+		float cosHalfAngle = std::cos(halfAngle);
+		Nz::Vector3f normalizedDirection = Nz::Vector3f::Normalize(direction);
+
+		ForEachInSphere(origin, range, [&](const Entry& entry)
+		{
+			Nz::Vector3f offset = entry.position - origin;
+			float distance = offset.GetLength();
+			if (distance > 0.f && offset.DotProduct(normalizedDirection) >= cosHalfAngle * distance)
+				callback(entry);
+		});
+	}
+
+	template<typename F>
+	void SpatialGrid::ForEachInSphere(const Nz::Vector3f& center, float radius, F&& callback) const
+	{
+		float squaredRadius = radius * radius;
+		auto CheckRange = [&](const CellRange& range)
+		{
+			for (std::size_t i = range.first; i < range.first + range.count; ++i)
+			{
+				const Entry& entry = m_entries[i].entry;
+				if (entry.position.SquaredDistance(center) <= squaredRadius)
+					callback(entry);
+			}
+		};
+
+		CellCoords minCell = ComputeCellCoords(center - Nz::Vector3f(radius));
+		CellCoords maxCell = ComputeCellCoords(center + Nz::Vector3f(radius));
+
+		std::size_t cellCount = std::size_t(maxCell.x - minCell.x + 1) * std::size_t(maxCell.y - minCell.y + 1) * std::size_t(maxCell.z - minCell.z + 1);
+		if (cellCount > m_cells.size())
+		{
+			// Query covers more cells than there are occupied ones, checking them all is cheaper
+			for (const auto& pair : m_cells)
+				CheckRange(pair.second);
+
+			return;
+		}
+
+		for (int z = minCell.z; z <= maxCell.z; ++z)
+		{
+			for (int y = minCell.y; y <= maxCell.y; ++y)
+			{
+				for (int x = minCell.x; x <= maxCell.x; ++x)
+				{
+					auto it = m_cells.find(ComputeCellKey({ x, y, z }));
+					if (it != m_cells.end())
+						CheckRange(it->second);
+				}
+			}
+		}
+	}
+
+	// Callback is called with entries whose bounding sphere (inflated by radius) is crossed by the segment, along with the entry factor in [0, 1]
+	template<typename F>
+	void SpatialGrid::ForEachOnSegment(const Nz::Vector3f& from, const Nz::Vector3f& to, float radius, F&& callback) const
+	{
+		Nz::Vector3f direction = to - from;
+		float queryRadius = direction.GetLength() / 2.f + radius + m_maxEntryRadius;
+
+		ForEachInSphere(from + direction / 2.f, queryRadius, [&](const Entry& entry)
+		{
+			float factor;
+			if (ComputeSegmentHitFactor(from, to, entry.position, entry.radius + radius, &factor))
+				callback(entry, factor);
+		});
+	}
+
+	inline std::size_t SpatialGrid::GetEntryCount() const
+	{
+		return m_entries.size();
+	}
+
+	// Entries are only queryable after the next Build call
+	inline void SpatialGrid::Insert(Ndk::EntityId entityId, const Nz::Vector3f& position, float radius)
+	{
+		KeyedEntry& keyedEntry = m_entries.emplace_back();
+		keyedEntry.cellKey = ComputeCellKey(ComputeCellCoords(position));
+		keyedEntry.entry.entityId = entityId;
+		keyedEntry.entry.position = position;
+		keyedEntry.entry.radius = radius;
+
+		m_maxEntryRadius = std::max(m_maxEntryRadius, radius);
+	}
+
+	// Returns true if the segment crosses the sphere, factor (in [0, 1]) is where it enters it
+	inline bool SpatialGrid::ComputeSegmentHitFactor(const Nz::Vector3f& from, const Nz::Vector3f& to, const Nz::Vector3f& center, float radius, float* factor)
+	{
+		Nz::Vector3f direction = to - from;
+		float squaredLength = direction.GetSquaredLength();
+
+		Nz::Vector3f offset = from - center;
+		float c = offset.GetSquaredLength() - radius * radius;
+		if (c <= 0.f)
+		{
+			// Segment starts inside the sphere
+			*factor = 0.f;
+			return true;
+		}
+
+		if (squaredLength <= 0.f)
+			return false;
+
+		float b = offset.DotProduct(direction);
+		float discriminant = b * b - squaredLength * c;
+		if (discriminant < 0.f)
+			return false;
+
+		*factor = (-b - std::sqrt(discriminant)) / squaredLength;
+		return *factor >= 0.f && *factor <= 1.f;
+	}
+
+	inline SpatialGrid::CellCoords SpatialGrid::ComputeCellCoords(const Nz::Vector3f& position) const
+	{
+		CellCoords coords;
+		coords.x = static_cast<int>(std::floor(position.x * m_invCellSize));
+		coords.y = static_cast<int>(std::floor(position.y * m_invCellSize));
+		coords.z = static_cast<int>(std::floor(position.z * m_invCellSize));
+
+		return coords;
+	}
+
+	inline Nz::UInt64 SpatialGrid::ComputeCellKey(const CellCoords& coords)
+	{
+		// 21 bits per axis, coordinates wrap around far away from the origin (which only costs extra distance checks)
+		constexpr Nz::UInt64 AxisMask = (Nz::UInt64(1) << 21) - 1;
+
+		return ((Nz::UInt64(coords.x) & AxisMask) << 42) | ((Nz::UInt64(coords.y) & AxisMask) << 21) | (Nz::UInt64(coords.z) & AxisMask);
+	}
+}
@@ -0,0 +1,106 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/StateHistory.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ewn
+{
+	StateHistory::StateHistory(std::size_t tickCount) :
+	m_frames(tickCount),
+	m_latestTick(0),
+	m_frameCount(0)
+	{
+		assert(tickCount > 0);
+	}
+
+	// Frames must be recorded for consecutive ticks, history restarts if a tick is missing
+	void StateHistory::BeginFrame(Nz::UInt64 tick)
+	{
+		if (m_frameCount > 0 && tick == m_latestTick + 1)
+			m_frameCount = std::min(m_frameCount + 1, m_frames.size());
+		else
+			m_frameCount = 1;
+
+		m_latestTick = tick;
+
+		Frame& frame = GetFrame(tick);
+		frame.entries.clear(); //< Keeps its capacity, memory usage is bounded by the tick count
+		frame.isValid = false;
+		frame.maxStep = 0.f;
+		frame.tick = tick;
+	}
+
+	void StateHistory::EndFrame()
+	{
+		Frame& frame = GetFrame(m_latestTick);
+
+		auto CompareIds = [](const Entry& lhs, const Entry& rhs)
+		{
+			return lhs.entityId < rhs.entityId;
+		};
+
+		// Entities are usually iterated in id order already
+		if (!std::is_sorted(frame.entries.begin(), frame.entries.end(), CompareIds))
+			std::sort(frame.entries.begin(), frame.entries.end(), CompareIds);
+
+		frame.isValid = true;
+
+		if (m_frameCount < 2)
+			return;
+
+		// Both frames are sorted by id, walk them together to find the largest move
+		const Frame& previousFrame = GetFrame(m_latestTick - 1);
+
+		float maxSquaredStep = 0.f;
+		auto previousIt = previousFrame.entries.begin();
+		for (const Entry& entry : frame.entries)
+		{
+			while (previousIt != previousFrame.entries.end() && previousIt->entityId < entry.entityId)
+				++previousIt;
+
+			if (previousIt == previousFrame.entries.end())
+				break;
+
+			if (previousIt->entityId == entry.entityId)
+				maxSquaredStep = std::max(maxSquaredStep, entry.position.SquaredDistance(previousIt->position));
+		}
+
+		frame.maxStep = std::sqrt(maxSquaredStep);
+	}
+
+	// O(log n) lookup of an entity position at a past tick, returns nullptr if the tick is too old or if the entity didn't exist back then
+	const StateHistory::Entry* StateHistory::FindEntry(Nz::UInt64 tick, Ndk::EntityId entityId) const
+	{
+		if (!HasTick(tick))
+			return nullptr;
+
+		const Frame& frame = GetFrame(tick);
+		assert(frame.isValid && frame.tick == tick);
+
+		auto it = std::lower_bound(frame.entries.begin(), frame.entries.end(), entityId, [](const Entry& entry, Ndk::EntityId id)
+		{
+			return entry.entityId < id;
+		});
+
+		if (it == frame.entries.end() || it->entityId != entityId)
+			return nullptr;
+
+		return &*it;
+	}
+
+	// Upper bound of the distance any entity moved between this tick and the latest one
+	float StateHistory::GetMaxDisplacement(Nz::UInt64 fromTick) const
+	{
+		assert(HasTick(fromTick));
+
+		float displacement = 0.f;
+		for (Nz::UInt64 tick = fromTick + 1; tick <= m_latestTick; ++tick)
+			displacement += GetFrame(tick).maxStep;
+
+		return displacement;
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_STATEHISTORY_HPP
+#define EREWHON_SERVER_STATEHISTORY_HPP
+
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/Entity.hpp>
+#include <vector>
+
+namespace ewn
+{
+	// Ring buffer of entity positions over the last ticks, lets hit detection rewind to what a lagging player saw
+	class StateHistory
+	{
+		public:
+			struct Entry;
+
+			StateHistory(std::size_t tickCount);
+			~StateHistory() = default;
+
+			void BeginFrame(Nz::UInt64 tick);
+			void EndFrame();
+
+			const Entry* FindEntry(Nz::UInt64 tick, Ndk::EntityId entityId) const;
+
+			float GetMaxDisplacement(Nz::UInt64 fromTick) const;
+			inline Nz::UInt64 GetOldestTick() const;
+			inline Nz::UInt64 GetLatestTick() const;
+
+			inline bool HasTick(Nz::UInt64 tick) const;
+
+			inline void Insert(Ndk::EntityId entityId, const Nz::Vector3f& position, float radius);
+
+			struct Entry
+			{
+				Ndk::EntityId entityId;
+				Nz::Vector3f position;
+				float radius;
+			};
+
+		private:
+			struct Frame
+			{
+				std::vector<Entry> entries; //< Sorted by entity id
+				Nz::UInt64 tick = 0;
+				float maxStep = 0.f; //< How far an entity moved at most since the previous frame
+				bool isValid = false;
+			};
+
+			inline Frame& GetFrame(Nz::UInt64 tick);
+			inline const Frame& GetFrame(Nz::UInt64 tick) const;
+
+			std::vector<Frame> m_frames;
+			Nz::UInt64 m_latestTick;
+			std::size_t m_frameCount;
+	};
+}
+
+#include <Server/StateHistory.inl>
+
+#endif // EREWHON_SERVER_STATEHISTORY_HPP
@@ -0,0 +1,44 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/StateHistory.hpp>
+#include <cassert>
+
+namespace ewn
+{
+	inline Nz::UInt64 StateHistory::GetOldestTick() const
+	{
+		assert(m_frameCount > 0);
+		return m_latestTick - (m_frameCount - 1);
+	}
+
+	inline Nz::UInt64 StateHistory::GetLatestTick() const
+	{
+		return m_latestTick;
+	}
+
+	inline bool StateHistory::HasTick(Nz::UInt64 tick) const
+	{
+		return m_frameCount > 0 && tick <= m_latestTick && tick >= GetOldestTick();
+	}
+
+	// Entries can only be inserted between BeginFrame and EndFrame
+	inline void StateHistory::Insert(Ndk::EntityId entityId, const Nz::Vector3f& position, float radius)
+	{
+		Entry& entry = GetFrame(m_latestTick).entries.emplace_back();
+		entry.entityId = entityId;
+		entry.position = position;
+		entry.radius = radius;
+	}
+
+	inline StateHistory::Frame& StateHistory::GetFrame(Nz::UInt64 tick)
+	{
+		return m_frames[tick % m_frames.size()];
+	}
+
+	inline const StateHistory::Frame& StateHistory::GetFrame(Nz::UInt64 tick) const
+	{
+		return m_frames[tick % m_frames.size()];
+	}
+}
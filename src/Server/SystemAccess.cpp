@@ -0,0 +1,33 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SystemAccess.hpp>
+
+namespace ewn
+{
+	// Written data can't be read or written by the other system meanwhile, reads don't conflict with each other
+	bool SystemAccess::ConflictsWith(const SystemAccess& access) const
+	{
+		if (m_isExclusive || access.m_isExclusive)
+			return true;
+
+		if (m_writtenComponents.Intersects(access.m_readComponents) || m_writtenComponents.Intersects(access.m_writtenComponents))
+			return true;
+
+		if (access.m_writtenComponents.Intersects(m_readComponents))
+			return true;
+
+		// Deferred writes are played back in stage order, they only conflict with immediate accesses
+		if (m_deferredComponents.Intersects(access.m_readComponents) || m_deferredComponents.Intersects(access.m_writtenComponents))
+			return true;
+
+		if (access.m_deferredComponents.Intersects(m_readComponents) || access.m_deferredComponents.Intersects(m_writtenComponents))
+			return true;
+
+		if ((m_writtenResources & (access.m_readResources | access.m_writtenResources)).any())
+			return true;
+
+		return (access.m_writtenResources & m_readResources).any();
+	}
+}
@@ -0,0 +1,61 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_SYSTEMACCESS_HPP
+#define EREWHON_SERVER_SYSTEMACCESS_HPP
+
+#include <Nazara/Core/Bitset.hpp>
+#include <bitset>
+
+namespace ewn
+{
+	// Data shared between systems which isn't a component
+	enum class SharedResource
+	{
+		ArenaState,        //< Players, packets, projectiles and timers of the arena
+		EntityHandles,     //< Creating or releasing handles to other entities (handle lists aren't thread-safe)
+		SpatialGrid,       //< SpatialIndexSystem grid and position history
+		TransformSnapshot, //< TransformSnapshotSystem transforms and velocities
+
+		Max = TransformSnapshot
+	};
+
+	// What a system touches during its update, two systems can be updated at the same time if they don't conflict
+	// Tick counters and read-only stores are not declared, they don't change while the world is updated (stores are only reloaded while arenas are suspended)
+	class SystemAccess
+	{
+		public:
+			SystemAccess() = default;
+			~SystemAccess() = default;
+
+			bool ConflictsWith(const SystemAccess& access) const;
+
+			inline bool IsExclusive() const;
+
+			inline SystemAccess& MakeExclusive();
+
+			template<typename... Components> SystemAccess& Read();
+			inline SystemAccess& Read(SharedResource resource);
+
+			template<typename... Components> SystemAccess& Write();
+			inline SystemAccess& Write(SharedResource resource);
+			template<typename... Components> SystemAccess& WriteDeferred();
+
+		private:
+			using ResourceBits = std::bitset<static_cast<std::size_t>(SharedResource::Max) + 1>;
+
+			Nz::Bitset<> m_deferredComponents; //< Written through the system command buffer, once its stage is done
+			Nz::Bitset<> m_readComponents;
+			Nz::Bitset<> m_writtenComponents;
+			ResourceBits m_readResources;
+			ResourceBits m_writtenResources;
+			bool m_isExclusive = false; //< Runs alone (scripts may do anything)
+	};
+}
+
+#include <Server/SystemAccess.inl>
+
+#endif // EREWHON_SERVER_SYSTEMACCESS_HPP
@@ -0,0 +1,54 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SystemAccess.hpp>
+#include <NDK/Algorithm.hpp>
+
+namespace ewn
+{
+	inline bool SystemAccess::IsExclusive() const
+	{
+		return m_isExclusive;
+	}
+
+	inline SystemAccess& SystemAccess::MakeExclusive()
+	{
+		m_isExclusive = true;
+		return *this;
+	}
+
+	template<typename... Components>
+	SystemAccess& SystemAccess::Read()
+	{
+		(m_readComponents.UnboundedSet(Ndk::GetComponentIndex<Components>()), ...);
+		return *this;
+	}
+
+	inline SystemAccess& SystemAccess::Read(SharedResource resource)
+	{
+		m_readResources.set(static_cast<std::size_t>(resource));
+		return *this;
+	}
+
+	template<typename... Components>
+	SystemAccess& SystemAccess::Write()
+	{
+		(m_writtenComponents.UnboundedSet(Ndk::GetComponentIndex<Components>()), ...);
+		return *this;
+	}
+
+	inline SystemAccess& SystemAccess::Write(SharedResource resource)
+	{
+		m_writtenResources.set(static_cast<std::size_t>(resource));
+		return *this;
+	}
+
+	// Systems only recording changes to a component (see EntityCommandBuffer) can share a stage, but not with systems accessing it
+	template<typename... Components>
+	SystemAccess& SystemAccess::WriteDeferred()
+	{
+		(m_deferredComponents.UnboundedSet(Ndk::GetComponentIndex<Components>()), ...);
+		return *this;
+	}
+}
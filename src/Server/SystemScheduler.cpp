@@ -0,0 +1,104 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SystemScheduler.hpp>
+#include <Server/TaskPool.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	SystemScheduler::SystemScheduler(Arena& arena, Ndk::World& world, TaskPool& taskPool) :
+	m_arena(arena),
+	m_world(world),
+	m_taskPool(taskPool),
+	m_stagesUpdated(false)
+	{
+	}
+
+	void SystemScheduler::Update(float elapsedTime)
+	{
+		if (!m_stagesUpdated)
+			BuildStages();
+
+		// Sync point, entities killed or modified since the last update are handled here (as Ndk::World::Update does)
+		m_world.Refresh();
+
+		for (const Stage& stage : m_stages)
+		{
+			if (stage.systems.size() == 1)
+				UpdateSystem(stage.systems.front(), elapsedTime);
+			else
+			{
+				m_taskPool.Run(stage.systems.size(), [&](std::size_t taskIndex)
+				{
+					UpdateSystem(stage.systems[taskIndex], elapsedTime);
+				});
+			}
+
+			// Sync point, commands are played back in the stage order whichever thread recorded them first
+			for (std::size_t systemIndex : stage.systems)
+			{
+				EntityCommandBuffer& commandBuffer = m_systems[systemIndex].commandBuffer;
+				if (!commandBuffer.IsEmpty())
+					commandBuffer.Playback(m_arena);
+			}
+		}
+	}
+
+	void SystemScheduler::AddSystem(Ndk::BaseSystem& system, const SystemAccess& access)
+	{
+		ScheduledSystem& scheduledSystem = m_systems.emplace_back();
+		scheduledSystem.access = access;
+		scheduledSystem.system = &system;
+
+		m_stagesUpdated = false;
+	}
+
+	void SystemScheduler::BuildStages()
+	{
+		std::vector<std::size_t> orderedSystems(m_systems.size());
+		for (std::size_t i = 0; i < m_systems.size(); ++i)
+			orderedSystems[i] = i;
+
+		// Systems with the same update order keep their registration order
+		std::stable_sort(orderedSystems.begin(), orderedSystems.end(), [&](std::size_t lhs, std::size_t rhs)
+		{
+			return m_systems[lhs].system->GetUpdateOrder() < m_systems[rhs].system->GetUpdateOrder();
+		});
+
+		// Each system joins the last stage unless it conflicts with one of its systems, this keeps the order between conflicting systems
+		m_stages.clear();
+
+		std::vector<const SystemAccess*> stageAccesses;
+		for (std::size_t systemIndex : orderedSystems)
+		{
+			const ScheduledSystem& scheduledSystem = m_systems[systemIndex];
+
+			bool conflicts = std::any_of(stageAccesses.begin(), stageAccesses.end(), [&](const SystemAccess* access)
+			{
+				return access->ConflictsWith(scheduledSystem.access);
+			});
+
+			if (m_stages.empty() || conflicts)
+			{
+				m_stages.emplace_back();
+				stageAccesses.clear();
+			}
+
+			m_stages.back().systems.push_back(systemIndex);
+			stageAccesses.push_back(&scheduledSystem.access);
+		}
+
+		m_stagesUpdated = true;
+	}
+
+	void SystemScheduler::UpdateSystem(std::size_t systemIndex, float elapsedTime)
+	{
+		ScheduledSystem& scheduledSystem = m_systems[systemIndex];
+
+		// Arena::GetCommandBuffer returns this buffer while the system is running, on whichever thread runs it
+		EntityCommandBuffer::Binding commandBufferBinding(scheduledSystem.commandBuffer);
+		scheduledSystem.system->Update(elapsedTime);
+	}
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_SYSTEMSCHEDULER_HPP
+#define EREWHON_SERVER_SYSTEMSCHEDULER_HPP
+
+#include <NDK/BaseSystem.hpp>
+#include <Server/EntityCommandBuffer.hpp>
+#include <Server/SystemAccess.hpp>
+#include <vector>
+
+namespace Ndk
+{
+	class World;
+}
+
+namespace ewn
+{
+	class Arena;
+	class TaskPool;
+
+	// Replaces Ndk::World::Update: systems are grouped in stages of systems with non-conflicting accesses, each stage is run in parallel on the task pool
+	// Stages follow the systems update order, a system only starts once every conflicting system before it is done
+	// Each system records its structural changes and forces in its own command buffer, played back in stage order once its stage is done (the end of a stage is a sync point)
+	class SystemScheduler
+	{
+		public:
+			SystemScheduler(Arena& arena, Ndk::World& world, TaskPool& taskPool);
+			SystemScheduler(const SystemScheduler&) = delete;
+			SystemScheduler(SystemScheduler&&) = delete;
+			~SystemScheduler() = default;
+
+			template<typename T> void AddSystem();
+			template<typename T> void AddSystem(const SystemAccess& access);
+
+			inline std::size_t GetStageCount() const;
+
+			void Update(float elapsedTime);
+
+			SystemScheduler& operator=(const SystemScheduler&) = delete;
+			SystemScheduler& operator=(SystemScheduler&&) = delete;
+
+		private:
+			void AddSystem(Ndk::BaseSystem& system, const SystemAccess& access);
+			void BuildStages();
+
+			void UpdateSystem(std::size_t systemIndex, float elapsedTime);
+
+			struct ScheduledSystem
+			{
+				Ndk::BaseSystem* system;
+				EntityCommandBuffer commandBuffer;
+				SystemAccess access;
+			};
+
+			struct Stage
+			{
+				std::vector<std::size_t> systems; //< Indexes in m_systems, in update order
+			};
+
+			std::vector<ScheduledSystem> m_systems; //< In registration order
+			std::vector<Stage> m_stages;
+			Arena& m_arena;
+			Ndk::World& m_world;
+			TaskPool& m_taskPool;
+			bool m_stagesUpdated;
+	};
+}
+
+#include <Server/SystemScheduler.inl>
+
+#endif // EREWHON_SERVER_SYSTEMSCHEDULER_HPP
@@ -0,0 +1,31 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/SystemScheduler.hpp>
+#include <NDK/World.hpp>
+
+namespace ewn
+{
+	// Erewhon systems declare their own accesses
+	template<typename T>
+	void SystemScheduler::AddSystem()
+	{
+		SystemAccess access;
+		T::DeclareAccess(access);
+
+		AddSystem(m_world.GetSystem<T>(), access);
+	}
+
+	// For systems we don't own (such as the NDK physics system)
+	template<typename T>
+	void SystemScheduler::AddSystem(const SystemAccess& access)
+	{
+		AddSystem(m_world.GetSystem<T>(), access);
+	}
+
+	inline std::size_t SystemScheduler::GetStageCount() const
+	{
+		return m_stages.size();
+	}
+}
@@ -9,17 +9,21 @@
 #include <NDK/Components/CollisionComponent3D.hpp>
 #include <NDK/Components/NodeComponent.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Server/Arena.hpp>
 #include <Server/ServerApplication.hpp>
+#include <Server/SystemAccess.hpp>
 #include <Server/Systems/SpaceshipSystem.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
 #include <cassert>
 
 namespace ewn
 {
-	BroadcastSystem::BroadcastSystem() :
-	m_snapshotId(0)
+	BroadcastSystem::BroadcastSystem(Arena* arena) :
+	m_snapshotId(0),
+	m_tickInterval(2),
+	m_arena(arena)
 	{
 		Requires<Ndk::NodeComponent, SynchronizedComponent>();
-		SetMaximumUpdateRate(30.f);
 		SetUpdateOrder(100);
 	}
 
@@ -54,7 +58,11 @@ namespace ewn
 
 	void BroadcastSystem::OnUpdate(float /*elapsedTime*/)
 	{
-		static constexpr std::size_t HeaderSize = sizeof(Nz::UInt16) + 2 * sizeof(Nz::UInt64) + sizeof(Nz::UInt32);
+		// States are only broadcast every few ticks (the world is updated once per tick)
+		if (m_arena->GetCurrentTick() % m_tickInterval != 0)
+			return;
+
+		static constexpr std::size_t HeaderSize = sizeof(Nz::UInt16) + 3 * sizeof(Nz::UInt64) + sizeof(Nz::UInt32);
 		static constexpr std::size_t EntitySize = sizeof(Packets::ArenaState::Entity);
 		static constexpr std::size_t EntityMaxSize = 1300;
 		static constexpr std::size_t MaxEntityPerUpdate = EntityMaxSize / EntitySize;
@@ -87,7 +95,10 @@ namespace ewn
 
 		// Fill our packet with at most MaxEntityPerUpdate entities, by priority order
 		m_arenaStatePacket.stateId = m_snapshotId++;
-		m_arenaStatePacket.serverTime = ServerApplication::GetAppTime();
+		m_arenaStatePacket.serverTick = m_arena->GetCurrentTick();
+		m_arenaStatePacket.serverTime = m_arena->GetCurrentTime();
+
+		const TransformSnapshotSystem& transforms = GetWorld().GetSystem<TransformSnapshotSystem>();
 
 		std::size_t counter = 0;
 
@@ -97,17 +108,18 @@ namespace ewn
 			if (++counter > MaxEntityPerUpdate)
 				break;
 
-			auto& entityPhys = priority.entity->GetComponent<Ndk::PhysicsComponent3D>();
 			auto& entitySync = priority.entity->GetComponent<SynchronizedComponent>();
 
 			entitySync.ResetPriorityAccumulator();
 
+			Ndk::EntityId entityId = priority.entity->GetId();
+
 			Packets::ArenaState::Entity entityData;
-			entityData.id = priority.entity->GetId();
-			entityData.angularVelocity = entityPhys.GetAngularVelocity();
-			entityData.linearVelocity = entityPhys.GetLinearVelocity();
-			entityData.position = entityPhys.GetPosition();
-			entityData.rotation = entityPhys.GetRotation();
+			entityData.id = entityId;
+			entityData.angularVelocity = transforms.GetAngularVelocity(entityId);
+			entityData.linearVelocity = transforms.GetLinearVelocity(entityId);
+			entityData.position = transforms.GetPosition(entityId);
+			entityData.rotation = transforms.GetRotation(entityId);
 
 			m_arenaStatePacket.entities.emplace_back(std::move(entityData));
 		}
@@ -149,5 +161,13 @@ namespace ewn
 		}
 	}
 
+	void BroadcastSystem::DeclareAccess(SystemAccess& access)
+	{
+		// Sent packets go through the arena
+		access.Read(SharedResource::TransformSnapshot);
+		access.Write<SynchronizedComponent>();
+		access.Write(SharedResource::ArenaState);
+	}
+
 	Ndk::SystemIndex BroadcastSystem::systemIndex;
 }
@@ -13,21 +13,27 @@
 
 namespace ewn
 {
+	class Arena;
 	class ServerApplication;
+	class SystemAccess;
 
 	class BroadcastSystem : public Ndk::System<BroadcastSystem>
 	{
 		public:
-			BroadcastSystem();
+			BroadcastSystem(Arena* arena);
 			~BroadcastSystem() = default;
 
 			void BuildCreateEntity(Ndk::Entity* entity, Packets::CreateEntity& createPacket);
 			void CreateAllEntities(std::vector<Packets::CreateEntity>& packetVector);
 
+			inline void SetTickInterval(Nz::UInt64 tickInterval);
+
 			NazaraSignal(BroadcastEntityCreation, const BroadcastSystem*, const Packets::CreateEntity& /*packet*/);
 			NazaraSignal(BroadcastEntityDestruction, const BroadcastSystem*, const Packets::DeleteEntity& /*packet*/);
 			NazaraSignal(BroadcastStateUpdate, const BroadcastSystem*, Packets::ArenaState& /*statePacket*/);
 
+			static void DeclareAccess(SystemAccess& access);
+
 			static Ndk::SystemIndex systemIndex;
 
 		private:
@@ -37,7 +43,9 @@ namespace ewn
 
 			Ndk::EntityList m_movingEntities;
 			Nz::UInt16 m_snapshotId;
+			Nz::UInt64 m_tickInterval;
 			Packets::ArenaState m_arenaStatePacket;
+			Arena* m_arena;
 			ServerApplication* m_app;
 			float m_stateUpdateAccumulator;
 			float m_stateUpdateFrequency;
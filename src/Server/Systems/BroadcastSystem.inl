@@ -4,6 +4,13 @@
 
 #include <Server/Systems/BroadcastSystem.hpp>
 
+#include <cassert>
+
 namespace ewn
 {
+	inline void BroadcastSystem::SetTickInterval(Nz::UInt64 tickInterval)
+	{
+		assert(tickInterval > 0);
+		m_tickInterval = tickInterval;
+	}
 }
@@ -3,24 +3,54 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/Systems/LifeTimeSystem.hpp>
+#include <Server/Arena.hpp>
 #include <Server/Components/LifeTimeComponent.hpp>
+#include <Server/SystemAccess.hpp>
 
 namespace ewn
 {
-	LifeTimeSystem::LifeTimeSystem()
+	LifeTimeSystem::LifeTimeSystem(Arena* arena) :
+	m_arena(arena)
 	{
 		Requires<LifeTimeComponent>();
 	}
 
-	void LifeTimeSystem::OnUpdate(float elapsedTime)
+	void LifeTimeSystem::OnEntityAdded(Ndk::Entity* entity)
 	{
-		for (const Ndk::EntityHandle& entity : GetEntities())
+		LifeTimeComponent& lifeTime = entity->GetComponent<LifeTimeComponent>();
+
+		// Expiration is fixed the first time the entity enters the system, re-enabling an entity doesn't extend its lifetime
+		if (!lifeTime.GetExpirationTick())
+			lifeTime.SetExpirationTick(m_arena->GetTickAt(m_arena->GetCurrentTime() + static_cast<Nz::UInt64>(lifeTime.GetDuration() * 1'000.f)));
+
+		TimerWheel::TimerId timerId = m_arena->GetTimerWheel().Schedule(*lifeTime.GetExpirationTick(), [arena = m_arena, entity = Ndk::EntityHandle(entity)]()
 		{
-			LifeTimeComponent& lifeTime = entity->GetComponent<LifeTimeComponent>();
+			if (entity)
+				arena->GetCommandBuffer().Destroy(entity);
+		});
+
+		m_expirationTimers[entity->GetId()] = timerId;
+	}
+
+	void LifeTimeSystem::OnEntityRemoved(Ndk::Entity* entity)
+	{
+		auto it = m_expirationTimers.find(entity->GetId());
+		if (it == m_expirationTimers.end())
+			return;
 
-			if (lifeTime.DecreaseDuration(elapsedTime))
-				entity->Kill();
-		}
+		m_arena->GetTimerWheel().Cancel(it->second);
+		m_expirationTimers.erase(it);
+	}
+
+	void LifeTimeSystem::OnUpdate(float /*elapsedTime*/)
+	{
+		// Nothing to do each tick, expired entities are killed by their timer
+	}
+
+	void LifeTimeSystem::DeclareAccess(SystemAccess& access)
+	{
+		// Timers are scheduled when entities are added, during the world refresh
+		access.Read<LifeTimeComponent>();
 	}
 
 	Ndk::SystemIndex LifeTimeSystem::systemIndex;
@@ -8,19 +8,32 @@
 #define EREWHON_SERVER_LIFETIMESYSTEM_HPP
 
 #include <NDK/System.hpp>
+#include <Server/TimerWheel.hpp>
+#include <unordered_map>
 
 namespace ewn
 {
+	class Arena;
+	class SystemAccess;
+
+	// Entities are not updated each tick, each of them registers a kill timer with the arena timer wheel
 	class LifeTimeSystem : public Ndk::System<LifeTimeSystem>
 	{
 		public:
-			LifeTimeSystem();
+			LifeTimeSystem(Arena* arena);
 			~LifeTimeSystem() = default;
 
+			static void DeclareAccess(SystemAccess& access);
+
 			static Ndk::SystemIndex systemIndex;
 
 		private:
+			void OnEntityAdded(Ndk::Entity* entity) override;
+			void OnEntityRemoved(Ndk::Entity* entity) override;
 			void OnUpdate(float elapsedTime) override;
+
+			std::unordered_map<Ndk::EntityId, TimerWheel::TimerId> m_expirationTimers;
+			Arena* m_arena;
 	};
 }
 
@@ -5,43 +5,199 @@
 #include <Server/Systems/NavigationSystem.hpp>
 #include <NDK/Components/NodeComponent.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
-#include <Server/Components/InputComponent.hpp>
+#include <Server/Arena.hpp>
 #include <Server/Components/NavigationComponent.hpp>
 #include <Server/Components/PlayerControlledComponent.hpp>
-#include <Server/ServerApplication.hpp>
+#include <Server/Components/ScriptComponent.hpp>
+#include <Server/SystemAccess.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <algorithm>
 
 namespace ewn
 {
-	NavigationSystem::NavigationSystem() :
-	m_timeAccumulator(0.f)
+	NavigationSystem::NavigationSystem(Arena* arena) :
+	m_arena(arena)
 	{
-		Requires<InputComponent, NavigationComponent, Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
+		Requires<NavigationComponent, Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
 		Excludes<PlayerControlledComponent>();
-		SetFixedUpdateRate(30.f);
+	}
+
+	void NavigationSystem::OnEntityAdded(Ndk::Entity* entity)
+	{
+		Ndk::EntityId entityId = entity->GetId();
+		if (entityId >= m_slotByEntityId.size())
+			m_slotByEntityId.resize(entityId + 1, InvalidSlot);
+
+		m_slotByEntityId[entityId] = m_entities.size();
+		m_entities.push_back(entity);
+
+		AddSlot(m_headingErrors);
+		AddSlot(m_headingIntegrals);
+		AddSlot(m_headingLastErrors);
+		AddSlot(m_thrusts);
+		AddSlot(m_torques);
+		m_closeEnough.push_back(false);
+		m_targetMasks.push_back(0.f);
+	}
+
+	void NavigationSystem::OnEntityRemoved(Ndk::Entity* entity)
+	{
+		std::size_t slot = m_slotByEntityId[entity->GetId()];
+		m_slotByEntityId[entity->GetId()] = InvalidSlot;
+
+		// Swap with the last slot
+		std::size_t lastSlot = m_entities.size() - 1;
+		if (slot != lastSlot)
+			m_slotByEntityId[m_entities[lastSlot]->GetId()] = slot;
+
+		m_entities[slot] = m_entities[lastSlot];
+		m_entities.pop_back();
+
+		RemoveSlot(m_headingErrors, slot);
+		RemoveSlot(m_headingIntegrals, slot);
+		RemoveSlot(m_headingLastErrors, slot);
+		RemoveSlot(m_thrusts, slot);
+		RemoveSlot(m_torques, slot);
+
+		m_closeEnough[slot] = m_closeEnough[lastSlot];
+		m_closeEnough.pop_back();
 
-		m_appTime = ServerApplication::GetAppTime();
+		m_targetMasks[slot] = m_targetMasks[lastSlot];
+		m_targetMasks.pop_back();
 	}
 
-	void NavigationSystem::OnUpdate(float elapsedTime)
+	void NavigationSystem::OnUpdate(float /*elapsedTime*/)
 	{
-		// Handle app time via elapsed time, to handle fixed update rate
-		m_timeAccumulator += elapsedTime;
-		float elapsedMs = std::floor(m_timeAccumulator * 1'000);
-		m_timeAccumulator -= elapsedMs / 1'000;
+		// Navigation runs at half the arena tick rate
+		constexpr Nz::UInt64 TickInterval = 2;
 
-		m_appTime += static_cast<Nz::UInt64>(elapsedMs);
+		Nz::UInt64 currentTick = m_arena->GetCurrentTick();
+		if (currentTick % TickInterval != 0)
+			return;
 
-		for (const Ndk::EntityHandle& entity : GetEntities())
+		constexpr float elapsedTime = TickInterval * Arena::TickDuration;
+
+		// Same scale as player inputs (see InputComponent::PushInput and SpaceshipSystem), applied for the whole navigation interval
+		constexpr float ThrustForce = 50.f * 15'000.f * elapsedTime;
+		constexpr float TorqueForce = 200.f * 3'000.f * elapsedTime;
+
+		std::size_t shipCount = m_entities.size();
+
+		const TransformSnapshotSystem& transforms = GetWorld().GetSystem<TransformSnapshotSystem>();
+
+		// Ships are steered independently, gather heading errors and run their controllers in parallel (this is the only pass touching components before forces are applied)
+		m_arena->GetTaskPool().ForEachChunk(shipCount, UpdateChunkSize, [&](std::size_t first, std::size_t last)
 		{
-			Ndk::NodeComponent& entityNode = entity->GetComponent<Ndk::NodeComponent>();
-			Ndk::PhysicsComponent3D& entityPhys = entity->GetComponent<Ndk::PhysicsComponent3D>();
-			InputComponent& entityInput = entity->GetComponent<InputComponent>();
-			NavigationComponent& entityNavigation = entity->GetComponent<NavigationComponent>();
+			for (std::size_t i = first; i < last; ++i)
+			{
+				Ndk::Entity* entity = m_entities[i];
+				NavigationComponent& entityNavigation = entity->GetComponent<NavigationComponent>();
+
+				Nz::Vector3f thrust = entityNavigation.GetImpulseThrust();
+				Nz::Vector3f headingError = Nz::Vector3f::Zero();
+				bool hasTarget = false;
+				bool isCloseEnough = false;
+
+				Nz::Vector3f targetPos;
+				if (entityNavigation.GetTargetPosition(&targetPos))
+				{
+					Nz::Vector3f desiredHeading = targetPos - transforms.GetPosition(entity->GetId());
+
+					float triggerDistance = entityNavigation.GetTriggerDistance();
+					isCloseEnough = (desiredHeading.GetSquaredLength() <= triggerDistance * triggerDistance);
+
+					desiredHeading.Normalize();
+
+					Nz::Vector3f currentHeading = transforms.GetRotation(entity->GetId()) * Nz::Vector3f::Forward();
+					headingError = currentHeading.CrossProduct(desiredHeading);
+
+					if (currentHeading.DotProduct(desiredHeading) > 0.95f)
+						thrust += Nz::Vector3f::Forward();
+
+					hasTarget = true;
+				}
 
-			auto [thrust, rotation, isCloseEnough] = entityNavigation.Run(m_appTime, elapsedTime, entityNode.GetPosition(), entityNode.GetRotation(), entityPhys.GetLinearVelocity(), entityPhys.GetAngularVelocity());
+				m_headingErrors.x[i] = headingError.x;
+				m_headingErrors.y[i] = headingError.y;
+				m_headingErrors.z[i] = headingError.z;
+				m_thrusts.x[i] = thrust.x;
+				m_thrusts.y[i] = thrust.y;
+				m_thrusts.z[i] = thrust.z;
+				m_closeEnough[i] = isCloseEnough;
+				m_targetMasks[i] = (hasTarget) ? 1.f : 0.f;
+			}
 
-			entityInput.PushInput(m_appTime, thrust, rotation);
+			UpdateControllers(first, last, elapsedTime);
+		});
+
+		// Forces are applied (and parked ships woken up) once the navigation stage is done
+		EntityCommandBuffer& commandBuffer = m_arena->GetCommandBuffer();
+
+		for (std::size_t i = 0; i < shipCount; ++i)
+		{
+			Nz::Vector3f thrust(m_thrusts.x[i], m_thrusts.y[i], m_thrusts.z[i]);
+			Nz::Vector3f torque(m_torques.x[i], m_torques.y[i], m_torques.z[i]);
+
+			// Idle ships are left alone, applying a force (even a null one) would prevent them from sleeping
+			if (thrust == Nz::Vector3f::Zero() && torque == Nz::Vector3f::Zero())
+				continue;
+
+			Ndk::Entity* entity = m_entities[i];
+			commandBuffer.AddForce(entity, ThrustForce * thrust, Nz::CoordSys_Local);
+			commandBuffer.AddTorque(entity, TorqueForce * torque, Nz::CoordSys_Global);
 		}
+
+		// Proximity callbacks may do anything (including changing the target), only run them once every ship is handled
+		for (std::size_t i = 0; i < shipCount; ++i)
+		{
+			if (m_closeEnough[i])
+				m_entities[i]->GetComponent<NavigationComponent>().TriggerProximityCallback();
+		}
+	}
+
+	void NavigationSystem::UpdateControllers(std::size_t first, std::size_t last, float elapsedTime)
+	{
+		// Branchless loops over plain float arrays, so the compiler can vectorize them
+		const float invElapsedTime = 1.f / elapsedTime;
+		const float* targetMasks = m_targetMasks.data();
+
+		auto UpdateAxis = [&](const std::vector<float>& errorArray, std::vector<float>& integralArray, std::vector<float>& lastErrorArray, std::vector<float>& thrustArray, std::vector<float>& torqueArray)
+		{
+			const float* errors = errorArray.data();
+			float* integrals = integralArray.data();
+			float* lastErrors = lastErrorArray.data();
+			float* thrusts = thrustArray.data();
+			float* torques = torqueArray.data();
+
+			for (std::size_t i = first; i < last; ++i)
+			{
+				// Heading controllers of ships without target are left untouched
+				float mask = targetMasks[i];
+
+				float error = errors[i];
+				float derivative = (error - lastErrors[i]) * invElapsedTime;
+
+				integrals[i] += mask * error * elapsedTime;
+				lastErrors[i] += mask * (error - lastErrors[i]);
+
+				float torque = mask * (error * HeadingProportionalGain + integrals[i] * HeadingIntegralGain + derivative * HeadingDerivativeGain);
+
+				torques[i] = std::min(std::max(torque, -1.f), 1.f);
+				thrusts[i] = std::min(std::max(thrusts[i], -1.f), 1.f);
+			}
+		};
+
+		UpdateAxis(m_headingErrors.x, m_headingIntegrals.x, m_headingLastErrors.x, m_thrusts.x, m_torques.x);
+		UpdateAxis(m_headingErrors.y, m_headingIntegrals.y, m_headingLastErrors.y, m_thrusts.y, m_torques.y);
+		UpdateAxis(m_headingErrors.z, m_headingIntegrals.z, m_headingLastErrors.z, m_thrusts.z, m_torques.z);
+	}
+
+	void NavigationSystem::DeclareAccess(SystemAccess& access)
+	{
+		// Proximity callbacks are queued to the spaceship script, forces go through the command buffer
+		access.Read(SharedResource::TransformSnapshot);
+		access.Write<NavigationComponent, ScriptComponent>();
+		access.WriteDeferred<Ndk::PhysicsComponent3D>();
 	}
 
 	Ndk::SystemIndex NavigationSystem::systemIndex;
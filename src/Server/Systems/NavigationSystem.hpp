@@ -7,24 +7,63 @@
 #ifndef EREWHON_SERVER_NAVIGATIONSYSTEM_HPP
 #define EREWHON_SERVER_NAVIGATIONSYSTEM_HPP
 
+#include <Nazara/Prerequisites.hpp>
 #include <NDK/System.hpp>
+#include <limits>
+#include <vector>
 
 namespace ewn
 {
-	class ServerApplication;
+	class Arena;
+	class SystemAccess;
 
+	// Steers every script-controlled ship at once, navigation state is stored as arrays of floats (one per axis) so batches vectorize
 	class NavigationSystem : public Ndk::System<NavigationSystem>
 	{
 		public:
-			NavigationSystem();
+			NavigationSystem(Arena* arena);
+
+			static constexpr float HeadingDerivativeGain = 0.6382979f;
+			static constexpr float HeadingIntegralGain = 0.f;
+			static constexpr float HeadingProportionalGain = 1.f;
+
+			static void DeclareAccess(SystemAccess& access);
 
 			static Ndk::SystemIndex systemIndex;
 
 		private:
+			struct FloatArray3;
+
+			inline void AddSlot(FloatArray3& array);
+			inline void RemoveSlot(FloatArray3& array, std::size_t slot);
+
+			void OnEntityAdded(Ndk::Entity* entity) override;
+			void OnEntityRemoved(Ndk::Entity* entity) override;
 			void OnUpdate(float elapsedTime) override;
 
-			Nz::UInt64 m_appTime;
-			float m_timeAccumulator;
+			void UpdateControllers(std::size_t first, std::size_t last, float elapsedTime);
+
+			static constexpr std::size_t InvalidSlot = std::numeric_limits<std::size_t>::max();
+			static constexpr std::size_t UpdateChunkSize = 64; //< Ships steered per task
+
+			struct FloatArray3
+			{
+				std::vector<float> x;
+				std::vector<float> y;
+				std::vector<float> z;
+			};
+
+			// Per-ship state, indexed by slot
+			FloatArray3 m_headingErrors;
+			FloatArray3 m_headingIntegrals;
+			FloatArray3 m_headingLastErrors;
+			FloatArray3 m_thrusts;
+			FloatArray3 m_torques;
+			std::vector<Ndk::Entity*> m_entities;
+			std::vector<float> m_targetMasks; //< 1 if the ship has a target (its heading controller runs), 0 otherwise
+			std::vector<Nz::UInt8> m_closeEnough; //< Not a std::vector<bool>, chunks write it concurrently
+			std::vector<std::size_t> m_slotByEntityId;
+			Arena* m_arena;
 	};
 }
 
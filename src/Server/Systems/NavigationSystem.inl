@@ -6,4 +6,21 @@
 
 namespace ewn
 {
+	inline void NavigationSystem::AddSlot(FloatArray3& array)
+	{
+		array.x.push_back(0.f);
+		array.y.push_back(0.f);
+		array.z.push_back(0.f);
+	}
+
+	inline void NavigationSystem::RemoveSlot(FloatArray3& array, std::size_t slot)
+	{
+		array.x[slot] = array.x.back();
+		array.y[slot] = array.y.back();
+		array.z[slot] = array.z.back();
+
+		array.x.pop_back();
+		array.y.pop_back();
+		array.z.pop_back();
+	}
 }
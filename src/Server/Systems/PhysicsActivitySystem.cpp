@@ -0,0 +1,194 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/PhysicsActivitySystem.hpp>
+#include <NDK/World.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Server/Arena.hpp>
+#include <Server/Components/NavigationComponent.hpp>
+#include <Server/Components/PlayerControlledComponent.hpp>
+#include <Server/SystemAccess.hpp>
+#include <Server/Systems/SpatialIndexSystem.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <cassert>
+#include <cmath>
+
+namespace ewn
+{
+	PhysicsActivitySystem::PhysicsActivitySystem(Arena* arena) :
+	m_parkedBodyCount(0),
+	m_arena(arena)
+	{
+		Requires<Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
+
+		// After the spatial index is built, before the physics step
+		SetUpdateOrder(-90);
+	}
+
+	// Has to be called before applying a force to a body, as parked bodies ignore forces
+	void PhysicsActivitySystem::WakeUp(Ndk::Entity* entity)
+	{
+		if (!HasEntity(entity))
+			return;
+
+		BodyState& state = m_bodyStates[entity->GetId()];
+		state.lastObservedTick = m_arena->GetCurrentTick(); //< Keep it simulated for a while
+
+		if (!state.isParked)
+			return;
+
+		// Setting a velocity also wakes the body up
+		auto& physComponent = entity->GetComponent<Ndk::PhysicsComponent3D>();
+		physComponent.SetAngularVelocity(physComponent.GetAngularVelocity() + state.stashedAngularVelocity);
+		physComponent.SetLinearVelocity(physComponent.GetLinearVelocity() + state.stashedLinearVelocity);
+
+		state.isParked = false;
+		m_parkedBodyCount--;
+	}
+
+	bool PhysicsActivitySystem::CanPark(Ndk::Entity* entity) const
+	{
+		if (entity->HasComponent<PlayerControlledComponent>())
+			return false;
+
+		if (!entity->GetComponent<Ndk::PhysicsComponent3D>().IsMoveable())
+			return false;
+
+		// Ships following orders keep being simulated, only idle ones are parked
+		if (entity->HasComponent<NavigationComponent>())
+		{
+			auto& navigation = entity->GetComponent<NavigationComponent>();
+
+			Nz::Vector3f targetPosition;
+			if (navigation.GetTargetPosition(&targetPosition) || navigation.GetImpulseThrust() != Nz::Vector3f::Zero())
+				return false;
+		}
+
+		return true;
+	}
+
+	void PhysicsActivitySystem::Park(Ndk::Entity* entity)
+	{
+		BodyState& state = m_bodyStates[entity->GetId()];
+		assert(!state.isParked);
+
+		// A body without any velocity is put to sleep by the physics engine after a few steps, and costs nothing from there
+		auto& physComponent = entity->GetComponent<Ndk::PhysicsComponent3D>();
+		state.stashedAngularVelocity = physComponent.GetAngularVelocity();
+		state.stashedLinearVelocity = physComponent.GetLinearVelocity();
+
+		physComponent.SetAngularVelocity(Nz::Vector3f::Zero());
+		physComponent.SetLinearVelocity(Nz::Vector3f::Zero());
+
+		state.isParked = true;
+		m_parkedBodyCount++;
+	}
+
+	// Moves a parked body along its stashed velocity (rotation is not integrated, it is resumed on wake up)
+	void PhysicsActivitySystem::StepParked(Ndk::Entity* entity, float elapsedTime)
+	{
+		constexpr float RestingSpeed = 0.1f;
+
+		BodyState& state = m_bodyStates[entity->GetId()];
+		if (state.stashedLinearVelocity.GetSquaredLength() < RestingSpeed * RestingSpeed)
+			return;
+
+		auto& physComponent = entity->GetComponent<Ndk::PhysicsComponent3D>();
+		Nz::Vector3f position = physComponent.GetPosition() + state.stashedLinearVelocity * elapsedTime;
+
+		// Approximation of the physics engine damping
+		state.stashedLinearVelocity *= std::pow(1.f - physComponent.GetLinearDamping(), elapsedTime);
+
+		Nz::Vector3f angularDamping = physComponent.GetAngularDamping();
+		state.stashedAngularVelocity.x *= std::pow(1.f - angularDamping.x, elapsedTime);
+		state.stashedAngularVelocity.y *= std::pow(1.f - angularDamping.y, elapsedTime);
+		state.stashedAngularVelocity.z *= std::pow(1.f - angularDamping.z, elapsedTime);
+
+		physComponent.SetPosition(position);
+		entity->GetComponent<Ndk::NodeComponent>().SetPosition(position);
+	}
+
+	void PhysicsActivitySystem::OnEntityAdded(Ndk::Entity* entity)
+	{
+		Ndk::EntityId entityId = entity->GetId();
+		if (entityId >= m_bodyStates.size())
+			m_bodyStates.resize(entityId + 1);
+
+		BodyState& state = m_bodyStates[entityId];
+		state.stashedAngularVelocity = Nz::Vector3f::Zero();
+		state.stashedLinearVelocity = Nz::Vector3f::Zero();
+		state.lastObservedTick = m_arena->GetCurrentTick();
+		state.isParked = false;
+
+		// Resting bodies are put to sleep by the physics engine, even close to players
+		entity->GetComponent<Ndk::PhysicsComponent3D>().EnableAutoSleep(true);
+	}
+
+	void PhysicsActivitySystem::OnEntityRemoved(Ndk::Entity* entity)
+	{
+		BodyState& state = m_bodyStates[entity->GetId()];
+		if (state.isParked)
+		{
+			state.isParked = false;
+			m_parkedBodyCount--;
+		}
+	}
+
+	void PhysicsActivitySystem::OnUpdate(float /*elapsedTime*/)
+	{
+		Nz::UInt64 currentTick = m_arena->GetCurrentTick();
+		const TransformSnapshotSystem& transforms = GetWorld().GetSystem<TransformSnapshotSystem>();
+
+		// Players spaceships are the observers
+		m_observerPositions.clear();
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			if (entity->HasComponent<PlayerControlledComponent>() && entity->GetComponent<PlayerControlledComponent>().GetOwner())
+				m_observerPositions.push_back(transforms.GetPosition(entity->GetId()));
+		}
+
+		const SpatialGrid& spatialGrid = GetWorld().GetSystem<SpatialIndexSystem>().GetGrid();
+		for (const Nz::Vector3f& observerPosition : m_observerPositions)
+		{
+			spatialGrid.ForEachInSphere(observerPosition, ObservationRadius, [&](const SpatialGrid::Entry& entry)
+			{
+				assert(entry.entityId < m_bodyStates.size());
+				m_bodyStates[entry.entityId].lastObservedTick = currentTick;
+			});
+		}
+
+		constexpr float DisturbanceSquaredSpeed = DisturbanceSpeed * DisturbanceSpeed;
+		constexpr float ParkedStepDuration = ParkedStepInterval * Arena::TickDuration;
+
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			BodyState& state = m_bodyStates[entity->GetId()];
+			if (state.isParked)
+			{
+				// Parked bodies have no velocity of their own, if they have some it comes from a contact or a force (during the last physics step)
+				Ndk::EntityId entityId = entity->GetId();
+				bool isDisturbed = transforms.GetLinearVelocity(entityId).GetSquaredLength() > DisturbanceSquaredSpeed ||
+				                   transforms.GetAngularVelocity(entityId).GetSquaredLength() > DisturbanceSquaredSpeed;
+
+				if (isDisturbed || state.lastObservedTick == currentTick)
+					WakeUp(entity);
+				else if ((currentTick + entity->GetId()) % ParkedStepInterval == 0) //< Spread parked bodies steps over the interval
+					StepParked(entity, ParkedStepDuration);
+			}
+			else if (currentTick - state.lastObservedTick >= ParkDelay && CanPark(entity))
+				Park(entity);
+		}
+	}
+
+	void PhysicsActivitySystem::DeclareAccess(SystemAccess& access)
+	{
+		access.Read<NavigationComponent, PlayerControlledComponent>();
+		access.Read(SharedResource::SpatialGrid);
+		access.Read(SharedResource::TransformSnapshot);
+		access.Write<Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
+	}
+
+	Ndk::SystemIndex PhysicsActivitySystem::systemIndex;
+}
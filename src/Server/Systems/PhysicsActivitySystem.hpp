@@ -0,0 +1,67 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_PHYSICSACTIVITYSYSTEM_HPP
+#define EREWHON_SERVER_PHYSICSACTIVITYSYSTEM_HPP
+
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/System.hpp>
+#include <Shared/Config.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class Arena;
+	class SystemAccess;
+
+	// Physics level of detail: bodies no player has been close to for a while are parked (their velocity is stashed so the physics engine puts them to sleep)
+	// Parked bodies drift at a reduced rate and are woken up as soon as a player comes close, something hits them or a force is applied to them
+	class PhysicsActivitySystem : public Ndk::System<PhysicsActivitySystem>
+	{
+		public:
+			PhysicsActivitySystem(Arena* arena);
+			~PhysicsActivitySystem() = default;
+
+			inline std::size_t GetParkedBodyCount() const;
+
+			void WakeUp(Ndk::Entity* entity);
+
+			static constexpr float DisturbanceSpeed = 0.01f; //< A parked body moving faster than this was pushed by something
+			static constexpr float ObservationRadius = 1000.f;
+			static constexpr Nz::UInt64 ParkDelay = 3 * ServerTickRate; //< Ticks a body has to stay out of every player observation radius before being parked
+			static constexpr Nz::UInt64 ParkedStepInterval = ServerTickRate / 2; //< Parked bodies drift once per interval (in ticks)
+
+			static void DeclareAccess(SystemAccess& access);
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			bool CanPark(Ndk::Entity* entity) const;
+			void Park(Ndk::Entity* entity);
+			void StepParked(Ndk::Entity* entity, float elapsedTime);
+
+			void OnEntityAdded(Ndk::Entity* entity) override;
+			void OnEntityRemoved(Ndk::Entity* entity) override;
+			void OnUpdate(float elapsedTime) override;
+
+			struct BodyState
+			{
+				Nz::Vector3f stashedAngularVelocity;
+				Nz::Vector3f stashedLinearVelocity;
+				Nz::UInt64 lastObservedTick;
+				bool isParked;
+			};
+
+			std::vector<BodyState> m_bodyStates; //< Indexed by entity id
+			std::vector<Nz::Vector3f> m_observerPositions;
+			std::size_t m_parkedBodyCount;
+			Arena* m_arena;
+	};
+}
+
+#include <Server/Systems/PhysicsActivitySystem.inl>
+
+#endif // EREWHON_SERVER_PHYSICSACTIVITYSYSTEM_HPP
@@ -0,0 +1,13 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/PhysicsActivitySystem.hpp>
+
+namespace ewn
+{
+	inline std::size_t PhysicsActivitySystem::GetParkedBodyCount() const
+	{
+		return m_parkedBodyCount;
+	}
+}
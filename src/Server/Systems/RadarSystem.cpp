@@ -0,0 +1,183 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/RadarSystem.hpp>
+#include <NDK/World.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <Server/Arena.hpp>
+#include <Server/Components/RadarComponent.hpp>
+#include <Server/Components/SynchronizedComponent.hpp>
+#include <Server/SystemAccess.hpp>
+#include <Server/TaskPool.hpp>
+#include <Server/Systems/SpatialIndexSystem.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+
+namespace ewn
+{
+	RadarSystem::RadarSystem(Arena* arena) :
+	m_arena(arena)
+	{
+		Requires<RadarComponent, Ndk::NodeComponent>();
+
+		// After the spatial index is built, before scripts process radar events
+		SetUpdateOrder(-50);
+	}
+
+	// Makes radars act as if the entity was destroyed, for entities going away without being killed
+	void RadarSystem::ForgetEntity(Ndk::Entity* entity)
+	{
+		for (const Ndk::EntityHandle& radarEntity : GetEntities())
+		{
+			RadarComponent& radar = radarEntity->GetComponent<RadarComponent>();
+
+			if (radar.m_entitiesInRange.Has(entity))
+				radar.m_entitiesInRange.Remove(entity);
+
+			for (auto it = radar.m_lockedTargets.begin(); it != radar.m_lockedTargets.end(); ++it)
+			{
+				if (it->target.GetObject() == entity)
+				{
+					RadarComponent::Event& event = radar.m_events.emplace_back();
+					event.type = RadarComponent::EventType::ObjectDestroyed;
+					event.entityId = it->entityId;
+					event.position = it->lastPosition;
+
+					radar.m_lockedTargets.erase(it);
+					break;
+				}
+			}
+		}
+	}
+
+	void RadarSystem::OnUpdate(float /*elapsedTime*/)
+	{
+		Nz::UInt64 now = m_arena->GetCurrentTime();
+
+		// Gather every radar in contiguous arrays first, so the passes below don't jump between components
+		m_radarEntities.clear();
+		m_radarPositions.clear();
+		m_radarRanges.clear();
+		m_radarScanDue.clear();
+
+		const TransformSnapshotSystem& transforms = GetWorld().GetSystem<TransformSnapshotSystem>();
+
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			RadarComponent& radar = entity->GetComponent<RadarComponent>();
+
+			bool scanDue = radar.m_isPassiveScanEnabled && now - radar.m_lastPassiveScanTime > PassiveScanInterval;
+			if (scanDue)
+				radar.m_lastPassiveScanTime = now;
+
+			m_radarEntities.push_back(entity);
+			m_radarPositions.push_back(transforms.GetPosition(entity->GetId()));
+			m_radarRanges.push_back(radar.m_detectionRadius);
+			m_radarScanDue.push_back(scanDue);
+		}
+
+		// Passive scans, only pay for entities close to each radar
+		// Grid queries are read-only and run in parallel, each radar collecting new entities in its own list
+		const SpatialGrid& spatialGrid = GetWorld().GetSystem<SpatialIndexSystem>().GetGrid();
+		Ndk::World& world = GetWorld();
+
+		if (m_radarScanResults.size() < m_radarEntities.size())
+			m_radarScanResults.resize(m_radarEntities.size());
+
+		m_arena->GetTaskPool().ForEachChunk(m_radarEntities.size(), ScanChunkSize, [&](std::size_t first, std::size_t last)
+		{
+			for (std::size_t i = first; i < last; ++i)
+			{
+				std::vector<SpatialGrid::Entry>& scanResults = m_radarScanResults[i];
+				scanResults.clear();
+
+				if (!m_radarScanDue[i])
+					continue;
+
+				Ndk::Entity* radarEntity = m_radarEntities[i];
+				const RadarComponent& radar = radarEntity->GetComponent<RadarComponent>();
+
+				spatialGrid.ForEachInSphere(m_radarPositions[i], m_radarRanges[i], [&](const SpatialGrid::Entry& entry)
+				{
+					if (entry.entityId != radarEntity->GetId() && !radar.m_entitiesInRange.Has(entry.entityId))
+						scanResults.push_back(entry);
+				});
+			}
+		});
+
+		// Entity handles can't be created concurrently
+		for (std::size_t i = 0; i < m_radarEntities.size(); ++i)
+		{
+			if (m_radarScanResults[i].empty())
+				continue;
+
+			RadarComponent& radar = m_radarEntities[i]->GetComponent<RadarComponent>();
+			for (const SpatialGrid::Entry& entry : m_radarScanResults[i])
+			{
+				const Ndk::EntityHandle& entity = world.GetEntity(entry.entityId);
+				radar.m_entitiesInRange.Insert(entity);
+
+				RadarComponent::Event& event = radar.m_events.emplace_back();
+				event.type = RadarComponent::EventType::NewObjectInRange;
+				event.entityId = entry.entityId;
+				event.objectType = entity->GetComponent<SynchronizedComponent>().GetType();
+				event.position = entry.position;
+			}
+		}
+
+		// Locked targets range check
+		for (std::size_t i = 0; i < m_radarEntities.size(); ++i)
+		{
+			RadarComponent& radar = m_radarEntities[i]->GetComponent<RadarComponent>();
+			if (radar.m_lockedTargets.empty())
+				continue;
+
+			const Nz::Vector3f& radarPosition = m_radarPositions[i];
+			float squaredRange = m_radarRanges[i] * m_radarRanges[i];
+
+			for (auto it = radar.m_lockedTargets.begin(); it != radar.m_lockedTargets.end();)
+			{
+				RadarComponent::LockedTarget& lockedTarget = *it;
+
+				RadarComponent::Event event;
+				if (lockedTarget.target)
+				{
+					lockedTarget.lastPosition = transforms.GetPosition(lockedTarget.entityId);
+					if (lockedTarget.lastPosition.SquaredDistance(radarPosition) <= squaredRange)
+					{
+						++it;
+						continue;
+					}
+
+					event.type = RadarComponent::EventType::ObjectLeftRange;
+					event.entityId = lockedTarget.entityId;
+
+					radar.m_entitiesInRange.Remove(lockedTarget.target);
+				}
+				else
+				{
+					// Destroyed entities are already removed from the entity list
+					event.type = RadarComponent::EventType::ObjectDestroyed;
+					event.entityId = lockedTarget.entityId;
+				}
+
+				event.position = lockedTarget.lastPosition;
+				radar.m_events.emplace_back(std::move(event));
+
+				it = radar.m_lockedTargets.erase(it);
+			}
+		}
+	}
+
+	void RadarSystem::DeclareAccess(SystemAccess& access)
+	{
+		// Scans are spread over the task pool, entities in range are then stored (as handles) sequentially
+		access.Read<SynchronizedComponent>();
+		access.Read(SharedResource::SpatialGrid);
+		access.Read(SharedResource::TransformSnapshot);
+		access.Write<RadarComponent>();
+		access.Write(SharedResource::EntityHandles);
+	}
+
+	Ndk::SystemIndex RadarSystem::systemIndex;
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_RADARSYSTEM_HPP
+#define EREWHON_SERVER_RADARSYSTEM_HPP
+
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/System.hpp>
+#include <Server/SpatialGrid.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class Arena;
+	class SystemAccess;
+
+	class RadarSystem : public Ndk::System<RadarSystem>
+	{
+		public:
+			RadarSystem(Arena* arena);
+			~RadarSystem() = default;
+
+			void ForgetEntity(Ndk::Entity* entity);
+
+			static constexpr Nz::UInt64 PassiveScanInterval = 500; //< ms
+
+			static void DeclareAccess(SystemAccess& access);
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			void OnUpdate(float elapsedTime) override;
+
+			static constexpr std::size_t ScanChunkSize = 16; //< Radars scanned per task
+
+			std::vector<std::vector<SpatialGrid::Entry>> m_radarScanResults; //< Entities newly in range of each radar, kept between updates for their capacity
+			std::vector<Ndk::Entity*> m_radarEntities;
+			std::vector<Nz::Vector3f> m_radarPositions;
+			std::vector<float> m_radarRanges;
+			std::vector<bool> m_radarScanDue;
+			Arena* m_arena;
+	};
+}
+
+#include <Server/Systems/RadarSystem.inl>
+
+#endif // EREWHON_SERVER_RADARSYSTEM_HPP
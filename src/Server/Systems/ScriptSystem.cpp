@@ -7,6 +7,7 @@
 #include <Server/Components/OwnerComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
+#include <Server/SystemAccess.hpp>
 
 namespace ewn
 {
@@ -15,8 +16,6 @@ namespace ewn
 	m_app(app)
 	{
 		Requires<ScriptComponent>();
-
-		SetMaximumUpdateRate(100.f);
 	}
 
 	void ScriptSystem::OnUpdate(float elapsedTime)
@@ -31,5 +30,11 @@ namespace ewn
 		}
 	}
 
+	void ScriptSystem::DeclareAccess(SystemAccess& access)
+	{
+		// Scripts can do anything
+		access.MakeExclusive();
+	}
+
 	Ndk::SystemIndex ScriptSystem::systemIndex;
 }
@@ -13,6 +13,7 @@ namespace ewn
 {
 	class Arena;
 	class ServerApplication;
+	class SystemAccess;
 
 	class ScriptSystem : public Ndk::System<ScriptSystem>
 	{
@@ -20,6 +21,8 @@ namespace ewn
 			ScriptSystem(ServerApplication* app, Arena* arena);
 			~ScriptSystem() = default;
 
+			static void DeclareAccess(SystemAccess& access);
+
 			static Ndk::SystemIndex systemIndex;
 
 		private:
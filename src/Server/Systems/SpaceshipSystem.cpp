@@ -5,45 +5,87 @@
 #include <Server/Systems/SpaceshipSystem.hpp>
 #include <Nazara/Utility/Node.hpp>
 #include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Server/Arena.hpp>
 #include <Server/Components/InputComponent.hpp>
+#include <Server/SystemAccess.hpp>
 #include <iostream>
 
 namespace ewn
 {
-	SpaceshipSystem::SpaceshipSystem()
+	SpaceshipSystem::SpaceshipSystem(Arena* arena) :
+	m_arena(arena)
 	{
 		Requires<Ndk::PhysicsComponent3D, InputComponent>();
-		SetMaximumUpdateRate(60.f);
 	}
 
 	void SpaceshipSystem::OnUpdate(float /*elapsedTime*/)
 	{
+		Nz::UInt64 currentTick = m_arena->GetCurrentTick();
+
+		m_spaceships.clear();
 		for (const Ndk::EntityHandle& spaceship : GetEntities())
-		{
-			auto& spaceshipPhysics = spaceship->GetComponent<Ndk::PhysicsComponent3D>();
-			auto& spaceshipInput = spaceship->GetComponent<InputComponent>();
+			m_spaceships.push_back(spaceship);
 
-			Nz::UInt64 lastInput = spaceshipInput.GetLastInputTime();
-			spaceshipInput.ProcessInputs([&] (Nz::UInt64 time, const Nz::Vector3f& movement, const Nz::Vector3f& rotation)
+		std::size_t spaceshipCount = m_spaceships.size();
+		m_forces.resize(spaceshipCount);
+		m_torques.resize(spaceshipCount);
+		m_hasInputs.resize(spaceshipCount);
+
+		// Inputs only touch their own spaceship, sum them in parallel (chunk tasks have no command buffer bound)
+		m_arena->GetTaskPool().ForEachChunk(spaceshipCount, UpdateChunkSize, [&](std::size_t first, std::size_t last)
+		{
+			for (std::size_t i = first; i < last; ++i)
 			{
-				static constexpr float AngularMultiplier = 3000.f;
-				static constexpr float ForceMultiplier = 15000.f;
+				auto& spaceshipInput = m_spaceships[i]->GetComponent<InputComponent>();
+
+				Nz::Vector3f force = Nz::Vector3f::Zero();
+				Nz::Vector3f torque = Nz::Vector3f::Zero();
+				bool hasInputs = false;
+
+				Nz::UInt64 lastInput = spaceshipInput.GetLastInputTime();
+				spaceshipInput.ProcessInputs(currentTick, [&] (Nz::UInt64 time, const Nz::Vector3f& movement, const Nz::Vector3f& rotation)
+				{
+					static constexpr float AngularMultiplier = 3000.f;
+					static constexpr float ForceMultiplier = 15000.f;
+
+					float inputElapsedTime = (lastInput != 0) ? (time - lastInput) / 1000.f : 0.f;
 
-				float inputElapsedTime = (lastInput != 0) ? (time - lastInput) / 1000.f : 0.f;
+					Nz::Vector3f totalMovement = inputElapsedTime * movement;
+					Nz::Vector3f totalRotation = inputElapsedTime * rotation;
 
-				Nz::Vector3f totalMovement = inputElapsedTime * movement;
-				Nz::Vector3f totalRotation = inputElapsedTime * rotation;
+					// Every input of a tick is applied before the same physics step, summing them doesn't change the result
+					force += ForceMultiplier * totalMovement;
+					torque += AngularMultiplier * totalRotation;
+					hasInputs = true;
 
-				spaceshipPhysics.AddForce(ForceMultiplier * totalMovement, Nz::CoordSys_Local);
-				spaceshipPhysics.AddTorque(AngularMultiplier * totalRotation, Nz::CoordSys_Global);
+					lastInput = time;
+				});
 
-				/*std::cout << "At " << time << ": Move by " << totalMovement << " (final pos: " << spaceshipNode.GetPosition() << ")\n";
-				std::cout << "   " << time << ": Rotate by " << totalRotation << " (final pos: " << spaceshipNode.GetRotation().ToEulerAngles() << ')' << std::endl;*/
+				m_forces[i] = force;
+				m_torques[i] = torque;
+				m_hasInputs[i] = hasInputs;
+			}
+		});
 
-				lastInput = time;
-			});
+		// Forces are applied once the system stage is done
+		EntityCommandBuffer& commandBuffer = m_arena->GetCommandBuffer();
+
+		for (std::size_t i = 0; i < spaceshipCount; ++i)
+		{
+			if (!m_hasInputs[i])
+				continue;
+
+			commandBuffer.AddForce(m_spaceships[i], m_forces[i], Nz::CoordSys_Local);
+			commandBuffer.AddTorque(m_spaceships[i], m_torques[i], Nz::CoordSys_Global);
 		}
 	}
 
+	void SpaceshipSystem::DeclareAccess(SystemAccess& access)
+	{
+		// Forces go through the command buffer
+		access.Write<InputComponent>();
+		access.WriteDeferred<Ndk::PhysicsComponent3D>();
+	}
+
 	Ndk::SystemIndex SpaceshipSystem::systemIndex;
 }
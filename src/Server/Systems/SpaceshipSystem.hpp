@@ -7,19 +7,35 @@
 #ifndef EREWHON_SERVER_SPACESHIPSYSTEM_HPP
 #define EREWHON_SERVER_SPACESHIPSYSTEM_HPP
 
+#include <Nazara/Math/Vector3.hpp>
 #include <NDK/System.hpp>
+#include <vector>
 
 namespace ewn
 {
+	class Arena;
+	class SystemAccess;
+
 	class SpaceshipSystem : public Ndk::System<SpaceshipSystem>
 	{
 		public:
-			SpaceshipSystem();
+			SpaceshipSystem(Arena* arena);
+
+			static void DeclareAccess(SystemAccess& access);
 
 			static Ndk::SystemIndex systemIndex;
 
 		private:
 			void OnUpdate(float elapsedTime) override;
+
+			static constexpr std::size_t UpdateChunkSize = 64; //< Spaceships handled per task
+
+			// Per-spaceship results of the last update, kept between updates for their capacity
+			std::vector<Ndk::Entity*> m_spaceships;
+			std::vector<Nz::Vector3f> m_forces;
+			std::vector<Nz::Vector3f> m_torques;
+			std::vector<Nz::UInt8> m_hasInputs;
+			Arena* m_arena;
 	};
 }
 
@@ -0,0 +1,54 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/SpatialIndexSystem.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Server/Arena.hpp>
+#include <Server/SystemAccess.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+
+namespace ewn
+{
+	SpatialIndexSystem::SpatialIndexSystem(Arena* arena) :
+	m_grid(CellSize),
+	m_history(HistoryTickCount),
+	m_arena(arena)
+	{
+		Requires<Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
+
+		// Rebuild the grid before any other system runs (and after the world refresh), so it never references destroyed entities
+		SetUpdateOrder(-100);
+	}
+
+	void SpatialIndexSystem::OnUpdate(float /*elapsedTime*/)
+	{
+		const TransformSnapshotSystem& transforms = GetWorld().GetSystem<TransformSnapshotSystem>();
+
+		m_grid.Clear();
+		m_history.BeginFrame(m_arena->GetCurrentTick());
+
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			// Bounding radius is approximated from the body AABB, good enough for projectile hits
+			Ndk::EntityId entityId = entity->GetId();
+			const Nz::Vector3f& position = transforms.GetPosition(entityId);
+			float radius = transforms.GetBoundingRadius(entityId);
+
+			m_grid.Insert(entityId, position, radius);
+			m_history.Insert(entityId, position, radius);
+		}
+
+		m_grid.Build();
+		m_history.EndFrame();
+	}
+
+	void SpatialIndexSystem::DeclareAccess(SystemAccess& access)
+	{
+		access.Read(SharedResource::TransformSnapshot);
+		access.Write(SharedResource::SpatialGrid);
+	}
+
+	Ndk::SystemIndex SpatialIndexSystem::systemIndex;
+}
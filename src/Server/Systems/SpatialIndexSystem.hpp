@@ -0,0 +1,47 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_SPATIALINDEXSYSTEM_HPP
+#define EREWHON_SERVER_SPATIALINDEXSYSTEM_HPP
+
+#include <NDK/System.hpp>
+#include <Shared/Config.hpp>
+#include <Server/SpatialGrid.hpp>
+#include <Server/StateHistory.hpp>
+
+namespace ewn
+{
+	class Arena;
+	class SystemAccess;
+
+	class SpatialIndexSystem : public Ndk::System<SpatialIndexSystem>
+	{
+		public:
+			SpatialIndexSystem(Arena* arena);
+			~SpatialIndexSystem() = default;
+
+			inline const SpatialGrid& GetGrid() const;
+			inline const StateHistory& GetHistory() const;
+
+			static constexpr float CellSize = 100.f;
+			static constexpr std::size_t HistoryTickCount = ServerTickRate / 3; //< Positions are kept for a third of a second (lag compensation limit)
+
+			static void DeclareAccess(SystemAccess& access);
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			void OnUpdate(float elapsedTime) override;
+
+			SpatialGrid m_grid;
+			StateHistory m_history;
+			Arena* m_arena;
+	};
+}
+
+#include <Server/Systems/SpatialIndexSystem.inl>
+
+#endif // EREWHON_SERVER_SPATIALINDEXSYSTEM_HPP
@@ -0,0 +1,20 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/SpatialIndexSystem.hpp>
+
+namespace ewn
+{
+	// Positions as of the beginning of the current tick, entities created since then are missing
+	inline const SpatialGrid& SpatialIndexSystem::GetGrid() const
+	{
+		return m_grid;
+	}
+
+	// Grid positions of the last ticks, current one included
+	inline const StateHistory& SpatialIndexSystem::GetHistory() const
+	{
+		return m_history;
+	}
+}
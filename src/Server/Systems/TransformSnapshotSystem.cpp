@@ -0,0 +1,83 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <NDK/Components/PhysicsComponent3D.hpp>
+#include <Server/SystemAccess.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	TransformSnapshotSystem::TransformSnapshotSystem()
+	{
+		Requires<Ndk::NodeComponent>();
+
+		// After the physics step, before the broadcast
+		SetUpdateOrder(50);
+	}
+
+	void TransformSnapshotSystem::Capture(Ndk::Entity* entity)
+	{
+		Ndk::EntityId entityId = entity->GetId();
+		if (entityId >= m_positions.size())
+		{
+			m_angularVelocities.resize(entityId + 1);
+			m_boundingRadii.resize(entityId + 1);
+			m_linearVelocities.resize(entityId + 1);
+			m_positions.resize(entityId + 1);
+			m_rotations.resize(entityId + 1);
+		}
+
+		if (entity->HasComponent<Ndk::PhysicsComponent3D>())
+		{
+			auto& entityPhys = entity->GetComponent<Ndk::PhysicsComponent3D>();
+
+			Nz::Boxf aabb = entityPhys.GetAABB();
+
+			m_angularVelocities[entityId] = entityPhys.GetAngularVelocity();
+			m_boundingRadii[entityId] = std::max({ aabb.width, aabb.height, aabb.depth }) / 2.f;
+			m_linearVelocities[entityId] = entityPhys.GetLinearVelocity();
+			m_positions[entityId] = entityPhys.GetPosition();
+			m_rotations[entityId] = entityPhys.GetRotation();
+		}
+		else
+		{
+			auto& entityNode = entity->GetComponent<Ndk::NodeComponent>();
+
+			m_angularVelocities[entityId] = Nz::Vector3f::Zero();
+			m_boundingRadii[entityId] = 0.f;
+			m_linearVelocities[entityId] = Nz::Vector3f::Zero();
+			m_positions[entityId] = entityNode.GetPosition();
+			m_rotations[entityId] = entityNode.GetRotation();
+		}
+	}
+
+	void TransformSnapshotSystem::OnEntityAdded(Ndk::Entity* entity)
+	{
+		// New entities are readable right away, without waiting for the end of the tick
+		Capture(entity);
+
+		m_capturedEntities.UnboundedSet(entity->GetId());
+	}
+
+	void TransformSnapshotSystem::OnEntityRemoved(Ndk::Entity* entity)
+	{
+		m_capturedEntities.UnboundedReset(entity->GetId());
+	}
+
+	void TransformSnapshotSystem::OnUpdate(float /*elapsedTime*/)
+	{
+		for (const Ndk::EntityHandle& entity : GetEntities())
+			Capture(entity);
+	}
+
+	void TransformSnapshotSystem::DeclareAccess(SystemAccess& access)
+	{
+		access.Read<Ndk::NodeComponent, Ndk::PhysicsComponent3D>();
+		access.Write(SharedResource::TransformSnapshot);
+	}
+
+	Ndk::SystemIndex TransformSnapshotSystem::systemIndex;
+}
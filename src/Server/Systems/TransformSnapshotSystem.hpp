@@ -0,0 +1,58 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_TRANSFORMSNAPSHOTSYSTEM_HPP
+#define EREWHON_SERVER_TRANSFORMSNAPSHOTSYSTEM_HPP
+
+#include <Nazara/Core/Bitset.hpp>
+#include <Nazara/Math/Quaternion.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NDK/System.hpp>
+#include <vector>
+
+namespace ewn
+{
+	class SystemAccess;
+
+	// Copies every entity transform and velocities in dense arrays (indexed by entity id) once per tick, right after the physics step
+	// Systems and scripts read transforms from here instead of querying the physics engine for each entity again and again
+	class TransformSnapshotSystem : public Ndk::System<TransformSnapshotSystem>
+	{
+		public:
+			TransformSnapshotSystem();
+			~TransformSnapshotSystem() = default;
+
+			inline const Nz::Vector3f& GetAngularVelocity(Ndk::EntityId entityId) const;
+			inline float GetBoundingRadius(Ndk::EntityId entityId) const;
+			inline const Nz::Vector3f& GetLinearVelocity(Ndk::EntityId entityId) const;
+			inline const Nz::Vector3f& GetPosition(Ndk::EntityId entityId) const;
+			inline const Nz::Quaternionf& GetRotation(Ndk::EntityId entityId) const;
+
+			inline bool IsCaptured(Ndk::EntityId entityId) const;
+
+			static void DeclareAccess(SystemAccess& access);
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			void Capture(Ndk::Entity* entity);
+
+			void OnEntityAdded(Ndk::Entity* entity) override;
+			void OnEntityRemoved(Ndk::Entity* entity) override;
+			void OnUpdate(float elapsedTime) override;
+
+			Nz::Bitset<> m_capturedEntities;
+			std::vector<Nz::Quaternionf> m_rotations;
+			std::vector<Nz::Vector3f> m_angularVelocities;
+			std::vector<Nz::Vector3f> m_linearVelocities;
+			std::vector<Nz::Vector3f> m_positions;
+			std::vector<float> m_boundingRadii;
+	};
+}
+
+#include <Server/Systems/TransformSnapshotSystem.inl>
+
+#endif // EREWHON_SERVER_TRANSFORMSNAPSHOTSYSTEM_HPP
@@ -0,0 +1,46 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/Systems/TransformSnapshotSystem.hpp>
+#include <cassert>
+
+namespace ewn
+{
+	inline const Nz::Vector3f& TransformSnapshotSystem::GetAngularVelocity(Ndk::EntityId entityId) const
+	{
+		assert(IsCaptured(entityId));
+		return m_angularVelocities[entityId];
+	}
+
+	// Approximated from the physics body AABB, zero for entities without physics
+	inline float TransformSnapshotSystem::GetBoundingRadius(Ndk::EntityId entityId) const
+	{
+		assert(IsCaptured(entityId));
+		return m_boundingRadii[entityId];
+	}
+
+	inline const Nz::Vector3f& TransformSnapshotSystem::GetLinearVelocity(Ndk::EntityId entityId) const
+	{
+		assert(IsCaptured(entityId));
+		return m_linearVelocities[entityId];
+	}
+
+	inline const Nz::Vector3f& TransformSnapshotSystem::GetPosition(Ndk::EntityId entityId) const
+	{
+		assert(IsCaptured(entityId));
+		return m_positions[entityId];
+	}
+
+	inline const Nz::Quaternionf& TransformSnapshotSystem::GetRotation(Ndk::EntityId entityId) const
+	{
+		assert(IsCaptured(entityId));
+		return m_rotations[entityId];
+	}
+
+	// Entities are captured as soon as they are added to the world (on refresh), transforms are then updated at the end of every tick
+	inline bool TransformSnapshotSystem::IsCaptured(Ndk::EntityId entityId) const
+	{
+		return m_capturedEntities.UnboundedTest(entityId);
+	}
+}
@@ -0,0 +1,147 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/TaskPool.hpp>
+#include <thread>
+
+namespace ewn
+{
+	TaskPool::TaskPool(std::size_t workerCount) :
+	m_running(true),
+	m_nextQueue(0),
+	m_pendingJobs(0)
+	{
+		m_queues.reserve(workerCount);
+		for (std::size_t i = 0; i < workerCount; ++i)
+			m_queues.emplace_back(std::make_unique<JobQueue>());
+
+		m_threads.reserve(workerCount);
+		for (std::size_t i = 0; i < workerCount; ++i)
+		{
+			Nz::Thread& thread = m_threads.emplace_back([this, i]() { WorkerThread(i); });
+			thread.SetName("TaskPool #" + Nz::String::Number(i));
+		}
+	}
+
+	TaskPool::~TaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_wakeUpMutex);
+			m_running.store(false, std::memory_order_release);
+		}
+		m_wakeUpSignal.notify_all();
+
+		for (Nz::Thread& thread : m_threads)
+			thread.Join();
+	}
+
+	// Runs task(0) to task(taskCount - 1) in parallel and returns once all of them are done, the calling thread helps meanwhile
+	void TaskPool::Run(std::size_t taskCount, const Task& task)
+	{
+		if (taskCount == 0)
+			return;
+
+		if (m_threads.empty())
+		{
+			for (std::size_t i = 0; i < taskCount; ++i)
+				task(i);
+
+			return;
+		}
+
+		Batch batch;
+		batch.remainingJobs.store(taskCount, std::memory_order_relaxed);
+
+		m_pendingJobs.fetch_add(taskCount, std::memory_order_release); //< Before pushing, so it never goes below zero
+
+		// Spread jobs over worker queues, other workers will steal them if their owner is busy
+		std::size_t queueIndex = m_nextQueue.fetch_add(1, std::memory_order_relaxed);
+		for (std::size_t i = 0; i < taskCount; ++i)
+		{
+			JobQueue& queue = *m_queues[queueIndex++ % m_queues.size()];
+
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(Job{ &task, &batch, i });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_wakeUpMutex); //< Prevents a worker from missing the signal between its check and its wait
+		}
+		m_wakeUpSignal.notify_all();
+
+		while (batch.remainingJobs.load(std::memory_order_acquire) > 0)
+		{
+			Job job;
+			if (StealJob(m_queues.size(), &job))
+			{
+				(*job.task)(job.taskIndex);
+				job.batch->remainingJobs.fetch_sub(1, std::memory_order_acq_rel);
+			}
+			else
+				std::this_thread::yield(); //< Our last jobs are running on other threads
+		}
+	}
+
+	bool TaskPool::PopJob(std::size_t queueIndex, Job* job)
+	{
+		JobQueue& queue = *m_queues[queueIndex];
+
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+			return false;
+
+		// Owners take their most recent job, thieves the oldest one
+		*job = queue.jobs.back();
+		queue.jobs.pop_back();
+
+		m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// thiefIndex is the queue of the calling worker (skipped), or the queue count for threads outside of the pool
+	bool TaskPool::StealJob(std::size_t thiefIndex, Job* job)
+	{
+		std::size_t queueCount = m_queues.size();
+		for (std::size_t offset = 1; offset <= queueCount; ++offset)
+		{
+			std::size_t queueIndex = (thiefIndex + offset) % queueCount;
+			if (queueIndex == thiefIndex)
+				continue;
+
+			JobQueue& queue = *m_queues[queueIndex];
+
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty())
+				continue;
+
+			*job = queue.jobs.front();
+			queue.jobs.pop_front();
+
+			m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		return false;
+	}
+
+	void TaskPool::WorkerThread(std::size_t workerIndex)
+	{
+		while (m_running.load(std::memory_order_acquire))
+		{
+			Job job;
+			if (PopJob(workerIndex, &job) || StealJob(workerIndex, &job))
+			{
+				(*job.task)(job.taskIndex);
+				job.batch->remainingJobs.fetch_sub(1, std::memory_order_acq_rel);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+			m_wakeUpSignal.wait(lock, [&]()
+			{
+				return !m_running.load(std::memory_order_acquire) || m_pendingJobs.load(std::memory_order_acquire) > 0;
+			});
+		}
+	}
+}
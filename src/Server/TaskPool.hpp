@@ -0,0 +1,82 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_TASKPOOL_HPP
+#define EREWHON_SERVER_TASKPOOL_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <Nazara/Core/Thread.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ewn
+{
+	// Work-stealing pool shared by every arena to run their simulation in parallel
+	// Each worker has its own queue and steals from the others once it is empty, threads waiting for their tasks run queued tasks meanwhile
+	class TaskPool
+	{
+		public:
+			using Task = std::function<void(std::size_t /*taskIndex*/)>;
+
+			TaskPool(std::size_t workerCount);
+			TaskPool(const TaskPool&) = delete;
+			TaskPool(TaskPool&&) = delete;
+			~TaskPool();
+
+			template<typename F> void ForEachChunk(std::size_t count, std::size_t chunkSize, F&& func);
+
+			inline std::size_t GetWorkerCount() const;
+
+			void Run(std::size_t taskCount, const Task& task);
+
+			TaskPool& operator=(const TaskPool&) = delete;
+			TaskPool& operator=(TaskPool&&) = delete;
+
+		private:
+			struct Batch;
+			struct Job;
+
+			bool PopJob(std::size_t queueIndex, Job* job);
+			bool StealJob(std::size_t thiefIndex, Job* job);
+
+			void WorkerThread(std::size_t workerIndex);
+
+			struct Batch
+			{
+				std::atomic_size_t remainingJobs;
+			};
+
+			struct Job
+			{
+				const Task* task;
+				Batch* batch;
+				std::size_t taskIndex;
+			};
+
+			struct JobQueue
+			{
+				std::deque<Job> jobs;
+				std::mutex mutex;
+			};
+
+			std::atomic_bool m_running;
+			std::atomic_size_t m_nextQueue;
+			std::atomic_size_t m_pendingJobs;
+			std::condition_variable m_wakeUpSignal;
+			std::mutex m_wakeUpMutex;
+			std::vector<std::unique_ptr<JobQueue>> m_queues; //< One per worker
+			std::vector<Nz::Thread> m_threads;
+	};
+}
+
+#include <Server/TaskPool.inl>
+
+#endif // EREWHON_SERVER_TASKPOOL_HPP
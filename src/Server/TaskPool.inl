@@ -0,0 +1,38 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/TaskPool.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace ewn
+{
+	// Calls func(first, last) for consecutive ranges of at most chunkSize elements, in parallel, and waits for all of them
+	template<typename F>
+	void TaskPool::ForEachChunk(std::size_t count, std::size_t chunkSize, F&& func)
+	{
+		assert(chunkSize > 0);
+
+		if (count == 0)
+			return;
+
+		std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+		if (chunkCount == 1 || m_threads.empty())
+		{
+			func(std::size_t(0), count);
+			return;
+		}
+
+		Run(chunkCount, [&](std::size_t chunkIndex)
+		{
+			std::size_t first = chunkIndex * chunkSize;
+			func(first, std::min(first + chunkSize, count));
+		});
+	}
+
+	inline std::size_t TaskPool::GetWorkerCount() const
+	{
+		return m_threads.size();
+	}
+}
@@ -0,0 +1,139 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/TimerWheel.hpp>
+#include <algorithm>
+
+namespace ewn
+{
+	void TimerWheel::Advance(Nz::UInt64 tick)
+	{
+		while (m_currentTick < tick)
+		{
+			m_currentTick++;
+
+			// Once a coarser slot is reached, its timers are spread over finer levels (coarsest first, so they can cascade down to level 0)
+			for (std::size_t level = LevelCount - 1; level > 0; --level)
+			{
+				if ((m_currentTick & ((Nz::UInt64(1) << (level * LevelBits)) - 1)) != 0)
+					continue;
+
+				std::size_t slotIndex = static_cast<std::size_t>((m_currentTick >> (level * LevelBits)) & (SlotCount - 1));
+
+				m_processedSlot.clear();
+				std::swap(m_processedSlot, m_levels[level][slotIndex]);
+
+				for (std::size_t timerIndex : m_processedSlot)
+				{
+					if (m_timers[timerIndex].active)
+						Insert(timerIndex);
+					else
+						Release(timerIndex);
+				}
+			}
+
+			std::size_t slotIndex = static_cast<std::size_t>(m_currentTick & (SlotCount - 1));
+
+			m_processedSlot.clear();
+			std::swap(m_processedSlot, m_levels[0][slotIndex]);
+
+			for (std::size_t timerIndex : m_processedSlot)
+			{
+				Timer& timer = m_timers[timerIndex];
+				if (!timer.active)
+				{
+					Release(timerIndex);
+					continue;
+				}
+
+				// Only happens to timers scheduled beyond the coarsest level range
+				if (timer.expirationTick > m_currentTick)
+				{
+					Insert(timerIndex);
+					continue;
+				}
+
+				// Release the timer before running it, the callback may schedule (and reallocate timers) or cancel its own id
+				Callback callback = std::move(timer.callback);
+				m_activeTimerCount--;
+				Release(timerIndex);
+
+				callback();
+			}
+		}
+	}
+
+	bool TimerWheel::Cancel(TimerId timerId)
+	{
+		std::size_t timerIndex = static_cast<std::size_t>(timerId & 0xFFFFFFFF);
+		Nz::UInt32 generation = static_cast<Nz::UInt32>(timerId >> 32);
+
+		if (timerIndex >= m_timers.size())
+			return false;
+
+		Timer& timer = m_timers[timerIndex];
+		if (!timer.active || timer.generation != generation)
+			return false;
+
+		// Timer stays in its slot until the wheel reaches it, it is released there
+		timer.active = false;
+		timer.callback = nullptr;
+		timer.generation++;
+		m_activeTimerCount--;
+
+		return true;
+	}
+
+	TimerWheel::TimerId TimerWheel::Schedule(Nz::UInt64 tick, Callback callback)
+	{
+		std::size_t timerIndex;
+		if (!m_freeTimers.empty())
+		{
+			timerIndex = m_freeTimers.back();
+			m_freeTimers.pop_back();
+		}
+		else
+		{
+			timerIndex = m_timers.size();
+			m_timers.emplace_back();
+		}
+
+		Timer& timer = m_timers[timerIndex];
+		timer.active = true;
+		timer.callback = std::move(callback);
+		timer.expirationTick = std::max(tick, m_currentTick + 1); //< Timers which are already due run on the next advance
+
+		m_activeTimerCount++;
+
+		Insert(timerIndex);
+
+		return (TimerId(timer.generation) << 32) | timerIndex;
+	}
+
+	void TimerWheel::Insert(std::size_t timerIndex)
+	{
+		Nz::UInt64 expirationTick = m_timers[timerIndex].expirationTick;
+		Nz::UInt64 delay = expirationTick - m_currentTick;
+
+		// Pick the finest level whose range covers the delay, timers beyond the coarsest range are reinserted until they get close enough
+		std::size_t level = 0;
+		while (level < LevelCount - 1 && delay >= (Nz::UInt64(1) << ((level + 1) * LevelBits)))
+			level++;
+
+		std::size_t slotIndex = static_cast<std::size_t>((expirationTick >> (level * LevelBits)) & (SlotCount - 1));
+		m_levels[level][slotIndex].push_back(timerIndex);
+	}
+
+	void TimerWheel::Release(std::size_t timerIndex)
+	{
+		Timer& timer = m_timers[timerIndex];
+		if (timer.active)
+		{
+			timer.active = false;
+			timer.generation++;
+		}
+
+		m_freeTimers.push_back(timerIndex);
+	}
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef EREWHON_SERVER_TIMERWHEEL_HPP
+#define EREWHON_SERVER_TIMERWHEEL_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace ewn
+{
+	// Hierarchical timer wheel counting in arena ticks, advancing it only touches timers which are due (or have to move to a finer level)
+	class TimerWheel
+	{
+		public:
+			using Callback = std::function<void()>;
+			using TimerId = Nz::UInt64;
+
+			inline TimerWheel();
+			TimerWheel(const TimerWheel&) = delete;
+			TimerWheel(TimerWheel&&) = delete;
+			~TimerWheel() = default;
+
+			void Advance(Nz::UInt64 tick);
+
+			bool Cancel(TimerId timerId);
+
+			inline Nz::UInt64 GetCurrentTick() const;
+			inline std::size_t GetTimerCount() const;
+
+			TimerId Schedule(Nz::UInt64 tick, Callback callback);
+
+			TimerWheel& operator=(const TimerWheel&) = delete;
+			TimerWheel& operator=(TimerWheel&&) = delete;
+
+			static constexpr TimerId InvalidTimerId = 0;
+
+		private:
+			void Insert(std::size_t timerIndex);
+			void Release(std::size_t timerIndex);
+
+			static constexpr std::size_t LevelBits = 6;
+			static constexpr std::size_t LevelCount = 4;
+			static constexpr std::size_t SlotCount = std::size_t(1) << LevelBits;
+
+			struct Timer
+			{
+				Callback callback;
+				Nz::UInt64 expirationTick;
+				Nz::UInt32 generation = 1; //< Incremented each time the timer is released, so ids of dead timers are never valid
+				bool active = false;
+			};
+
+			using Slot = std::vector<std::size_t>;
+
+			std::array<std::array<Slot, SlotCount>, LevelCount> m_levels;
+			std::vector<std::size_t> m_freeTimers;
+			std::vector<Timer> m_timers;
+			Slot m_processedSlot;
+			Nz::UInt64 m_currentTick;
+			std::size_t m_activeTimerCount;
+	};
+}
+
+#include <Server/TimerWheel.inl>
+
+#endif // EREWHON_SERVER_TIMERWHEEL_HPP
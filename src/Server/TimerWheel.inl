@@ -0,0 +1,24 @@
+// Copyright (C) 2018 Jérôme Leclercq
+// This file is part of the "Erewhon Server" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Server/TimerWheel.hpp>
+
+namespace ewn
+{
+	inline TimerWheel::TimerWheel() :
+	m_currentTick(0),
+	m_activeTimerCount(0)
+	{
+	}
+
+	inline Nz::UInt64 TimerWheel::GetCurrentTick() const
+	{
+		return m_currentTick;
+	}
+
+	inline std::size_t TimerWheel::GetTimerCount() const
+	{
+		return m_activeTimerCount;
+	}
+}
@@ -10,15 +10,18 @@
 #include <Server/Components/NavigationComponent.hpp>
 #include <Server/Components/OwnerComponent.hpp>
 #include <Server/Components/PlayerControlledComponent.hpp>
-#include <Server/Components/ProjectileComponent.hpp>
 #include <Server/Components/RadarComponent.hpp>
 #include <Server/Components/ScriptComponent.hpp>
 #include <Server/Components/SynchronizedComponent.hpp>
 #include <Server/Systems/BroadcastSystem.hpp>
 #include <Server/Systems/LifeTimeSystem.hpp>
 #include <Server/Systems/NavigationSystem.hpp>
+#include <Server/Systems/PhysicsActivitySystem.hpp>
+#include <Server/Systems/RadarSystem.hpp>
 #include <Server/Systems/ScriptSystem.hpp>
+#include <Server/Systems/SpatialIndexSystem.hpp>
 #include <Server/Systems/SpaceshipSystem.hpp>
+#include <Server/Systems/TransformSnapshotSystem.hpp>
 #include <Nazara/Core/Initializer.hpp>
 #include <Nazara/Core/Thread.hpp>
 #include <Nazara/Network/Network.hpp>
@@ -36,15 +39,18 @@ int main()
 	Ndk::InitializeComponent<ewn::NavigationComponent>("NavigCmp");
 	Ndk::InitializeComponent<ewn::OwnerComponent>("OwnrComp");
 	Ndk::InitializeComponent<ewn::PlayerControlledComponent>("PlyCtrl");
-	Ndk::InitializeComponent<ewn::ProjectileComponent>("Prjctile");
 	Ndk::InitializeComponent<ewn::RadarComponent>("RadarCmp");
 	Ndk::InitializeComponent<ewn::ScriptComponent>("ScrptCmp");
 	Ndk::InitializeComponent<ewn::SynchronizedComponent>("SyncComp");
 	Ndk::InitializeSystem<ewn::BroadcastSystem>();
 	Ndk::InitializeSystem<ewn::LifeTimeSystem>();
 	Ndk::InitializeSystem<ewn::NavigationSystem>();
+	Ndk::InitializeSystem<ewn::PhysicsActivitySystem>();
+	Ndk::InitializeSystem<ewn::RadarSystem>();
 	Ndk::InitializeSystem<ewn::ScriptSystem>();
+	Ndk::InitializeSystem<ewn::SpatialIndexSystem>();
 	Ndk::InitializeSystem<ewn::SpaceshipSystem>();
+	Ndk::InitializeSystem<ewn::TransformSnapshotSystem>();
 
 	ewn::ServerApplication app;
 	if (!app.LoadConfig("sconfig.lua"))
@@ -15,12 +15,19 @@ namespace ewn
 		{
 			reactorPtr->Poll([&](bool outgoing, std::size_t clientId, Nz::UInt32 data) { HandlePeerConnection(outgoing, clientId, data); },
 			                 [&](std::size_t clientId, Nz::UInt32 data) { HandlePeerDisconnection(clientId, data); },
-			                 [&](std::size_t clientId, Nz::NetPacket&& packet) { HandlePeerPacket(clientId, std::move(packet)); });
+			                 [&](std::size_t clientId, Nz::NetPacket&& packet) { HandlePeerPacket(clientId, std::move(packet)); },
+			                 [&](std::size_t clientId, Packets::AnyPacket&& message) { HandlePeerMessage(clientId, std::move(message)); });
 		}
 
 		return Application::Run();
 	}
 
+	void BaseApplication::HandlePeerMessage(std::size_t peerId, Packets::AnyPacket&& /*message*/)
+	{
+		// Only called for reactors created with a packet decoder
+		std::cerr << "Unhandled decoded packet from peer #" << peerId << std::endl;
+	}
+
 	void BaseApplication::OnConfigLoaded(const ConfigFile& /*config*/)
 	{
 	}
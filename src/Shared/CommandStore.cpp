@@ -3,14 +3,22 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Shared/CommandStore.hpp>
+#include <cassert>
 #include <iostream>
 
 namespace ewn
 {
 	CommandStore::~CommandStore() = default;
 
-	bool CommandStore::UnserializePacket(std::size_t peerId, Nz::NetPacket&& packet) const
+	bool CommandStore::DecodePacket(std::size_t peerId, Nz::NetPacket&& packet, Packets::AnyPacket& decoded) const
 	{
+		// This may be called from a network thread, don't touch anything that isn't immutable after construction
+		if (packet.GetDataSize() > m_maxIncomingPacketSize)
+		{
+			std::cerr << "Client #" << peerId << " sent a packet too big (" << packet.GetDataSize() << " bytes)" << std::endl;
+			return false;
+		}
+
 		Nz::UInt8 opcode;
 		try
 		{
@@ -28,7 +36,30 @@ namespace ewn
 			return false;
 		}
 
-		m_incomingCommands[opcode].unserialize(peerId, std::move(packet));
+		if (!m_incomingCommands[opcode].decode(packet, decoded))
+		{
+			std::cerr << "Client #" << peerId << " sent an invalid " << m_incomingCommands[opcode].name << " packet" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	void CommandStore::DispatchPacket(std::size_t peerId, const Packets::AnyPacket& packet) const
+	{
+		std::size_t opcode = packet.index();
+		assert(opcode < m_incomingCommands.size() && m_incomingCommands[opcode].enabled);
+
+		m_incomingCommands[opcode].dispatch(peerId, packet);
+	}
+
+	bool CommandStore::UnserializePacket(std::size_t peerId, Nz::NetPacket&& packet) const
+	{
+		Packets::AnyPacket decoded;
+		if (!DecodePacket(peerId, std::move(packet), decoded))
+			return false;
+
+		DispatchPacket(peerId, decoded);
 		return true;
 	}
 }
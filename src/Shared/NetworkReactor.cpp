@@ -5,15 +5,21 @@
 #include <Shared/NetworkReactor.hpp>
 #include <Shared/Config.hpp>
 #include <Shared/Utils.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <iterator>
 #include <mutex>
 #include <stdexcept>
 
 namespace ewn
 {
-	NetworkReactor::NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient) :
+	NetworkReactor::NetworkReactor(std::size_t firstId, Nz::NetProtocol protocol, Nz::UInt16 port, std::size_t maxClient, PacketDecoder decoder) :
 	m_firstId(firstId),
+	m_randomGenerator(std::random_device{}()),
+	m_delayedEventSequence(0),
+	m_decoder(std::move(decoder)),
 	m_protocol(protocol)
 	{
 		if (port > 0)
@@ -25,6 +31,12 @@ namespace ewn
 			throw std::runtime_error("Failed to start reactor");
 
 		m_clients.resize(maxClient, nullptr);
+		m_peerImpairments.resize(maxClient);
+
+		// Events are moved in bulk through the queues, which is much cheaper than one queue operation per event
+		m_incomingBatch.reserve(NetworkEventBatchSize);
+		m_outgoingBatch.resize(NetworkEventBatchSize);
+		m_polledEvents.resize(NetworkEventBatchSize);
 
 		m_running.store(true, std::memory_order_release);
 		m_thread = Nz::Thread(&NetworkReactor::WorkerThread, this);
@@ -84,6 +96,17 @@ namespace ewn
 		m_outgoingQueue.enqueue(std::move(outgoingData));
 	}
 
+	void NetworkReactor::RegisterFastPathHandler(PacketType packetType, FastPathHandler handler)
+	{
+		// Fast path handlers are called from the reactor thread for decoded packets, instead of being forwarded to the application
+		// They must be stateless (or thread-safe) and should only be used for latency-critical packets
+		FastPathRegistration registration;
+		registration.handler = std::move(handler);
+		registration.packetType = packetType;
+
+		m_fastPathRegistrations.enqueue(std::move(registration));
+	}
+
 	void NetworkReactor::SendData(std::size_t peerId, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet)
 	{
 		assert(peerId >= m_firstId);
@@ -100,6 +123,27 @@ namespace ewn
 		m_outgoingQueue.enqueue(std::move(outgoingData));
 	}
 
+	void NetworkReactor::SetImpairment(const Impairment& impairment)
+	{
+		ImpairmentUpdate update;
+		update.impairment = impairment;
+		update.peerIndex = InvalidPeerId;
+
+		m_impairmentUpdates.enqueue(std::move(update));
+	}
+
+	void NetworkReactor::SetPeerImpairment(std::size_t peerId, std::optional<Impairment> impairment)
+	{
+		assert(peerId >= m_firstId);
+
+		// Peer impairment is reset when the peer disconnects
+		ImpairmentUpdate update;
+		update.impairment = std::move(impairment);
+		update.peerIndex = peerId - m_firstId;
+
+		m_impairmentUpdates.enqueue(std::move(update));
+	}
+
 	void NetworkReactor::WorkerThread()
 	{
 		moodycamel::ConsumerToken connectionToken(m_connectionRequests);
@@ -108,8 +152,11 @@ namespace ewn
 
 		while (m_running.load(std::memory_order_acquire))
 		{
+			HandleFastPathRegistrations();
+			HandleImpairmentUpdates();
 			ReceivePackets(incomingToken);
 			SendPackets(incomingToken, outgoingToken);
+			ReleaseDelayedEvents(incomingToken);
 
 			// Handle connection requests last to treat disconnection request before connection requests
 			HandleConnectionRequests(connectionToken);
@@ -133,11 +180,265 @@ namespace ewn
 		}
 	}
 
+	void NetworkReactor::HandleFastPathRegistrations()
+	{
+		FastPathRegistration registration;
+		while (m_fastPathRegistrations.try_dequeue(registration))
+		{
+			std::size_t packetIndex = static_cast<std::size_t>(registration.packetType);
+			if (m_fastPathHandlers.size() <= packetIndex)
+				m_fastPathHandlers.resize(packetIndex + 1);
+
+			m_fastPathHandlers[packetIndex] = std::move(registration.handler);
+		}
+	}
+
+	void NetworkReactor::HandleImpairmentUpdates()
+	{
+		ImpairmentUpdate update;
+		while (m_impairmentUpdates.try_dequeue(update))
+		{
+			if (update.peerIndex == InvalidPeerId)
+				m_impairment = (update.impairment) ? *update.impairment : Impairment{};
+			else if (update.peerIndex < m_peerImpairments.size())
+				m_peerImpairments[update.peerIndex].impairment = update.impairment;
+		}
+	}
+
+	std::size_t NetworkReactor::ImpairEvent(const Impairment& impairment, DelayState& state, ImpairedEventType type, Nz::UInt64 now, std::array<Nz::UInt64, 2>& releaseTimes)
+	{
+		std::uniform_real_distribution<float> chanceDis(0.f, 1.f);
+		auto ComputeDelay = [&]() -> Nz::UInt64
+		{
+			Nz::UInt64 delay = impairment.latency;
+			if (impairment.jitter > 0)
+				delay += std::uniform_int_distribution<Nz::UInt32>(0, impairment.jitter)(m_randomGenerator);
+
+			return delay;
+		};
+
+		Nz::UInt64 releaseTime = now + ComputeDelay();
+		std::size_t copyCount = 1;
+
+		switch (type)
+		{
+			case ImpairedEventType::Connection:
+				releaseTime = std::max(releaseTime, state.lastRelease);
+				state.lastReliableRelease = releaseTime;
+				state.lastUnreliableRelease = releaseTime;
+				break;
+
+			case ImpairedEventType::Reliable:
+				// ENet resends lost reliable packets, which costs at least another round-trip
+				if (chanceDis(m_randomGenerator) < impairment.lossChance)
+					releaseTime += 2 * ComputeDelay();
+
+				releaseTime = std::max(releaseTime, state.lastReliableRelease);
+				state.lastReliableRelease = releaseTime;
+				break;
+
+			case ImpairedEventType::Unreliable:
+				if (chanceDis(m_randomGenerator) < impairment.lossChance)
+					return 0;
+
+				if (chanceDis(m_randomGenerator) >= impairment.reorderChance)
+				{
+					releaseTime = std::max(releaseTime, state.lastUnreliableRelease);
+					state.lastUnreliableRelease = releaseTime;
+				}
+
+				if (chanceDis(m_randomGenerator) < impairment.duplicationChance)
+				{
+					releaseTimes[1] = now + ComputeDelay();
+					state.lastRelease = std::max(state.lastRelease, releaseTimes[1]);
+					copyCount = 2;
+				}
+				break;
+		}
+
+		releaseTimes[0] = releaseTime;
+		state.lastRelease = std::max(state.lastRelease, releaseTime);
+
+		return copyCount;
+	}
+
+	void NetworkReactor::ProcessOutgoingEvent(OutgoingEvent& outEvent)
+	{
+		std::visit([&](auto&& arg) {
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, OutgoingEvent::DisconnectEvent>)
+			{
+				if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
+				{
+					switch (arg.type)
+					{
+						case DisconnectionType::Kick:
+						{
+							peer->DisconnectNow(arg.data);
+
+							// DisconnectNow does not generate Disconnect event
+							m_clients[outEvent.peerId] = nullptr;
+							PurgeDelayedOutgoingEvents(outEvent.peerId);
+
+							IncomingEvent::DisconnectEvent disconnectEvent{};
+							disconnectEvent.data = 0;
+
+							IncomingEvent newEvent{};
+							newEvent.peerId = m_firstId + outEvent.peerId;
+							newEvent.data.emplace<IncomingEvent::DisconnectEvent>(std::move(disconnectEvent));
+
+							QueueIncomingEvent(outEvent.peerId, ImpairedEventType::Connection, std::move(newEvent), Nz::GetElapsedMilliseconds());
+							break;
+						}
+
+						case DisconnectionType::Later:
+							peer->DisconnectLater(arg.data);
+							break;
+
+						case DisconnectionType::Normal:
+							peer->Disconnect(arg.data);
+							break;
+
+						default:
+							assert(!"Unknown disconnection type");
+							break;
+					}
+				}
+			}
+			else if constexpr (std::is_same_v<T, OutgoingEvent::PacketEvent>)
+			{
+				if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
+					peer->Send(arg.channelId, arg.flags, std::move(arg.packet));
+			}
+			else
+				static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+
+		}, outEvent.data);
+	}
+
+	void NetworkReactor::PublishIncomingEvents(const moodycamel::ProducerToken& producterToken)
+	{
+		if (m_incomingBatch.empty())
+			return;
+
+		m_incomingQueue.enqueue_bulk(producterToken, std::make_move_iterator(m_incomingBatch.begin()), m_incomingBatch.size());
+		m_incomingBatch.clear();
+	}
+
+	void NetworkReactor::PurgeDelayedOutgoingEvents(std::size_t peerIndex)
+	{
+		// Packets delayed for a disconnected peer must not be sent to the next peer using its slot
+		auto it = std::remove_if(m_delayedOutgoingEvents.begin(), m_delayedOutgoingEvents.end(), [&](const DelayedOutgoingEvent& delayedEvent)
+		{
+			return delayedEvent.event.peerId == peerIndex;
+		});
+
+		if (it != m_delayedOutgoingEvents.end())
+		{
+			m_delayedOutgoingEvents.erase(it, m_delayedOutgoingEvents.end());
+			std::make_heap(m_delayedOutgoingEvents.begin(), m_delayedOutgoingEvents.end(), &IsReleasedAfter<DelayedOutgoingEvent>);
+		}
+
+		PeerImpairment& peerImpairment = m_peerImpairments[peerIndex];
+		peerImpairment.impairment.reset();
+		peerImpairment.outgoing = DelayState{};
+	}
+
+	void NetworkReactor::PushIncomingEvent(IncomingEvent&& event)
+	{
+		if (IncomingEvent::DecodedPacketEvent* packetEvent = std::get_if<IncomingEvent::DecodedPacketEvent>(&event.data))
+		{
+			std::size_t packetIndex = packetEvent->packet.index();
+			if (packetIndex < m_fastPathHandlers.size() && m_fastPathHandlers[packetIndex])
+			{
+				m_fastPathHandlers[packetIndex](*this, event.peerId, packetEvent->packet);
+				return;
+			}
+		}
+
+		m_incomingBatch.emplace_back(std::move(event));
+	}
+
+	void NetworkReactor::QueueIncomingEvent(std::size_t peerIndex, ImpairedEventType type, IncomingEvent&& event, Nz::UInt64 now)
+	{
+		PeerImpairment& peerImpairment = m_peerImpairments[peerIndex];
+		const Impairment& impairment = (peerImpairment.impairment) ? *peerImpairment.impairment : m_impairment;
+
+		// Keep going through the delay queue while events are pending for this peer, to preserve ordering
+		if (!impairment.IsEnabled() && peerImpairment.incoming.lastRelease <= now)
+		{
+			PushIncomingEvent(std::move(event));
+			return;
+		}
+
+		std::array<Nz::UInt64, 2> releaseTimes;
+		std::size_t copyCount = ImpairEvent(impairment, peerImpairment.incoming, type, now, releaseTimes);
+
+		// Only decoded packets are duplicated (raw packets would require to copy their read cursor)
+		if (copyCount > 1)
+		{
+			if (const IncomingEvent::DecodedPacketEvent* packetEvent = std::get_if<IncomingEvent::DecodedPacketEvent>(&event.data))
+			{
+				IncomingEvent duplicatedEvent;
+				duplicatedEvent.peerId = event.peerId;
+				duplicatedEvent.data.emplace<IncomingEvent::DecodedPacketEvent>(*packetEvent);
+
+				ScheduleEvent(m_delayedIncomingEvents, releaseTimes[1], std::move(duplicatedEvent));
+			}
+		}
+
+		if (copyCount > 0)
+			ScheduleEvent(m_delayedIncomingEvents, releaseTimes[0], std::move(event));
+	}
+
+	void NetworkReactor::QueueOutgoingEvent(OutgoingEvent&& event, Nz::UInt64 now)
+	{
+		PeerImpairment& peerImpairment = m_peerImpairments[event.peerId];
+		const Impairment& impairment = (peerImpairment.impairment) ? *peerImpairment.impairment : m_impairment;
+
+		if (!impairment.IsEnabled() && peerImpairment.outgoing.lastRelease <= now)
+		{
+			ProcessOutgoingEvent(event);
+			return;
+		}
+
+		ImpairedEventType type = ImpairedEventType::Connection;
+		if (OutgoingEvent::PacketEvent* packetEvent = std::get_if<OutgoingEvent::PacketEvent>(&event.data))
+			type = (packetEvent->flags & Nz::ENetPacketFlag_Reliable) ? ImpairedEventType::Reliable : ImpairedEventType::Unreliable;
+
+		std::array<Nz::UInt64, 2> releaseTimes;
+		std::size_t copyCount = ImpairEvent(impairment, peerImpairment.outgoing, type, now, releaseTimes);
+
+		if (copyCount > 1)
+		{
+			const OutgoingEvent::PacketEvent& packetEvent = std::get<OutgoingEvent::PacketEvent>(event.data);
+
+			OutgoingEvent::PacketEvent duplicatedPacket;
+			duplicatedPacket.channelId = packetEvent.channelId;
+			duplicatedPacket.flags = packetEvent.flags;
+			duplicatedPacket.packet.Write(packetEvent.packet.GetConstData() + Nz::NetPacket::HeaderSize, packetEvent.packet.GetDataSize());
+
+			OutgoingEvent duplicatedEvent;
+			duplicatedEvent.peerId = event.peerId;
+			duplicatedEvent.data = std::move(duplicatedPacket);
+
+			ScheduleEvent(m_delayedOutgoingEvents, releaseTimes[1], std::move(duplicatedEvent));
+		}
+
+		if (copyCount > 0)
+			ScheduleEvent(m_delayedOutgoingEvents, releaseTimes[0], std::move(event));
+	}
+
 	void NetworkReactor::ReceivePackets(const moodycamel::ProducerToken& producterToken)
 	{
+		// Wake up more often when events are waiting to be released
+		Nz::UInt32 serviceTimeout = (m_delayedIncomingEvents.empty() && m_delayedOutgoingEvents.empty()) ? 5 : 1;
+
 		Nz::ENetEvent event;
-		if (m_host.Service(&event, 5) > 0)
+		if (m_host.Service(&event, serviceTimeout) > 0)
 		{
+			Nz::UInt64 now = Nz::GetElapsedMilliseconds();
+
 			do
 			{
 				switch (event.type)
@@ -146,6 +447,7 @@ namespace ewn
 					{
 						Nz::UInt16 peerId = event.peer->GetPeerId();
 						m_clients[peerId] = nullptr;
+						PurgeDelayedOutgoingEvents(peerId);
 
 						IncomingEvent::DisconnectEvent disconnectEvent;
 						disconnectEvent.data = event.data;
@@ -154,7 +456,7 @@ namespace ewn
 						newEvent.peerId = m_firstId + peerId;
 						newEvent.data.emplace<IncomingEvent::DisconnectEvent>(std::move(disconnectEvent));
 
-						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+						QueueIncomingEvent(peerId, ImpairedEventType::Connection, std::move(newEvent), now);
 						break;
 					}
 
@@ -172,7 +474,7 @@ namespace ewn
 						newEvent.peerId = m_firstId + peerId;
 						newEvent.data.emplace<IncomingEvent::ConnectEvent>(std::move(connectEvent));
 
-						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+						QueueIncomingEvent(peerId, ImpairedEventType::Connection, std::move(newEvent), now);
 						break;
 					}
 
@@ -180,14 +482,28 @@ namespace ewn
 					{
 						Nz::UInt16 peerId = event.peer->GetPeerId();
 
-						IncomingEvent::PacketEvent packetEvent;
-						packetEvent.packet = std::move(event.packet->data);
-
 						IncomingEvent newEvent;
 						newEvent.peerId = m_firstId + peerId;
-						newEvent.data.emplace<IncomingEvent::PacketEvent>(std::move(packetEvent));
 
-						m_incomingQueue.enqueue(producterToken, std::move(newEvent));
+						if (m_decoder)
+						{
+							// Decode and validate packets here so that malformed ones never reach the application thread
+							IncomingEvent::DecodedPacketEvent& packetEvent = newEvent.data.emplace<IncomingEvent::DecodedPacketEvent>();
+							if (!m_decoder(newEvent.peerId, std::move(event.packet->data), packetEvent.packet))
+							{
+								event.peer->Disconnect(0);
+								break;
+							}
+
+						}
+						else
+						{
+							IncomingEvent::PacketEvent& packetEvent = newEvent.data.emplace<IncomingEvent::PacketEvent>();
+							packetEvent.packet = std::move(event.packet->data);
+						}
+
+						ImpairedEventType eventType = (event.packet->flags & Nz::ENetPacketFlag_Reliable) ? ImpairedEventType::Reliable : ImpairedEventType::Unreliable;
+						QueueIncomingEvent(peerId, eventType, std::move(newEvent), now);
 						break;
 					}
 
@@ -196,63 +512,48 @@ namespace ewn
 				}
 			}
 			while (m_host.CheckEvents(&event));
+
+			PublishIncomingEvents(producterToken);
 		}
 	}
 
-	void NetworkReactor::SendPackets(const moodycamel::ProducerToken& producterToken, const moodycamel::ConsumerToken& token)
+	void NetworkReactor::ReleaseDelayedEvents(const moodycamel::ProducerToken& producterToken)
 	{
-		OutgoingEvent outEvent;
-		while (m_outgoingQueue.try_dequeue(outEvent))
-		{
-			std::visit([&](auto&& arg) {
-				using T = std::decay_t<decltype(arg)>;
-				if constexpr (std::is_same_v<T, OutgoingEvent::DisconnectEvent>)
-				{
-					if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
-					{
-						switch (arg.type)
-						{
-							case DisconnectionType::Kick:
-							{
-								peer->DisconnectNow(arg.data);
-
-								// DisconnectNow does not generate Disconnect event
-								m_clients[outEvent.peerId] = nullptr;
+		Nz::UInt64 now = Nz::GetElapsedMilliseconds();
 
-								IncomingEvent::DisconnectEvent disconnectEvent{};
-								disconnectEvent.data = 0;
+		while (!m_delayedIncomingEvents.empty() && m_delayedIncomingEvents.front().releaseTime <= now)
+		{
+			std::pop_heap(m_delayedIncomingEvents.begin(), m_delayedIncomingEvents.end(), &IsReleasedAfter<DelayedIncomingEvent>);
+			IncomingEvent event = std::move(m_delayedIncomingEvents.back().event);
+			m_delayedIncomingEvents.pop_back();
 
-								IncomingEvent newEvent{};
-								newEvent.peerId = m_firstId + outEvent.peerId;
-								newEvent.data.emplace<IncomingEvent::DisconnectEvent>(std::move(disconnectEvent));
+			PushIncomingEvent(std::move(event));
+		}
 
-								m_incomingQueue.enqueue(producterToken, std::move(newEvent));
-								break;
-							}
+		while (!m_delayedOutgoingEvents.empty() && m_delayedOutgoingEvents.front().releaseTime <= now)
+		{
+			std::pop_heap(m_delayedOutgoingEvents.begin(), m_delayedOutgoingEvents.end(), &IsReleasedAfter<DelayedOutgoingEvent>);
+			OutgoingEvent event = std::move(m_delayedOutgoingEvents.back().event);
+			m_delayedOutgoingEvents.pop_back();
 
-							case DisconnectionType::Later:
-								peer->DisconnectLater(arg.data);
-								break;
+			ProcessOutgoingEvent(event);
+		}
 
-							case DisconnectionType::Normal:
-								peer->Disconnect(arg.data);
-								break;
+		PublishIncomingEvents(producterToken);
+	}
 
-							default:
-								assert(!"Unknown disconnection type");
-								break;
-						}
-					}
-				}
-				else if constexpr (std::is_same_v<T, OutgoingEvent::PacketEvent>)
-				{
-					if (Nz::ENetPeer* peer = m_clients[outEvent.peerId])
-						peer->Send(arg.channelId, arg.flags, std::move(arg.packet));
-				}
-				else
-					static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+	void NetworkReactor::SendPackets(const moodycamel::ProducerToken& producterToken, const moodycamel::ConsumerToken& token)
+	{
+		Nz::UInt64 now = Nz::GetElapsedMilliseconds();
 
-			}, outEvent.data);
+		std::size_t eventCount;
+		while ((eventCount = m_outgoingQueue.try_dequeue_bulk(token, m_outgoingBatch.begin(), m_outgoingBatch.size())) > 0)
+		{
+			for (std::size_t i = 0; i < eventCount; ++i)
+				QueueOutgoingEvent(std::move(m_outgoingBatch[i]), now);
 		}
+
+		// Kicked peers generate disconnection events
+		PublishIncomingEvents(producterToken);
 	}
 }
@@ -15,6 +15,7 @@ namespace ewn
 			m_stringMap.erase(m_strings[i]);
 
 		m_strings.erase(m_strings.begin() + firstId, m_strings.end());
+		m_hashes.erase(m_hashes.begin() + firstId, m_hashes.end());
 
 		m_strings.reserve(m_strings.size() - firstId + strings.size());
 		for (std::string& str : strings)
@@ -31,4 +32,26 @@ namespace ewn
 
 		return packet;
 	}
+
+	Nz::UInt64 NetworkStringStore::HashString(Nz::UInt64 hash, const std::string& string)
+	{
+		// 64-bit FNV-1a, chained over the whole table so the result only depends on the strings and their order
+		constexpr Nz::UInt64 prime = 1099511628211ULL;
+
+		auto HashByte = [&](Nz::UInt8 byte)
+		{
+			hash ^= byte;
+			hash *= prime;
+		};
+
+		// Hash length as well, so that string boundaries are part of the hash
+		Nz::UInt32 length = Nz::UInt32(string.size());
+		for (unsigned int i = 0; i < sizeof(length); ++i)
+			HashByte(Nz::UInt8(length >> (i * 8)));
+
+		for (char c : string)
+			HashByte(Nz::UInt8(c));
+
+		return hash;
+	}
 }
@@ -4,13 +4,24 @@
 
 #include <Shared/Protocol/Packets.hpp>
 #include <Nazara/Core/Algorithm.hpp>
+#include <Nazara/Math/Algorithm.hpp>
 #include <Nazara/Math/Vector3.hpp>
+#include <Shared/Config.hpp>
 #include <Shared/Utils.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
 
 namespace ewn
 {
 	namespace Packets
 	{
+		void Serialize(PacketSerializer& serializer, AdmissionQueuePosition& data)
+		{
+			serializer.Serialize<Nz::UInt8>(data.stage);
+			serializer &= data.position;
+		}
+
 		void Serialize(PacketSerializer& serializer, ArenaPrefabs& data)
 		{
 			serializer &= data.startId;
@@ -90,6 +101,7 @@ namespace ewn
 		{
 			serializer &= data.stateId;
 			serializer &= data.serverTime;
+			serializer &= data.serverTick;
 			serializer &= data.lastProcessedInputTime;
 
 			CompressedUnsigned<Nz::UInt32> entityCount;
@@ -137,6 +149,16 @@ namespace ewn
 			serializer &= data.visualName;
 		}
 
+		void Serialize(PacketSerializer& serializer, CreateProjectile& data)
+		{
+			serializer &= data.linearVelocity;
+			serializer &= data.position;
+			serializer &= data.prefabId;
+			serializer &= data.projectileId;
+			serializer &= data.rotation;
+			serializer &= data.spawnTime;
+		}
+
 		void Serialize(PacketSerializer& serializer, CreateSpaceship& data)
 		{
 			serializer &= data.spaceshipName;
@@ -148,6 +170,11 @@ namespace ewn
 			serializer &= data.id;
 		}
 
+		void Serialize(PacketSerializer& serializer, DeleteProjectile& data)
+		{
+			serializer &= data.projectileId;
+		}
+
 		void Serialize(PacketSerializer& serializer, DeleteSpaceship& data)
 		{
 			serializer &= data.spaceshipName;
@@ -194,6 +221,12 @@ namespace ewn
 				serializer &= string;
 		}
 
+		void Serialize(PacketSerializer& serializer, NetworkStringsHash& data)
+		{
+			serializer &= data.hash;
+			serializer &= data.stringCount;
+		}
+
 		void Serialize(PacketSerializer& serializer, PlayerChat& data)
 		{
 			serializer &= data.text;
@@ -202,12 +235,32 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, PlayerMovement& data)
 		{
 			serializer &= data.inputTime;
-			serializer &= data.direction;
-			serializer &= data.rotation;
+
+			CompressedUnsigned<Nz::UInt32> inputCount;
+			if (serializer.IsWriting())
+				inputCount = Nz::UInt32(data.inputs.size());
+
+			serializer &= inputCount;
+			if (!serializer.IsWriting())
+			{
+				// Count comes from the client, check it before allocating anything
+				if (inputCount > PlayerInputBatchMaxSize)
+					throw std::runtime_error("too many inputs (" + std::to_string(Nz::UInt32(inputCount)) + " > " + std::to_string(PlayerInputBatchMaxSize) + ')');
+
+				data.inputs.resize(inputCount);
+			}
+
+			for (auto& input : data.inputs)
+			{
+				serializer &= input.timeDelta;
+				serializer &= input.direction;
+				serializer &= input.rotation;
+			}
 		}
 
 		void Serialize(PacketSerializer& serializer, PlayerShoot& data)
 		{
+			serializer &= data.renderDelay;
 		}
 
 		void Serialize(PacketSerializer& serializer, PlaySound& data)
@@ -216,6 +269,12 @@ namespace ewn
 			serializer &= data.position;
 		}
 
+		void Serialize(PacketSerializer& serializer, QueryNetworkStrings& data)
+		{
+			serializer &= data.knownHash;
+			serializer &= data.knownCount;
+		}
+
 		void Serialize(PacketSerializer& serializer, QuerySpaceshipInfo& data)
 		{
 			serializer &= data.spaceshipName;
@@ -291,5 +350,37 @@ namespace ewn
 		void Serialize(PacketSerializer& serializer, UpdateSpaceshipSuccess& data)
 		{
 		}
+
+		bool Validate(PlayerMovement& data)
+		{
+			if (data.inputs.size() > PlayerInputBatchMaxSize)
+				return false;
+
+			auto IsFinite = [](const Nz::Vector3f& vec)
+			{
+				return std::isfinite(vec.x) && std::isfinite(vec.y) && std::isfinite(vec.z);
+			};
+
+			for (auto& input : data.inputs)
+			{
+				if (!IsFinite(input.direction) || !IsFinite(input.rotation))
+					return false;
+
+				// Prevents a single input from pushing the player input time far in the future (which would discard every following input)
+				if (input.timeDelta > PlayerInputMaxTimeDelta)
+					input.timeDelta = PlayerInputMaxTimeDelta;
+
+				// TODO: Set speed limit accordingly to spaceship data
+				input.direction.x = Nz::Clamp(input.direction.x, -1.f, 1.f);
+				input.direction.y = Nz::Clamp(input.direction.y, -1.f, 1.f);
+				input.direction.z = Nz::Clamp(input.direction.z, -1.f, 1.f);
+
+				input.rotation.x = Nz::Clamp(input.rotation.x, -1.f, 1.f);
+				input.rotation.y = Nz::Clamp(input.rotation.y, -1.f, 1.f);
+				input.rotation.z = Nz::Clamp(input.rotation.z, -1.f, 1.f);
+			}
+
+			return true;
+		}
 	}
 }